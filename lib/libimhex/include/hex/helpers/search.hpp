@@ -1,9 +1,24 @@
 #pragma once
 
+#include <hex.hpp>
+
+#include <hex/api/task_manager.hpp>
+#include <hex/helpers/binary_pattern.hpp>
 #include <hex/helpers/literals.hpp>
+#include <hex/helpers/types.hpp>
+
+#include <array>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
 
 namespace hex {
 
+namespace prv {
+  class Provider;
+}
+
 auto searchInterruptable(const auto &haystackBegin, const auto &haystackEnd, const auto &needleBegin, const auto &needleEnd, auto predicate, Task &task) {
   if (needleBegin == needleEnd)
     return haystackBegin;
@@ -39,4 +54,99 @@ auto searchInterruptable(const auto &haystackBegin, const auto &haystackEnd, con
   }, task);
 }
 
-}
\ No newline at end of file
+/**
+ * @brief Searches for a fixed sequence of bytes
+ *
+ * Candidate positions are found by comparing the first and last byte of the sequence against
+ * many positions at once using SIMD instructions, only the candidates are then compared in full.
+ * Targets without SIMD support fall back to a Boyer-Moore-Horspool search.
+ */
+class ByteSequenceSearcher {
+public:
+  explicit ByteSequenceSearcher(std::vector<u8> sequence, bool ignoreCase = false);
+
+  /**
+   * @brief Finds the first occurrence of the sequence in a buffer
+   * @return Offset of the occurrence in the buffer or std::nullopt if there is none
+   */
+  [[nodiscard]] std::optional<size_t> findFirst(std::span<const u8> haystack) const;
+
+  /**
+   * @brief Finds the last occurrence of the sequence in a buffer
+   * @return Offset of the occurrence in the buffer or std::nullopt if there is none
+   */
+  [[nodiscard]] std::optional<size_t> findLast(std::span<const u8> haystack) const;
+
+  /**
+   * @brief Finds the first occurrence of the sequence in a provider that starts at or after startAddress
+   * @param searchRegion Entire region being searched. Occurrences never extend past its end and progress is reported relative to its start
+   * @return Address of the occurrence or std::nullopt if there is none
+   */
+  [[nodiscard]] std::optional<u64> findNext(Task &task, prv::Provider *provider, Region searchRegion, u64 startAddress) const;
+
+  /**
+   * @brief Finds the last occurrence of the sequence in a provider that ends at or before endAddress
+   * @param searchRegion Entire region being searched. Occurrences never start before its start and progress is reported relative to its end
+   * @return Address of the occurrence or std::nullopt if there is none
+   */
+  [[nodiscard]] std::optional<u64> findPrevious(Task &task, prv::Provider *provider, Region searchRegion, u64 endAddress) const;
+
+  /**
+   * @brief Finds all occurrences of the sequence in a region of a provider, including overlapping ones
+   * @param callback Function called with the address of every occurrence, in ascending order
+   */
+  void findAll(Task &task, prv::Provider *provider, Region searchRegion, const std::function<void(u64)> &callback) const;
+
+  [[nodiscard]] size_t getSize() const { return m_sequence.size(); }
+
+private:
+  [[nodiscard]] bool matchesAt(const u8 *data) const;
+
+private:
+  std::vector<u8> m_sequence;
+
+  // Bits that get set on a haystack byte before it's compared against the sequence. 0x20 for ASCII letters when ignoring case, zero otherwise
+  std::vector<u8> m_caseMask;
+  bool m_ignoreCase;
+
+  // Number of bytes the search can skip ahead or back if a byte doesn't match. Only used when no SIMD filter is available
+  std::array<size_t, 256> m_forwardShift = { };
+  std::array<size_t, 256> m_backwardShift = { };
+};
+
+/**
+ * @brief Searches for a binary pattern whose bytes may contain wildcard bits
+ *
+ * The two pattern bytes that are least likely to show up in typical data are used as anchors for
+ * the same SIMD prefilter the byte sequence search uses. Candidates are then verified eight bytes
+ * at a time by comparing the masked data against the pattern values.
+ */
+class BinaryPatternSearcher {
+public:
+  explicit BinaryPatternSearcher(const BinaryPattern &pattern);
+
+  /**
+   * @brief Finds the first occurrence of the pattern in a buffer
+   * @return Offset of the occurrence in the buffer or std::nullopt if there is none
+   */
+  [[nodiscard]] std::optional<size_t> findFirst(std::span<const u8> haystack) const;
+
+  /**
+   * @brief Finds all occurrences of the pattern in a region of a provider, including overlapping ones
+   * @param callback Function called with the address of every occurrence, in ascending order
+   */
+  void findAll(Task &task, prv::Provider *provider, Region searchRegion, const std::function<void(u64)> &callback) const;
+
+  [[nodiscard]] size_t getSize() const { return m_masks.size(); }
+
+private:
+  [[nodiscard]] bool matchesAt(const u8 *data) const;
+
+private:
+  std::vector<u8> m_masks, m_values;
+
+  // Offsets of the bytes that candidate positions get prefiltered by
+  size_t m_firstAnchor = 0, m_secondAnchor = 0;
+};
+
+}
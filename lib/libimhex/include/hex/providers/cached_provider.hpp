@@ -2,7 +2,8 @@
 
 #include <hex/providers/provider.hpp>
 
-#include <unordered_map>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <mutex>
 #include <shared_mutex>
@@ -15,21 +16,75 @@ namespace hex::prv {
      * @brief A base class for providers that want to cache data in memory.
      *        Thread-safe for concurrent reads/writes. Reads are cached in memory.
      *        Subclasses must implement readFromSource and writeToSource.
+     *
+     *        The cache is set-associative: every block can be stored in any of the ways of
+     *        the set it maps to, and the least recently used block of that set is evicted first.
+     *
+     *        Writes are forwarded to the source right away by default. Providers whose source is slow
+     *        to write to can switch to write-back mode where modified blocks are kept in the cache and
+     *        written out in as few large writes as possible when the provider is saved or closed,
+     *        when flushCache() is called or when a modified block gets evicted.
+     *        Only the bytes that were actually modified are written back.
+     *        Subclasses using write-back mode need to call CachedProvider::close() before tearing down their source,
+     *        modifications still pending when the provider is destroyed are lost.
      */
     class CachedProvider : public Provider {
     public:
-        CachedProvider(size_t cacheBlockSize = 4096, size_t maxBlocks = 1024);
+        struct CacheStatistics {
+            u64 hits = 0;
+            u64 misses = 0;
+            u64 evictions = 0;
+            u64 bytesFetched = 0;
+        };
+
+        enum class WritePolicy {
+            WriteThrough,
+            WriteBack
+        };
+
+        explicit CachedProvider(size_t cacheBlockSize = 4 * 1024, size_t cacheBudget = 4 * 1024 * 1024, size_t associativity = 8);
         ~CachedProvider() override;
 
         OpenResult open() override;
         void close() override;
 
         void readRaw(u64 offset, void *buffer, size_t size) override;
+        void readRawBatch(std::span<const ReadRequest> requests) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
         void resizeRaw(u64 newSize) override;
 
+        void save() override;
+
         u64 getActualSize() const override;
 
+        [[nodiscard]] WritePolicy getWritePolicy() const;
+
+        /**
+         * @brief Sets how writes are forwarded to the source
+         * @note Switching to write-through mode flushes all pending writes
+         */
+        void setWritePolicy(WritePolicy writePolicy);
+
+        /**
+         * @brief Writes all modified blocks back to the source, merging adjacent modifications into single writes
+         */
+        void flushCache();
+
+        /**
+         * @brief Gets the hit, miss, eviction and fetch counters of the cache since it was last reset
+         */
+        [[nodiscard]] CacheStatistics getCacheStatistics() const;
+        void resetCacheStatistics();
+
+        [[nodiscard]] size_t getCacheBlockSize() const;
+        [[nodiscard]] size_t getCacheBudget() const;
+
+        /**
+         * @brief Sets the maximum number of bytes the cache is allowed to hold
+         * @note This drops all currently cached blocks
+         */
+        void setCacheBudget(size_t cacheBudget);
+
     protected:
         virtual void readFromSource(uint64_t offset, void* buffer, size_t size) = 0;
         virtual void writeToSource(uint64_t offset, const void* buffer, size_t size) = 0;
@@ -39,23 +94,53 @@ namespace hex::prv {
         void clearCache();
         void setCacheBlockSize(size_t cacheBlockSize);
 
+        /**
+         * @brief Called after all cached blocks have been dropped.
+         * Subclasses keeping their own copies of the source's data need to drop them here as well
+         */
+        virtual void onCacheCleared() { }
+
         struct Block {
-            uint64_t index;
+            uint64_t index = 0;
             std::vector<uint8_t> data;
+            u64 lastAccess = 0;
+            bool valid = false;
             bool dirty = false;
+
+            // Bytes modified since the block was last written back. Only allocated while the block is dirty,
+            // so bytes in between two modifications never get written back with whatever was read before
+            std::vector<bool> dirtyBytes;
+        };
+
+        struct CacheSet {
+            std::mutex mutex;
+            std::vector<Block> ways;
+            u64 accessCounter = 0;
         };
 
         size_t m_cacheBlockSize;
-        size_t m_maxBlocks;
+        size_t m_cacheBudget;
+        size_t m_associativity;
+        std::atomic<WritePolicy> m_writePolicy = WritePolicy::WriteThrough;
         mutable std::shared_mutex m_cacheMutex;
-        std::vector<std::optional<Block>> m_cache;
-        mutable std::vector<std::shared_mutex> m_cacheSlotMutexes;
+        std::vector<std::unique_ptr<CacheSet>> m_cacheSets;
         mutable u64 m_cachedSize = 0;
 
         constexpr u64 calcBlockIndex(u64 offset) const { return offset / m_cacheBlockSize; }
         constexpr size_t calcBlockOffset(u64 offset) const { return offset % m_cacheBlockSize; }
 
-        void evictIfNeeded();
+    private:
+        void readCached(u64 offset, void *buffer, size_t size);
+        void rebuildCache();
+
+        CacheSet& getCacheSet(u64 blockIndex) const;
+        Block& getBlock(CacheSet &set, u64 blockIndex);
+        void writeBackBlock(Block &block);
+
+        std::atomic<u64> m_cacheHits = 0;
+        std::atomic<u64> m_cacheMisses = 0;
+        std::atomic<u64> m_cacheEvictions = 0;
+        std::atomic<u64> m_bytesFetched = 0;
     };
 
 }
@@ -43,8 +43,16 @@ namespace hex::prv {
         [[nodiscard]] UnlocalizedString getTypeName() const override { return "ConcatenatedProvider"; }
         [[nodiscard]] const char *getIcon() const override { return ""; }
 
+    private:
+        /**
+         * @brief Finds the index of the segment that contains the given offset
+         */
+        [[nodiscard]] size_t findSegment(u64 offset) const;
+
     private:
         std::vector<Segment> m_segments;
+        // Offset of the first byte of every segment within the concatenated data
+        std::vector<u64> m_segmentOffsets;
         u64 m_size = 0;
     };
 
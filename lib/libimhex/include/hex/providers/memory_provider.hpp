@@ -31,6 +31,7 @@ namespace hex::prv {
         void close() override { }
 
         void readRaw(u64 offset, void *buffer, size_t size) override;
+        [[nodiscard]] std::optional<ContiguousView> tryGetContiguousViewRaw(u64 offset, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
         [[nodiscard]] u64 getActualSize() const override { return m_data.size(); }
 
@@ -48,6 +49,7 @@ namespace hex::prv {
 
     private:
         std::vector<u8> m_data;
+        ViewedBuffer m_viewedData;
         std::string m_name;
     };
 
@@ -2,6 +2,7 @@
 
 #include <hex.hpp>
 
+#include <functional>
 #include <vector>
 
 namespace hex::prv {
@@ -10,15 +11,29 @@ namespace hex::prv {
     public:
         Overlay() = default;
 
-        void setAddress(u64 address) { m_address = address; }
+        /**
+         * @param onChange callback that gets invoked every time the address or the data of the overlay changes
+         */
+        explicit Overlay(std::function<void()> onChange) : m_onChange(std::move(onChange)) { }
+
+        void setAddress(u64 address) { m_address = address; this->notifyChange(); }
         [[nodiscard]] u64 getAddress() const { return m_address; }
 
         [[nodiscard]] u64 getSize() const { return m_data.size(); }
-        [[nodiscard]] std::vector<u8> &getData() { return m_data; }
+
+        void setData(std::vector<u8> data) { m_data = std::move(data); this->notifyChange(); }
+        [[nodiscard]] const std::vector<u8> &getData() const { return m_data; }
+
+    private:
+        void notifyChange() const {
+            if (m_onChange)
+                m_onChange();
+        }
 
     private:
         u64 m_address = 0;
         std::vector<u8> m_data;
+        std::function<void()> m_onChange;
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace hex::prv {
+
+    /**
+     * @brief Edit layer that describes modified data as a list of pieces referencing the original data
+     *
+     * Inserting and removing data only splits, adds or drops pieces instead of moving any of the data
+     * following the modified location around. Data that's written or inserted is kept in an in-memory
+     * buffer, everything else is read from the original data when it's needed.
+     *
+     * Pieces are stored in a balanced tree ordered by their position in the data, where every node knows
+     * the size of the data its subtree covers. Finding, inserting and removing pieces therefore takes
+     * logarithmic time, no matter how many pieces there are or where in the data the edit happens.
+     */
+    class PieceTable {
+    public:
+        enum class Source : u8 {
+            Original,
+            Added,
+            Zero
+        };
+
+        struct Piece {
+            u64 address;
+            u64 size;
+            Source source;
+            u64 sourceOffset;
+        };
+
+        using ReadOriginalFunction = std::function<void(u64 offset, void *buffer, size_t size)>;
+
+        PieceTable() = default;
+        explicit PieceTable(u64 originalSize) { this->reset(originalSize); }
+
+        /**
+         * @brief Drops all modifications and starts over with a single piece covering the original data
+         */
+        void reset(u64 originalSize);
+
+        /**
+         * @brief Checks if the layout differs from the original data in any way
+         */
+        [[nodiscard]] bool isModified() const;
+
+        [[nodiscard]] u64 getSize() const;
+
+        /**
+         * @brief Lists all pieces in the order they appear in the data
+         */
+        [[nodiscard]] std::vector<Piece> getPieces() const;
+        [[nodiscard]] const std::vector<u8> &getAddedData() const { return m_addedData; }
+
+        void read(u64 offset, void *buffer, size_t size, const ReadOriginalFunction &readOriginal) const;
+        void write(u64 offset, const void *buffer, size_t size);
+
+        /**
+         * @brief Inserts zero bytes at the given offset
+         */
+        void insert(u64 offset, u64 size);
+        void remove(u64 offset, u64 size);
+        void resize(u64 newSize);
+
+    private:
+        constexpr static u32 NoNode = std::numeric_limits<u32>::max();
+
+        /**
+         * @brief Tree node holding a single piece. Nodes are ordered by position in the data and
+         * kept balanced by making sure every node has a higher random priority than its children
+         */
+        struct Node {
+            u64 size;
+            Source source;
+            u64 sourceOffset;
+
+            u64 subtreeSize;
+            u32 priority;
+            u32 left, right;
+        };
+
+        [[nodiscard]] u32 createNode(u64 size, Source source, u64 sourceOffset);
+        void freeTree(u32 node);
+        [[nodiscard]] u64 getSubtreeSize(u32 node) const;
+        void updateSubtreeSize(u32 node);
+
+        /**
+         * @brief Splits a tree into one containing the data before the offset and one containing the rest.
+         * A piece the offset falls into gets split in two
+         */
+        [[nodiscard]] std::pair<u32, u32> split(u32 node, u64 offset);
+
+        /**
+         * @brief Joins two trees so the data of the second one follows the data of the first one
+         */
+        [[nodiscard]] u32 merge(u32 first, u32 second);
+
+        /**
+         * @brief Same as merge() but also combines the two pieces where the trees meet if they continue each other,
+         * so the number of pieces doesn't keep growing when edits get reverted
+         */
+        [[nodiscard]] u32 join(u32 first, u32 second);
+
+        template<typename Callback>
+        void visit(u32 node, u64 address, u64 from, u64 to, Callback &&callback) const;
+
+    private:
+        std::vector<Node> m_nodes;
+        std::vector<u32> m_freeNodes;
+        u32 m_root = NoNode;
+        u32 m_randomState = 0x9E37'79B9;
+
+        std::vector<u8> m_addedData;
+        u64 m_originalSize = 0;
+    };
+
+}
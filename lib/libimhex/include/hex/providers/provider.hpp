@@ -2,9 +2,13 @@
 
 #include <hex.hpp>
 
+#include <atomic>
 #include <list>
+#include <memory>
 #include <optional>
 #include <set>
+#include <shared_mutex>
+#include <span>
 #include <string>
 #include <variant>
 #include <vector>
@@ -123,6 +127,56 @@ namespace hex::prv {
     public:
         constexpr static u64 MaxPageSize = 0xFFFF'FFFF'FFFF'FFFF;
 
+        /**
+         * @brief A single range that should be read as part of a batched read
+         */
+        struct ReadRequest {
+            u64 offset;
+            void *buffer;
+            size_t size;
+        };
+
+        /**
+         * @brief Read-only view into data a provider already holds in memory
+         * @note The view optionally keeps a reference to whatever owns the memory, e.g. a file mapping,
+         * so that memory stays valid for as long as the view exists
+         */
+        class ContiguousView {
+        public:
+            explicit ContiguousView(std::span<const u8> data, std::shared_ptr<const void> owner = nullptr)
+                : m_data(data), m_owner(std::move(owner)) { }
+
+            [[nodiscard]] std::span<const u8> getData() const { return m_data; }
+            [[nodiscard]] const u8* data() const { return m_data.data(); }
+            [[nodiscard]] size_t size() const { return m_data.size(); }
+
+        private:
+            std::span<const u8> m_data;
+            std::shared_ptr<const void> m_owner;
+        };
+
+        /**
+         * @brief Hands out contiguous views into a buffer held in memory that may get reallocated while the views are still in use
+         * @note Call detach() before anything that reallocates the buffer. If views of it still exist,
+         * they take over its current storage and the buffer continues with a copy of it
+         */
+        class ViewedBuffer {
+        public:
+            [[nodiscard]] ContiguousView createView(const std::vector<u8> &buffer, u64 offset, size_t size) const {
+                return ContiguousView({ buffer.data() + offset, size }, m_storage);
+            }
+
+            /**
+             * @param buffer Buffer the views were created from
+             * @param keepContents Whether the buffer needs to keep its contents, otherwise it's left empty
+             */
+            void detach(std::vector<u8> &buffer, bool keepContents = true);
+
+        private:
+            // Storage views share ownership of. It's empty until views need to take over a buffer's storage
+            std::shared_ptr<std::vector<u8>> m_storage = std::make_shared<std::vector<u8>>();
+        };
+
         class OpenResult {
         public:
             OpenResult() : m_result(std::monostate{}) {}
@@ -261,6 +315,13 @@ namespace hex::prv {
          * @param overlays apply overlays and patches is true. Same as readRaw() if false
          */
         virtual void read(u64 offset, void *buffer, size_t size, bool overlays = true);
+
+        /**
+         * @brief Read multiple independent ranges from this provider at once, applying overlays and patches
+         * @param requests ranges to read. Offsets are addresses, the same as the ones passed to read()
+         * @param overlays apply overlays and patches is true. Same as readRawBatch() if false
+         */
+        virtual void readBatch(std::span<const ReadRequest> requests, bool overlays = true);
         
         /**
          * @brief Write data to the patches of this provider. Will not directly modify provider.
@@ -277,6 +338,34 @@ namespace hex::prv {
          * @param size number of bytes to read
          */
         virtual void readRaw(u64 offset, void *buffer, size_t size) = 0;
+
+        /**
+         * @brief Read multiple independent ranges from this provider at once, without applying overlays and patches
+         * @note The default implementation calls readRaw() for every request. Providers that can fetch
+         * multiple ranges cheaper than that, e.g. with a single syscall or round trip, should override this
+         * @param requests ranges to read. Offsets are relative to the start of the data, the same as the ones passed to readRaw()
+         */
+        virtual void readRawBatch(std::span<const ReadRequest> requests);
+
+        /**
+         * @brief Tries to access the data of a region directly, without copying it into a separate buffer
+         * @note This only succeeds if the provider keeps the data of the whole region in memory and no overlays
+         * cover any part of it. Otherwise, the data needs to be read using read() instead.
+         * Views of memory owned by the provider itself only stay valid until the provider is resized or closed,
+         * so consumers should request views of bounded chunks instead of the entire data at once
+         * @param region region to access. The address is the same as the one passed to read()
+         * @return View of the data or std::nullopt if the data isn't directly accessible
+         */
+        [[nodiscard]] virtual std::optional<ContiguousView> tryGetContiguousView(const Region &region);
+
+        /**
+         * @brief Tries to access data directly without copying it, ignoring overlays
+         * @note The default implementation always returns std::nullopt
+         * @param offset offset to start the view at. Relative to the start of the data, the same as the one passed to readRaw()
+         * @param size number of bytes to access
+         * @return View of the data or std::nullopt if the data isn't directly accessible
+         */
+        [[nodiscard]] virtual std::optional<ContiguousView> tryGetContiguousViewRaw(u64 offset, size_t size);
         /**
          * @brief Write data directly to this provider
          * @param offset offset to start writing the data
@@ -405,6 +494,27 @@ namespace hex::prv {
         bool m_skipLoadInterface = false;
 
         u64 m_pageSize = MaxPageSize;
+
+    private:
+        /**
+         * @brief Part of the address space that's covered by an overlay
+         * @note Segments never overlap each other. Where overlays overlap, the segment belongs to
+         * the overlay that was created last, since that's the one whose data ends up in the read buffer
+         */
+        struct OverlaySegment {
+            u64 start, end;
+            const Overlay *overlay;
+        };
+
+        void rebuildOverlayIndex();
+        [[nodiscard]] std::vector<OverlaySegment>::const_iterator findOverlaySegment(u64 address) const;
+
+        /**
+         * @brief Overlay segments sorted by address, so reads only need to look at overlays that intersect them
+         */
+        std::vector<OverlaySegment> m_overlayIndex;
+        mutable std::shared_mutex m_overlayIndexMutex;
+        std::atomic<bool> m_hasOverlays = false;
     };
 
 }
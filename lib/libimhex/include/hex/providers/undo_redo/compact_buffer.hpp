@@ -0,0 +1,67 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace hex::prv::undo {
+
+    /**
+     * @brief Temporary file that data of old undo operations gets moved to once the undo history grows too large
+     * @note The file is deleted again as soon as the last buffer referencing it is gone
+     */
+    class SpillFile;
+
+    /**
+     * @brief Creates a new spill file in the system's temporary directory
+     * @return The spill file or nullptr if no file could be created
+     */
+    [[nodiscard]] std::shared_ptr<SpillFile> createSpillFile();
+
+    /**
+     * @brief Byte buffer used to store the data of undo operations as compactly as possible
+     *
+     * Data consisting of long runs of the same byte value, e.g. a fill or the difference between
+     * the old and new data of a write, is run-length encoded. The buffer can also be moved to a spill file
+     * on disk entirely and will transparently be read back from there when it's needed again
+     */
+    class CompactBuffer {
+    public:
+        CompactBuffer() = default;
+        explicit CompactBuffer(std::span<const u8> data);
+
+        [[nodiscard]] std::vector<u8> get() const;
+
+        [[nodiscard]] size_t size() const { return m_size; }
+        [[nodiscard]] bool empty() const { return m_size == 0; }
+
+        /**
+         * @brief Number of bytes the buffer currently occupies in memory
+         */
+        [[nodiscard]] size_t getMemoryUsage() const { return m_data.capacity(); }
+        [[nodiscard]] bool isOffloaded() const { return m_spillFile != nullptr; }
+
+        /**
+         * @brief Moves the data of this buffer to a spill file
+         * @note If writing to the file fails, the data stays in memory
+         */
+        void offload(const std::shared_ptr<SpillFile> &spillFile);
+
+    private:
+        enum class Encoding : u8 {
+            Raw,
+            RunLength
+        };
+
+        Encoding m_encoding = Encoding::Raw;
+        size_t m_size = 0;
+        std::vector<u8> m_data;
+
+        std::shared_ptr<SpillFile> m_spillFile;
+        u64 m_spillOffset = 0;
+        size_t m_spillSize = 0;
+    };
+
+}
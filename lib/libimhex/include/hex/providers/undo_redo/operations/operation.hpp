@@ -1,6 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <hex/helpers/concepts.hpp>
@@ -11,6 +13,8 @@ namespace hex::prv {
 
 namespace hex::prv::undo {
 
+    class SpillFile;
+
     class Operation : public ICloneable<Operation> {
     public:
         ~Operation() override = default;
@@ -26,6 +30,25 @@ namespace hex::prv::undo {
         }
 
         [[nodiscard]] virtual bool shouldHighlight() const { return true; }
+
+        /**
+         * @brief Tries to fold an operation that's about to be added after this one into this operation
+         * @note This is used to combine many small consecutive edits into a single entry.
+         * The other operation has not been applied yet when this function is called
+         * @param other operation that follows this one
+         * @return true if the other operation has been merged into this one and doesn't need to be stored separately
+         */
+        [[nodiscard]] virtual bool merge(const Operation &other) { std::ignore = other; return false; }
+
+        /**
+         * @brief Gets the number of bytes of data this operation keeps in memory
+         */
+        [[nodiscard]] virtual size_t getMemoryUsage() const { return 0; }
+
+        /**
+         * @brief Moves the data this operation keeps in memory to a spill file
+         */
+        virtual void offload(const std::shared_ptr<SpillFile> &spillFile) { std::ignore = spillFile; }
     };
 
 }
\ No newline at end of file
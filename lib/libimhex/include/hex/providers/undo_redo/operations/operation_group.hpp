@@ -58,6 +58,19 @@ namespace hex::prv::undo {
             return m_formattedContent;
         }
 
+        [[nodiscard]] size_t getMemoryUsage() const override {
+            size_t result = 0;
+            for (const auto &operation : m_operations)
+                result += operation->getMemoryUsage();
+
+            return result;
+        }
+
+        void offload(const std::shared_ptr<SpillFile> &spillFile) override {
+            for (auto &operation : m_operations)
+                operation->offload(spillFile);
+        }
+
     private:
         UnlocalizedString m_unlocalizedName;
         std::vector<std::unique_ptr<Operation>> m_operations;
@@ -4,6 +4,7 @@
 #include <hex/api/localization_manager.hpp>
 
 #include <hex/providers/undo_redo/operations/operation.hpp>
+#include <hex/providers/undo_redo/compact_buffer.hpp>
 
 #include <map>
 #include <memory>
@@ -41,7 +42,28 @@ namespace hex::prv::undo {
 
         bool add(std::unique_ptr<Operation> &&operation);
 
-        static std::recursive_mutex& getMutex();
+        /**
+         * @brief Prevents operations added from now on from being merged into the ones currently on the stack
+         * @note Used when the data gets saved, so changes made afterwards show up as separate operations
+         */
+        void sealOperations();
+
+        /**
+         * @brief Gets the mutex guarding this stack
+         * @note Every stack has its own mutex so long running operations on one provider don't block any other ones
+         */
+        [[nodiscard]] std::recursive_mutex& getMutex() const;
+
+        /**
+         * @brief Sets how much memory the data of all operations of a single stack may use before
+         * the data of the oldest operations gets moved to a temporary file
+         */
+        static void setMemoryLimit(size_t limit);
+        [[nodiscard]] static size_t getMemoryLimit();
+
+        [[nodiscard]] size_t getMemoryUsage() const {
+            return m_memoryUsage;
+        }
 
         const std::vector<std::unique_ptr<Operation>> &getAppliedOperations() const {
             return m_undoStack;
@@ -52,8 +74,15 @@ namespace hex::prv::undo {
         }
 
         void reset() {
+            std::lock_guard lock(m_mutex);
+
             m_undoStack.clear();
             m_redoStack.clear();
+            m_mergeCounts.clear();
+            m_mergeBarrier = 0;
+            m_offloadedCount = 0;
+            m_memoryUsage = 0;
+            m_spillFile.reset();
         }
 
     private:
@@ -61,9 +90,24 @@ namespace hex::prv::undo {
             return m_undoStack.back().get();
         }
 
+        void clearRedoStack();
+        void enforceMemoryLimit();
+
     private:
         std::vector<std::unique_ptr<Operation>> m_undoStack, m_redoStack;
         Provider *m_provider;
+        mutable std::recursive_mutex m_mutex;
+
+        // Number of added operations each entry of the undo stack represents after merging
+        std::vector<u32> m_mergeCounts;
+        // Operations below this index have been sealed and can't be merged into anymore
+        size_t m_mergeBarrier = 0;
+
+        // Number of operations at the bottom of the undo stack whose data has been moved to the spill file
+        size_t m_offloadedCount = 0;
+        size_t m_memoryUsage = 0;
+        std::shared_ptr<SpillFile> m_spillFile;
+        bool m_spillFileFailed = false;
     };
 
 }
\ No newline at end of file
@@ -150,7 +150,7 @@ namespace hex::dp {
             throwNodeError("Tried setting overlay data on a node that's not the end of a chain!");
 
         m_overlay->setAddress(address);
-        m_overlay->getData() = data;
+        m_overlay->setData(data);
     }
 
     [[noreturn]] void Node::throwNodeError(const std::string &msg) {
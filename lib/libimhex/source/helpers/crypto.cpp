@@ -32,17 +32,31 @@
 #include <cstdint>
 #include <bit>
 #include <span>
+#include <vector>
 
 namespace hex::crypt {
     using namespace std::placeholders;
 
-    template<std::invocable<unsigned char *, size_t> Func>
+    template<std::invocable<const unsigned char *, size_t> Func>
     void processDataByChunks(prv::Provider *data, u64 offset, size_t size, Func func) {
-        std::array<u8, 512> buffer = { 0 };
-        for (size_t bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const auto readSize = std::min(buffer.size(), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            func(buffer.data(), readSize);
+        // Data that's already in memory is hashed in place, everything else gets copied through a buffer
+        constexpr static size_t ViewChunkSize = 16 * 1024 * 1024;
+
+        std::vector<u8> buffer;
+        for (size_t chunkOffset = 0; chunkOffset < size; chunkOffset += ViewChunkSize) {
+            const auto chunkSize = std::min(ViewChunkSize, size - chunkOffset);
+
+            if (auto view = data->tryGetContiguousView(Region { .address=offset + chunkOffset, .size=chunkSize }); view.has_value()) {
+                func(view->data(), view->size());
+                continue;
+            }
+
+            buffer.resize(std::min<size_t>(size, 64 * 1024));
+            for (size_t bufferOffset = 0; bufferOffset < chunkSize; bufferOffset += buffer.size()) {
+                const auto readSize = std::min(buffer.size(), chunkSize - bufferOffset);
+                data->read(offset + chunkOffset + bufferOffset, buffer.data(), readSize);
+                func(buffer.data(), readSize);
+            }
         }
     }
 
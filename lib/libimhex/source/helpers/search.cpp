@@ -0,0 +1,427 @@
+#include <hex/helpers/search.hpp>
+
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <numeric>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <immintrin.h>
+    #define SEARCH_VECTOR_X86
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define SEARCH_VECTOR_NEON
+#endif
+
+namespace hex {
+
+    using namespace hex::literals;
+
+    namespace {
+
+        // Amount of data read from the provider at once
+        constexpr static size_t ChunkSize = 4_MiB;
+
+        constexpr u8 toLowerAscii(u8 byte) {
+            return (byte >= 'A' && byte <= 'Z') ? byte | 0x20 : byte;
+        }
+
+        constexpr bool isAsciiLetter(u8 byte) {
+            return toLowerAscii(byte) >= 'a' && toLowerAscii(byte) <= 'z';
+        }
+
+        // Rough relative frequency of byte values in typical binary data. Zero and 0xFF padding dominate, followed by small numbers and text
+        constexpr u32 estimateByteFrequency(u8 byte) {
+            if (byte == 0x00)
+                return 64;
+            if (byte == 0xFF)
+                return 16;
+            if (byte < 0x10)
+                return 8;
+            if (byte >= 0x20 && byte < 0x7F)
+                return 4;
+
+            return 1;
+        }
+
+        /**
+         * @brief Compares two bytes of the haystack against two anchor bytes of the needle for many positions at once
+         *
+         * Haystack bytes are masked before being compared so wildcard bits and letter cases can be ignored.
+         * match() returns a mask with BitsPerLane bits set for every position where both bytes match
+         */
+        #if defined(SEARCH_VECTOR_X86) && defined(__AVX2__)
+
+            class VectorFilter {
+            public:
+                constexpr static size_t LaneCount = 32;
+                constexpr static size_t BitsPerLane = 1;
+
+                VectorFilter(u8 firstValue, u8 firstMask, u8 lastValue, u8 lastMask)
+                    : m_firstValue(_mm256_set1_epi8(char(firstValue))), m_firstMask(_mm256_set1_epi8(char(firstMask))),
+                      m_lastValue(_mm256_set1_epi8(char(lastValue))), m_lastMask(_mm256_set1_epi8(char(lastMask))) { }
+
+                [[nodiscard]] u64 match(const u8 *first, const u8 *last) const {
+                    const auto firstBytes = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)), m_firstMask);
+                    const auto lastBytes  = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(last)), m_lastMask);
+
+                    const auto matches = _mm256_and_si256(_mm256_cmpeq_epi8(firstBytes, m_firstValue), _mm256_cmpeq_epi8(lastBytes, m_lastValue));
+                    return u32(_mm256_movemask_epi8(matches));
+                }
+
+            private:
+                __m256i m_firstValue, m_firstMask, m_lastValue, m_lastMask;
+            };
+
+        #elif defined(SEARCH_VECTOR_X86)
+
+            class VectorFilter {
+            public:
+                constexpr static size_t LaneCount = 16;
+                constexpr static size_t BitsPerLane = 1;
+
+                VectorFilter(u8 firstValue, u8 firstMask, u8 lastValue, u8 lastMask)
+                    : m_firstValue(_mm_set1_epi8(char(firstValue))), m_firstMask(_mm_set1_epi8(char(firstMask))),
+                      m_lastValue(_mm_set1_epi8(char(lastValue))), m_lastMask(_mm_set1_epi8(char(lastMask))) { }
+
+                [[nodiscard]] u64 match(const u8 *first, const u8 *last) const {
+                    const auto firstBytes = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), m_firstMask);
+                    const auto lastBytes  = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(last)), m_lastMask);
+
+                    const auto matches = _mm_and_si128(_mm_cmpeq_epi8(firstBytes, m_firstValue), _mm_cmpeq_epi8(lastBytes, m_lastValue));
+                    return u32(_mm_movemask_epi8(matches));
+                }
+
+            private:
+                __m128i m_firstValue, m_firstMask, m_lastValue, m_lastMask;
+            };
+
+        #elif defined(SEARCH_VECTOR_NEON)
+
+            class VectorFilter {
+            public:
+                constexpr static size_t LaneCount = 16;
+                constexpr static size_t BitsPerLane = 4;
+
+                VectorFilter(u8 firstValue, u8 firstMask, u8 lastValue, u8 lastMask)
+                    : m_firstValue(vdupq_n_u8(firstValue)), m_firstMask(vdupq_n_u8(firstMask)),
+                      m_lastValue(vdupq_n_u8(lastValue)), m_lastMask(vdupq_n_u8(lastMask)) { }
+
+                [[nodiscard]] u64 match(const u8 *first, const u8 *last) const {
+                    const auto firstBytes = vandq_u8(vld1q_u8(first), m_firstMask);
+                    const auto lastBytes  = vandq_u8(vld1q_u8(last), m_lastMask);
+
+                    const auto matches = vandq_u8(vceqq_u8(firstBytes, m_firstValue), vceqq_u8(lastBytes, m_lastValue));
+
+                    // NEON has no movemask instruction, narrowing every lane to four bits gives an equivalent 64 bit mask
+                    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+                }
+
+            private:
+                uint8x16_t m_firstValue, m_firstMask, m_lastValue, m_lastMask;
+            };
+
+        #endif
+
+        /**
+         * @brief Reads a region in overlapping chunks and reports every occurrence found in them exactly once
+         * @param findFirst Function returning the offset of the first occurrence in a buffer
+         */
+        void findAllInChunks(Task &task, prv::Provider *provider, Region searchRegion, size_t size, const auto &findFirst, const std::function<void(u64)> &callback) {
+            if (size == 0 || searchRegion.getSize() < size)
+                return;
+
+            const auto endAddress = searchRegion.getEndAddress();
+
+            std::vector<u8> buffer(ChunkSize + size - 1);
+            for (u64 address = searchRegion.getStartAddress(); endAddress - address + 1 >= size; address += ChunkSize) {
+                task.update(address - searchRegion.getStartAddress());
+
+                const auto readSize = std::min<u64>(buffer.size(), endAddress - address + 1);
+                const bool lastChunk = readSize == endAddress - address + 1;
+                provider->read(address, buffer.data(), readSize);
+
+                // Occurrences starting in the overlap at the end of the chunk are reported as part of the next chunk instead
+                for (size_t offset = 0; offset + size <= readSize;) {
+                    const std::optional<size_t> occurrence = findFirst(std::span<const u8>(buffer.data() + offset, size_t(readSize - offset)));
+                    if (!occurrence.has_value())
+                        break;
+
+                    offset += *occurrence;
+                    if (!lastChunk && offset >= ChunkSize)
+                        break;
+
+                    callback(address + offset);
+                    offset += 1;
+                }
+
+                if (lastChunk)
+                    break;
+            }
+        }
+
+    }
+
+    ByteSequenceSearcher::ByteSequenceSearcher(std::vector<u8> sequence, bool ignoreCase) : m_sequence(std::move(sequence)), m_caseMask(m_sequence.size()), m_ignoreCase(ignoreCase) {
+        if (m_ignoreCase) {
+            for (size_t i = 0; i < m_sequence.size(); i += 1) {
+                if (isAsciiLetter(m_sequence[i])) {
+                    m_sequence[i] = toLowerAscii(m_sequence[i]);
+                    m_caseMask[i] = 0x20;
+                }
+            }
+        }
+
+        const auto size = m_sequence.size();
+        m_forwardShift.fill(size);
+        m_backwardShift.fill(size);
+
+        if (size == 0)
+            return;
+
+        for (size_t i = 0; i + 1 < size; i += 1)
+            m_forwardShift[m_sequence[i]] = size - 1 - i;
+        for (size_t i = size - 1; i > 0; i -= 1)
+            m_backwardShift[m_sequence[i]] = i;
+    }
+
+    bool ByteSequenceSearcher::matchesAt(const u8 *data) const {
+        if (!m_ignoreCase)
+            return std::memcmp(data, m_sequence.data(), m_sequence.size()) == 0;
+
+        for (size_t i = 0; i < m_sequence.size(); i += 1) {
+            if ((data[i] | m_caseMask[i]) != m_sequence[i])
+                return false;
+        }
+
+        return true;
+    }
+
+    std::optional<size_t> ByteSequenceSearcher::findFirst(std::span<const u8> haystack) const {
+        const auto size = m_sequence.size();
+        if (size == 0)
+            return 0;
+        if (haystack.size() < size)
+            return std::nullopt;
+
+        const auto data = haystack.data();
+        const auto positionCount = haystack.size() - size + 1;
+        size_t position = 0;
+
+        #if defined(SEARCH_VECTOR_X86) || defined(SEARCH_VECTOR_NEON)
+            const VectorFilter filter(u8(m_sequence.front() & ~m_caseMask.front()), u8(~m_caseMask.front()), u8(m_sequence.back() & ~m_caseMask.back()), u8(~m_caseMask.back()));
+            constexpr static u64 LaneBits = (u64(1) << VectorFilter::BitsPerLane) - 1;
+
+            for (; position + VectorFilter::LaneCount <= positionCount; position += VectorFilter::LaneCount) {
+                auto mask = filter.match(data + position, data + position + size - 1);
+                while (mask != 0) {
+                    const auto lane = size_t(std::countr_zero(mask)) / VectorFilter::BitsPerLane;
+                    if (matchesAt(data + position + lane))
+                        return position + lane;
+
+                    mask &= ~(LaneBits << (lane * VectorFilter::BitsPerLane));
+                }
+            }
+        #endif
+
+        // Boyer-Moore-Horspool search over whatever the vector filter didn't cover
+        while (position < positionCount) {
+            if (matchesAt(data + position))
+                return position;
+
+            const u8 lastByte = data[position + size - 1];
+            position += m_forwardShift[m_ignoreCase ? toLowerAscii(lastByte) : lastByte];
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<size_t> ByteSequenceSearcher::findLast(std::span<const u8> haystack) const {
+        const auto size = m_sequence.size();
+        if (size == 0)
+            return haystack.size();
+        if (haystack.size() < size)
+            return std::nullopt;
+
+        const auto data = haystack.data();
+        auto positionCount = haystack.size() - size + 1;
+
+        #if defined(SEARCH_VECTOR_X86) || defined(SEARCH_VECTOR_NEON)
+            const VectorFilter filter(u8(m_sequence.front() & ~m_caseMask.front()), u8(~m_caseMask.front()), u8(m_sequence.back() & ~m_caseMask.back()), u8(~m_caseMask.back()));
+            constexpr static u64 LaneBits = (u64(1) << VectorFilter::BitsPerLane) - 1;
+
+            for (; positionCount >= VectorFilter::LaneCount; positionCount -= VectorFilter::LaneCount) {
+                const auto position = positionCount - VectorFilter::LaneCount;
+
+                auto mask = filter.match(data + position, data + position + size - 1);
+                while (mask != 0) {
+                    const auto lane = size_t(63 - std::countl_zero(mask)) / VectorFilter::BitsPerLane;
+                    if (matchesAt(data + position + lane))
+                        return position + lane;
+
+                    mask &= ~(LaneBits << (lane * VectorFilter::BitsPerLane));
+                }
+            }
+        #endif
+
+        // Positions are tracked one past the actual candidate so the search can stop at zero without underflowing
+        auto position = positionCount;
+        while (position > 0) {
+            if (matchesAt(data + position - 1))
+                return position - 1;
+
+            const u8 firstByte = data[position - 1];
+            const auto shift = m_backwardShift[m_ignoreCase ? toLowerAscii(firstByte) : firstByte];
+            position = shift >= position ? 0 : position - shift;
+        }
+
+        return std::nullopt;
+    }
+
+    std::optional<u64> ByteSequenceSearcher::findNext(Task &task, prv::Provider *provider, Region searchRegion, u64 startAddress) const {
+        const auto size = m_sequence.size();
+        if (size == 0 || searchRegion.getSize() < size)
+            return std::nullopt;
+
+        const auto endAddress = searchRegion.getEndAddress();
+
+        // Consecutive chunks overlap by one byte less than the sequence, so occurrences crossing a chunk boundary are found as well
+        std::vector<u8> buffer(ChunkSize + size - 1);
+        for (u64 address = std::max(startAddress, searchRegion.getStartAddress()); address <= endAddress && endAddress - address + 1 >= size; address += ChunkSize) {
+            task.update(address - searchRegion.getStartAddress());
+
+            const auto readSize = std::min<u64>(buffer.size(), endAddress - address + 1);
+            provider->read(address, buffer.data(), readSize);
+
+            if (const auto offset = findFirst({ buffer.data(), size_t(readSize) }); offset.has_value())
+                return address + *offset;
+
+            if (readSize < buffer.size())
+                break;
+        }
+
+        return std::nullopt;
+    }
+
+    void ByteSequenceSearcher::findAll(Task &task, prv::Provider *provider, Region searchRegion, const std::function<void(u64)> &callback) const {
+        findAllInChunks(task, provider, searchRegion, m_sequence.size(), [this](std::span<const u8> haystack) { return this->findFirst(haystack); }, callback);
+    }
+
+    std::optional<u64> ByteSequenceSearcher::findPrevious(Task &task, prv::Provider *provider, Region searchRegion, u64 endAddress) const {
+        const auto size = m_sequence.size();
+        if (size == 0 || searchRegion.getSize() < size)
+            return std::nullopt;
+
+        const auto startAddress = searchRegion.getStartAddress();
+        endAddress = std::min(endAddress, searchRegion.getEndAddress());
+
+        // Chunks are read from the end towards the start, overlapping the same way as when searching forwards
+        std::vector<u8> buffer(ChunkSize + size - 1);
+        for (u64 chunkEnd = endAddress; chunkEnd >= startAddress && chunkEnd - startAddress + 1 >= size; chunkEnd -= ChunkSize) {
+            task.update(searchRegion.getEndAddress() - chunkEnd);
+
+            const auto readSize = std::min<u64>(buffer.size(), chunkEnd - startAddress + 1);
+            const auto address = chunkEnd - readSize + 1;
+            provider->read(address, buffer.data(), readSize);
+
+            if (const auto offset = findLast({ buffer.data(), size_t(readSize) }); offset.has_value())
+                return address + *offset;
+
+            if (chunkEnd - startAddress < ChunkSize)
+                break;
+        }
+
+        return std::nullopt;
+    }
+
+
+    BinaryPatternSearcher::BinaryPatternSearcher(const BinaryPattern &pattern) {
+        for (const auto &[mask, value] : pattern.getPatterns()) {
+            m_masks.push_back(mask);
+            m_values.push_back(value & mask);
+        }
+
+        if (m_masks.empty())
+            return;
+
+        // Estimate how often every pattern byte matches by summing up the frequencies of all values it accepts
+        std::vector<u32> frequencies(m_masks.size());
+        for (size_t i = 0; i < m_masks.size(); i += 1) {
+            for (u32 byte = 0x00; byte <= 0xFF; byte += 1) {
+                if ((byte & m_masks[i]) == m_values[i])
+                    frequencies[i] += estimateByteFrequency(u8(byte));
+            }
+        }
+
+        std::vector<size_t> offsets(m_masks.size());
+        std::iota(offsets.begin(), offsets.end(), 0);
+        std::ranges::stable_sort(offsets, {}, [&](size_t offset) { return frequencies[offset]; });
+
+        m_firstAnchor  = offsets[0];
+        m_secondAnchor = offsets.size() > 1 ? offsets[1] : offsets[0];
+    }
+
+    bool BinaryPatternSearcher::matchesAt(const u8 *data) const {
+        const auto size = m_masks.size();
+
+        size_t i = 0;
+        for (; i + sizeof(u64) <= size; i += sizeof(u64)) {
+            u64 bytes, mask, value;
+            std::memcpy(&bytes, data + i, sizeof(u64));
+            std::memcpy(&mask, m_masks.data() + i, sizeof(u64));
+            std::memcpy(&value, m_values.data() + i, sizeof(u64));
+
+            if ((bytes & mask) != value)
+                return false;
+        }
+
+        for (; i < size; i += 1) {
+            if ((data[i] & m_masks[i]) != m_values[i])
+                return false;
+        }
+
+        return true;
+    }
+
+    std::optional<size_t> BinaryPatternSearcher::findFirst(std::span<const u8> haystack) const {
+        const auto size = m_masks.size();
+        if (size == 0)
+            return 0;
+        if (haystack.size() < size)
+            return std::nullopt;
+
+        const auto data = haystack.data();
+        const auto positionCount = haystack.size() - size + 1;
+        size_t position = 0;
+
+        #if defined(SEARCH_VECTOR_X86) || defined(SEARCH_VECTOR_NEON)
+            const VectorFilter filter(m_values[m_firstAnchor], m_masks[m_firstAnchor], m_values[m_secondAnchor], m_masks[m_secondAnchor]);
+            constexpr static u64 LaneBits = (u64(1) << VectorFilter::BitsPerLane) - 1;
+
+            for (; position + VectorFilter::LaneCount <= positionCount; position += VectorFilter::LaneCount) {
+                auto mask = filter.match(data + position + m_firstAnchor, data + position + m_secondAnchor);
+                while (mask != 0) {
+                    const auto lane = size_t(std::countr_zero(mask)) / VectorFilter::BitsPerLane;
+                    if (matchesAt(data + position + lane))
+                        return position + lane;
+
+                    mask &= ~(LaneBits << (lane * VectorFilter::BitsPerLane));
+                }
+            }
+        #endif
+
+        for (; position < positionCount; position += 1) {
+            if ((data[position + m_firstAnchor] & m_masks[m_firstAnchor]) == m_values[m_firstAnchor] && matchesAt(data + position))
+                return position;
+        }
+
+        return std::nullopt;
+    }
+
+    void BinaryPatternSearcher::findAll(Task &task, prv::Provider *provider, Region searchRegion, const std::function<void(u64)> &callback) const {
+        findAllInChunks(task, provider, searchRegion, m_masks.size(), [this](std::span<const u8> haystack) { return this->findFirst(haystack); }, callback);
+    }
+
+}
@@ -2,12 +2,58 @@
 #include <algorithm>
 #include <optional>
 
+#include <hex/helpers/literals.hpp>
+#include <hex/helpers/logger.hpp>
+#include <hex/helpers/utils.hpp>
+
 namespace hex::prv {
 
-    CachedProvider::CachedProvider(size_t cacheBlockSize, size_t maxBlocks)
-        : m_cacheBlockSize(cacheBlockSize), m_maxBlocks(maxBlocks), m_cache(maxBlocks), m_cacheSlotMutexes(maxBlocks) {}
+    using namespace hex::literals;
+
+    namespace {
+
+        // Upper limit for the size of a single merged write when flushing modified blocks
+        constexpr static size_t MaxFlushWriteSize = 16_MiB;
+
+        /**
+         * @brief Calls the callback with the start and end of every run of set bits in a mask
+         */
+        void forEachRun(const std::vector<bool> &mask, const auto &callback) {
+            for (size_t begin = 0; begin < mask.size();) {
+                if (!mask[begin]) {
+                    begin += 1;
+                    continue;
+                }
+
+                auto end = begin + 1;
+                while (end < mask.size() && mask[end])
+                    end += 1;
+
+                callback(begin, end);
+                begin = end;
+            }
+        }
+
+    }
+
+    CachedProvider::CachedProvider(size_t cacheBlockSize, size_t cacheBudget, size_t associativity)
+        : m_cacheBlockSize(cacheBlockSize), m_cacheBudget(cacheBudget), m_associativity(std::max<size_t>(associativity, 1)) {
+        rebuildCache();
+    }
 
     CachedProvider::~CachedProvider() {
+        // The source belongs to the subclass which has been destroyed already, there's nothing left to write to
+        u64 discardedSize = 0;
+        for (const auto &set : m_cacheSets) {
+            for (const auto &block : set->ways) {
+                if (block.valid && block.dirty)
+                    discardedSize += std::ranges::count(block.dirtyBytes, true);
+            }
+        }
+
+        if (discardedSize > 0)
+            log::warn("Discarding {} of modifications that were never written back to the provider's source", hex::toByteString(discardedSize));
+
         clearCache();
     }
 
@@ -17,6 +63,7 @@ namespace hex::prv {
     }
 
     void CachedProvider::close() {
+        flushCache();
         clearCache();
     }
 
@@ -25,36 +72,31 @@ namespace hex::prv {
             return;
 
         std::shared_lock cacheLock(m_cacheMutex);
+        readCached(offset, buffer, size);
+    }
+
+    void CachedProvider::readRawBatch(std::span<const ReadRequest> requests) {
+        if (!isAvailable() || !isReadable())
+            return;
+
+        std::shared_lock cacheLock(m_cacheMutex);
+        for (const auto &request : requests)
+            readCached(request.offset, request.buffer, request.size);
+    }
+
+    void CachedProvider::readCached(u64 offset, void* buffer, size_t size) {
         auto out = static_cast<u8 *>(buffer);
         while (size > 0) {
             const auto blockIndex = calcBlockIndex(offset);
             const auto blockOffset = calcBlockOffset(offset);
             const auto toRead = std::min(m_cacheBlockSize - blockOffset, size);
-            const auto cacheSlot = blockIndex % m_maxBlocks;
 
             {
-                std::shared_lock lock(m_cacheSlotMutexes[cacheSlot]);
-                const auto &slot = m_cache[cacheSlot];
-                if (slot && slot->index == blockIndex) {
-                    std::copy_n(slot->data.begin() + blockOffset, toRead, out);
-
-                    out += toRead;
-                    offset += toRead;
-                    size -= toRead;
-                    continue;
-                }
-            }
+                auto &set = getCacheSet(blockIndex);
+                std::scoped_lock lock(set.mutex);
 
-            {
-                std::unique_lock lock(m_cacheSlotMutexes[cacheSlot]);
-                auto &slot = m_cache[cacheSlot];
-                if (!slot || slot->index != blockIndex) {
-                    std::vector<uint8_t> blockData(m_cacheBlockSize);
-                    readFromSource(blockIndex * m_cacheBlockSize, blockData.data(), m_cacheBlockSize);
-                    slot = Block{.index=blockIndex, .data=std::move(blockData), .dirty=false};
-                }
-
-                std::copy_n(slot->data.begin() + blockOffset, toRead, out);
+                const auto &block = getBlock(set, blockIndex);
+                std::copy_n(block.data.begin() + blockOffset, toRead, out);
             }
 
             out += toRead;
@@ -73,21 +115,24 @@ namespace hex::prv {
             const auto blockIndex = calcBlockIndex(offset);
             const auto blockOffset = calcBlockOffset(offset);
             const auto toWrite = std::min(m_cacheBlockSize - blockOffset, size);
-            const auto cacheSlot = blockIndex % m_maxBlocks;
 
             {
-                std::unique_lock lock(m_cacheSlotMutexes[cacheSlot]);
-                auto& slot = m_cache[cacheSlot];
-                if (!slot || slot->index != blockIndex) {
-                    std::vector<uint8_t> blockData(m_cacheBlockSize);
-                    readFromSource(blockIndex * m_cacheBlockSize, blockData.data(), m_cacheBlockSize);
-                    slot = Block { .index=blockIndex, .data=std::move(blockData), .dirty=false };
-                }
+                auto &set = getCacheSet(blockIndex);
+                std::scoped_lock lock(set.mutex);
 
-                std::copy_n(in, toWrite, slot->data.begin() + blockOffset);
-                slot->dirty = true;
+                auto &block = getBlock(set, blockIndex);
+                std::copy_n(in, toWrite, block.data.begin() + blockOffset);
 
-                writeToSource(offset, in, toWrite);
+                if (m_writePolicy == WritePolicy::WriteBack) {
+                    if (!block.dirty) {
+                        block.dirty = true;
+                        block.dirtyBytes.assign(m_cacheBlockSize, false);
+                    }
+
+                    std::fill_n(block.dirtyBytes.begin() + blockOffset, toWrite, true);
+                } else {
+                    writeToSource(offset, in, toWrite);
+                }
             }
 
             in += toWrite;
@@ -97,11 +142,18 @@ namespace hex::prv {
     }
 
     void CachedProvider::resizeRaw(u64 newSize) {
+        flushCache();
         clearCache();
 
         resizeSource(newSize);
     }
 
+    void CachedProvider::save() {
+        flushCache();
+
+        Provider::save();
+    }
+
 
     u64 CachedProvider::getActualSize() const {
         if (!isAvailable())
@@ -120,31 +172,192 @@ namespace hex::prv {
         return m_cachedSize;
     }
 
+    CachedProvider::WritePolicy CachedProvider::getWritePolicy() const {
+        return m_writePolicy;
+    }
 
-    void CachedProvider::clearCache() {
+    void CachedProvider::setWritePolicy(WritePolicy writePolicy) {
+        m_writePolicy = writePolicy;
+
+        if (writePolicy == WritePolicy::WriteThrough)
+            flushCache();
+    }
+
+    void CachedProvider::flushCache() {
         std::unique_lock lock(m_cacheMutex);
 
-        for (auto& slot : m_cache)
-            slot.reset();
+        std::vector<Block*> dirtyBlocks;
+        for (auto &set : m_cacheSets) {
+            for (auto &block : set->ways) {
+                if (block.valid && block.dirty)
+                    dirtyBlocks.push_back(&block);
+            }
+        }
+
+        if (dirtyBlocks.empty())
+            return;
+
+        std::ranges::sort(dirtyBlocks, [](const Block *a, const Block *b) { return a->index < b->index; });
+
+        // Merge modifications that directly follow each other into a single write
+        u64 pendingAddress = 0;
+        std::vector<u8> pendingData;
+        const auto writePending = [&] {
+            if (pendingData.empty())
+                return;
+
+            writeToSource(pendingAddress, pendingData.data(), pendingData.size());
+            pendingData.clear();
+        };
+
+        for (auto block : dirtyBlocks) {
+            forEachRun(block->dirtyBytes, [&](size_t begin, size_t end) {
+                const auto address = block->index * m_cacheBlockSize + begin;
+                if (pendingData.empty() || pendingAddress + pendingData.size() != address || pendingData.size() >= MaxFlushWriteSize) {
+                    writePending();
+                    pendingAddress = address;
+                }
+
+                pendingData.insert(pendingData.end(), block->data.begin() + begin, block->data.begin() + end);
+            });
+
+            block->dirty = false;
+            block->dirtyBytes.clear();
+        }
+
+        writePending();
+    }
+
+    CachedProvider::CacheStatistics CachedProvider::getCacheStatistics() const {
+        return {
+            .hits         = m_cacheHits,
+            .misses       = m_cacheMisses,
+            .evictions    = m_cacheEvictions,
+            .bytesFetched = m_bytesFetched
+        };
+    }
+
+    void CachedProvider::resetCacheStatistics() {
+        m_cacheHits      = 0;
+        m_cacheMisses    = 0;
+        m_cacheEvictions = 0;
+        m_bytesFetched   = 0;
+    }
+
+    size_t CachedProvider::getCacheBlockSize() const {
+        return m_cacheBlockSize;
+    }
+
+    size_t CachedProvider::getCacheBudget() const {
+        return m_cacheBudget;
+    }
+
+    void CachedProvider::setCacheBudget(size_t cacheBudget) {
+        flushCache();
+
+        {
+            std::unique_lock lock(m_cacheMutex);
+
+            m_cacheBudget = cacheBudget;
+            rebuildCache();
+        }
+
+        onCacheCleared();
+    }
+
+
+    void CachedProvider::clearCache() {
+        {
+            std::unique_lock lock(m_cacheMutex);
+
+            for (auto &set : m_cacheSets) {
+                for (auto &block : set->ways)
+                    block = Block { };
+            }
+
+            m_cachedSize = 0;
+        }
 
-        m_cachedSize = 0;
+        onCacheCleared();
     }
 
     void CachedProvider::setCacheBlockSize(size_t cacheBlockSize) {
-        std::unique_lock lock(m_cacheMutex);
+        flushCache();
+
+        {
+            std::unique_lock lock(m_cacheMutex);
 
-        for (auto &slot : m_cache)
-            slot.reset();
+            m_cacheBlockSize = cacheBlockSize;
+            rebuildCache();
 
-        m_cacheBlockSize = cacheBlockSize;
-        m_cachedSize = 0;
+            m_cachedSize = 0;
+        }
+
+        onCacheCleared();
     }
 
-    void CachedProvider::evictIfNeeded() {
-        if (m_cache.size() < m_maxBlocks)
-            return;
+    void CachedProvider::rebuildCache() {
+        // Always keep at least one full set around, even if the budget is smaller than that
+        const auto blockCount = std::max(m_cacheBudget / std::max<size_t>(m_cacheBlockSize, 1), m_associativity);
+        const auto setCount   = (blockCount + m_associativity - 1) / m_associativity;
+
+        m_cacheSets.clear();
+        m_cacheSets.reserve(setCount);
+        for (size_t i = 0; i < setCount; i += 1) {
+            auto &set = m_cacheSets.emplace_back(std::make_unique<CacheSet>());
+            set->ways.resize(m_associativity);
+        }
+    }
+
+    CachedProvider::CacheSet& CachedProvider::getCacheSet(u64 blockIndex) const {
+        return *m_cacheSets[blockIndex % m_cacheSets.size()];
+    }
+
+    CachedProvider::Block& CachedProvider::getBlock(CacheSet &set, u64 blockIndex) {
+        set.accessCounter += 1;
+
+        Block *victim = nullptr;
+        for (auto &block : set.ways) {
+            if (block.valid && block.index == blockIndex) {
+                block.lastAccess = set.accessCounter;
+                m_cacheHits += 1;
+
+                return block;
+            }
+
+            // Prefer empty ways, otherwise replace the least recently used block
+            if (victim == nullptr || (victim->valid && (!block.valid || block.lastAccess < victim->lastAccess)))
+                victim = &block;
+        }
+
+        m_cacheMisses += 1;
+        if (victim->valid) {
+            if (victim->dirty)
+                writeBackBlock(*victim);
+
+            m_cacheEvictions += 1;
+        }
+
+        victim->data.resize(m_cacheBlockSize);
+        readFromSource(blockIndex * m_cacheBlockSize, victim->data.data(), m_cacheBlockSize);
+        m_bytesFetched += m_cacheBlockSize;
+
+        victim->index      = blockIndex;
+        victim->lastAccess = set.accessCounter;
+        victim->valid      = true;
+        victim->dirty      = false;
+        victim->dirtyBytes.clear();
+
+        return *victim;
+    }
+
+    void CachedProvider::writeBackBlock(Block &block) {
+        forEachRun(block.dirtyBytes, [&](size_t begin, size_t end) {
+            writeToSource(block.index * m_cacheBlockSize + begin, block.data.data() + begin, end - begin);
+        });
 
-        m_cache.erase(m_cache.begin());
+        block.dirty = false;
+        block.dirtyBytes.clear();
     }
 
 }
@@ -21,6 +21,7 @@ namespace hex::prv {
             return;
 
         m_segments.push_back({ provider, region });
+        m_segmentOffsets.push_back(m_size);
         m_size += region.size;
     }
 
@@ -41,26 +42,28 @@ namespace hex::prv {
         });
     }
 
+    size_t ConcatenatedProvider::findSegment(u64 offset) const {
+        const auto it = std::ranges::upper_bound(m_segmentOffsets, offset);
+        return std::distance(m_segmentOffsets.begin(), it) - 1;
+    }
+
     void ConcatenatedProvider::readRaw(u64 offset, void *buffer, size_t size) {
         if (buffer == nullptr || size == 0 || offset > m_size || size > m_size - offset)
             return;
 
+        // Segments are read one after another. Callers that want to read large amounts of data in parallel split their
+        // reads up themselves, creating threads for every single read here would make the common small reads a lot slower
         auto output = static_cast<u8*>(buffer);
-        for (const auto &[provider, region] : m_segments) {
-            if (offset >= region.size) {
-                offset -= region.size;
-                continue;
-            }
+        for (auto index = this->findSegment(offset); index < m_segments.size() && size > 0; index += 1) {
+            const auto &[provider, region] = m_segments[index];
+            const auto segmentOffset = offset - m_segmentOffsets[index];
+            const auto readSize = std::min<u64>(size, region.size - segmentOffset);
 
-            const auto readSize = std::min<u64>(size, region.size - offset);
-            provider->read(region.address + offset, output, static_cast<size_t>(readSize));
+            provider->read(region.address + segmentOffset, output, static_cast<size_t>(readSize));
 
             output += readSize;
+            offset += readSize;
             size -= static_cast<size_t>(readSize);
-            offset = 0;
-
-            if (size == 0)
-                break;
         }
     }
 
@@ -6,6 +6,7 @@ namespace hex::prv {
 
     Provider::OpenResult MemoryProvider::open() {
         if (m_data.empty()) {
+            m_viewedData.detach(m_data);
             m_data.resize(1);
         }
 
@@ -20,6 +21,14 @@ namespace hex::prv {
         std::memcpy(buffer, &m_data.front() + offset, size);
     }
 
+    std::optional<Provider::ContiguousView> MemoryProvider::tryGetContiguousViewRaw(u64 offset, size_t size) {
+        auto actualSize = this->getActualSize();
+        if (actualSize == 0 || (offset + size) > actualSize || size == 0)
+            return std::nullopt;
+
+        return m_viewedData.createView(m_data, offset, size);
+    }
+
     void MemoryProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
         if ((offset + size) > this->getActualSize() || buffer == nullptr || size == 0)
             return;
@@ -28,6 +37,7 @@ namespace hex::prv {
     }
 
     void MemoryProvider::resizeRaw(u64 newSize) {
+        m_viewedData.detach(m_data);
         m_data.resize(newSize);
     }
 
@@ -0,0 +1,302 @@
+#include <hex/providers/piece_table.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace hex::prv {
+
+    namespace {
+
+        template<typename T>
+        bool canMerge(const T &first, const T &second) {
+            if (first.source != second.source)
+                return false;
+
+            return first.source == PieceTable::Source::Zero || first.sourceOffset + first.size == second.sourceOffset;
+        }
+
+    }
+
+    template<typename Callback>
+    void PieceTable::visit(u32 node, u64 address, u64 from, u64 to, Callback &&callback) const {
+        // Calls the callback for every piece overlapping [from, to) in order, only descending into subtrees that overlap as well
+        if (node == NoNode || from >= to)
+            return;
+
+        const auto &current = m_nodes[node];
+        const auto nodeAddress = address + this->getSubtreeSize(current.left);
+        const auto nodeEnd     = nodeAddress + current.size;
+
+        if (from < nodeAddress)
+            this->visit(current.left, address, from, to, callback);
+        if (from < nodeEnd && nodeAddress < to)
+            callback(current, nodeAddress);
+        if (to > nodeEnd)
+            this->visit(current.right, nodeEnd, from, to, callback);
+    }
+
+    void PieceTable::reset(u64 originalSize) {
+        m_nodes.clear();
+        m_freeNodes.clear();
+        m_root = NoNode;
+        m_addedData.clear();
+        m_addedData.shrink_to_fit();
+        m_originalSize = originalSize;
+
+        if (originalSize > 0)
+            m_root = this->createNode(originalSize, Source::Original, 0);
+    }
+
+    bool PieceTable::isModified() const {
+        if (m_root == NoNode)
+            return m_originalSize != 0;
+
+        const auto &node = m_nodes[m_root];
+        if (node.left != NoNode || node.right != NoNode)
+            return true;
+
+        return node.source != Source::Original || node.sourceOffset != 0 || node.size != m_originalSize;
+    }
+
+    u64 PieceTable::getSize() const {
+        return this->getSubtreeSize(m_root);
+    }
+
+    std::vector<PieceTable::Piece> PieceTable::getPieces() const {
+        std::vector<Piece> pieces;
+        this->visit(m_root, 0, 0, this->getSize(), [&pieces](const Node &node, u64 address) {
+            pieces.push_back({ .address=address, .size=node.size, .source=node.source, .sourceOffset=node.sourceOffset });
+        });
+
+        return pieces;
+    }
+
+    void PieceTable::read(u64 offset, void *buffer, size_t size, const ReadOriginalFunction &readOriginal) const {
+        const auto end = offset + std::min<u64>(size, this->getSize() - std::min(offset, this->getSize()));
+
+        auto out = static_cast<u8 *>(buffer);
+        this->visit(m_root, 0, offset, end, [&](const Node &node, u64 address) {
+            const auto readStart = std::max(address, offset);
+            const auto readEnd   = std::min(address + node.size, end);
+            const auto pieceOffset = readStart - address;
+            const auto readSize    = readEnd - readStart;
+            const auto data        = out + (readStart - offset);
+
+            switch (node.source) {
+                case Source::Original:
+                    readOriginal(node.sourceOffset + pieceOffset, data, readSize);
+                    break;
+                case Source::Added:
+                    std::memcpy(data, m_addedData.data() + node.sourceOffset + pieceOffset, readSize);
+                    break;
+                case Source::Zero:
+                    std::memset(data, 0x00, readSize);
+                    break;
+            }
+        });
+    }
+
+    void PieceTable::write(u64 offset, const void *buffer, size_t size) {
+        if (size == 0 || offset + size > this->getSize())
+            return;
+
+        const auto [before, rest]    = this->split(m_root, offset);
+        const auto [written, after] = this->split(rest, size);
+
+        std::vector<u32> writtenNodes;
+        this->visit(written, 0, 0, size, [this, &writtenNodes](const Node &node, u64) {
+            writtenNodes.push_back(u32(&node - m_nodes.data()));
+        });
+
+        // Rebuild the written part piece by piece so pieces that now continue each other get combined again
+        auto in = static_cast<const u8 *>(buffer);
+        u32 result = NoNode;
+        for (const auto index : writtenNodes) {
+            auto &node = m_nodes[index];
+
+            // Data that has been written before can be updated in place, everything else moves into the added data
+            if (node.source == Source::Added) {
+                std::memcpy(m_addedData.data() + node.sourceOffset, in, node.size);
+            } else {
+                node.source       = Source::Added;
+                node.sourceOffset = m_addedData.size();
+                m_addedData.insert(m_addedData.end(), in, in + node.size);
+            }
+
+            in += node.size;
+
+            node.left  = NoNode;
+            node.right = NoNode;
+            node.subtreeSize = node.size;
+            result = this->join(result, index);
+        }
+
+        m_root = this->join(this->join(before, result), after);
+    }
+
+    void PieceTable::insert(u64 offset, u64 size) {
+        if (size == 0)
+            return;
+
+        offset = std::min(offset, this->getSize());
+
+        const auto [before, after] = this->split(m_root, offset);
+        const auto inserted = this->createNode(size, Source::Zero, 0);
+
+        m_root = this->join(this->join(before, inserted), after);
+    }
+
+    void PieceTable::remove(u64 offset, u64 size) {
+        const auto currentSize = this->getSize();
+        if (offset >= currentSize || size == 0)
+            return;
+
+        size = std::min(size, currentSize - offset);
+
+        const auto [before, rest]    = this->split(m_root, offset);
+        const auto [removed, after] = this->split(rest, size);
+        this->freeTree(removed);
+
+        m_root = this->join(before, after);
+    }
+
+    void PieceTable::resize(u64 newSize) {
+        const auto currentSize = this->getSize();
+
+        if (newSize > currentSize)
+            this->insert(currentSize, newSize - currentSize);
+        else if (newSize < currentSize)
+            this->remove(newSize, currentSize - newSize);
+    }
+
+    u32 PieceTable::createNode(u64 size, Source source, u64 sourceOffset) {
+        // Xorshift, the priorities only need to be spread out evenly, not be unpredictable
+        m_randomState ^= m_randomState << 13;
+        m_randomState ^= m_randomState >> 17;
+        m_randomState ^= m_randomState << 5;
+
+        const Node node = {
+            .size         = size,
+            .source       = source,
+            .sourceOffset = source == Source::Zero ? 0 : sourceOffset,
+            .subtreeSize  = size,
+            .priority     = m_randomState,
+            .left         = NoNode,
+            .right        = NoNode
+        };
+
+        if (m_freeNodes.empty()) {
+            m_nodes.push_back(node);
+            return u32(m_nodes.size() - 1);
+        }
+
+        const auto index = m_freeNodes.back();
+        m_freeNodes.pop_back();
+        m_nodes[index] = node;
+
+        return index;
+    }
+
+    void PieceTable::freeTree(u32 node) {
+        if (node == NoNode)
+            return;
+
+        this->freeTree(m_nodes[node].left);
+        this->freeTree(m_nodes[node].right);
+        m_freeNodes.push_back(node);
+    }
+
+    u64 PieceTable::getSubtreeSize(u32 node) const {
+        return node == NoNode ? 0 : m_nodes[node].subtreeSize;
+    }
+
+    void PieceTable::updateSubtreeSize(u32 node) {
+        auto &current = m_nodes[node];
+        current.subtreeSize = this->getSubtreeSize(current.left) + current.size + this->getSubtreeSize(current.right);
+    }
+
+    std::pair<u32, u32> PieceTable::split(u32 node, u64 offset) {
+        if (node == NoNode)
+            return { NoNode, NoNode };
+
+        const auto leftSize = this->getSubtreeSize(m_nodes[node].left);
+        const auto nodeSize = m_nodes[node].size;
+
+        if (offset <= leftSize) {
+            const auto [first, second] = this->split(m_nodes[node].left, offset);
+            m_nodes[node].left = second;
+            this->updateSubtreeSize(node);
+
+            return { first, node };
+        }
+
+        if (offset >= leftSize + nodeSize) {
+            const auto [first, second] = this->split(m_nodes[node].right, offset - leftSize - nodeSize);
+            m_nodes[node].right = first;
+            this->updateSubtreeSize(node);
+
+            return { node, second };
+        }
+
+        // The offset lies inside of this node's piece, the part behind it becomes a new node in the second tree
+        const auto firstSize = offset - leftSize;
+        const auto secondNode = this->createNode(nodeSize - firstSize, m_nodes[node].source, m_nodes[node].sourceOffset + firstSize);
+        const auto right = m_nodes[node].right;
+
+        m_nodes[node].size  = firstSize;
+        m_nodes[node].right = NoNode;
+        this->updateSubtreeSize(node);
+
+        return { node, this->merge(secondNode, right) };
+    }
+
+    u32 PieceTable::merge(u32 first, u32 second) {
+        if (first == NoNode)
+            return second;
+        if (second == NoNode)
+            return first;
+
+        if (m_nodes[first].priority > m_nodes[second].priority) {
+            const auto right = this->merge(m_nodes[first].right, second);
+            m_nodes[first].right = right;
+            this->updateSubtreeSize(first);
+
+            return first;
+        } else {
+            const auto left = this->merge(first, m_nodes[second].left);
+            m_nodes[second].left = left;
+            this->updateSubtreeSize(second);
+
+            return second;
+        }
+    }
+
+    u32 PieceTable::join(u32 first, u32 second) {
+        if (first == NoNode || second == NoNode)
+            return this->merge(first, second);
+
+        auto lastNode = first;
+        while (m_nodes[lastNode].right != NoNode)
+            lastNode = m_nodes[lastNode].right;
+
+        auto firstNode = second;
+        while (m_nodes[firstNode].left != NoNode)
+            firstNode = m_nodes[firstNode].left;
+
+        if (!canMerge(m_nodes[lastNode], m_nodes[firstNode]))
+            return this->merge(first, second);
+
+        // Cut the first piece off of the second tree and grow the last piece of the first tree by its size instead.
+        // The last piece sits at the end of the right spine, so only the nodes on that spine cover it
+        const auto addedSize = m_nodes[firstNode].size;
+        const auto [removed, rest] = this->split(second, addedSize);
+        this->freeTree(removed);
+
+        for (auto node = first; node != NoNode; node = m_nodes[node].right)
+            m_nodes[node].subtreeSize += addedSize;
+        m_nodes[lastNode].size += addedSize;
+
+        return this->merge(first, rest);
+    }
+
+}
@@ -12,9 +12,13 @@
 #include <wolv/literals.hpp>
 #include <wolv/utils/string.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <limits>
+#include <map>
 #include <optional>
+#include <ranges>
 
 #include <nlohmann/json.hpp>
 
@@ -145,6 +149,62 @@ namespace hex::prv {
             this->applyOverlays(offset, buffer, size);
     }
 
+    void Provider::readBatch(std::span<const ReadRequest> requests, bool overlays) {
+        std::vector<ReadRequest> rawRequests(requests.begin(), requests.end());
+        for (auto &request : rawRequests)
+            request.offset -= this->getBaseAddress();
+
+        this->readRawBatch(rawRequests);
+
+        if (overlays) {
+            for (const auto &request : requests)
+                this->applyOverlays(request.offset, request.buffer, request.size);
+        }
+    }
+
+    void Provider::readRawBatch(std::span<const ReadRequest> requests) {
+        for (const auto &request : requests)
+            this->readRaw(request.offset, request.buffer, request.size);
+    }
+
+    std::optional<Provider::ContiguousView> Provider::tryGetContiguousView(const Region &region) {
+        if (region.size == 0 || region.address < this->getBaseAddress())
+            return std::nullopt;
+
+        // Overlays only exist in the data returned by read(), the backing memory doesn't contain them
+        if (m_hasOverlays) {
+            std::shared_lock lock(m_overlayIndexMutex);
+
+            auto segment = findOverlaySegment(region.getStartAddress());
+            if (segment != m_overlayIndex.end() && segment->start <= region.getEndAddress())
+                return std::nullopt;
+        }
+
+        return this->tryGetContiguousViewRaw(region.address - this->getBaseAddress(), region.size);
+    }
+
+    std::optional<Provider::ContiguousView> Provider::tryGetContiguousViewRaw(u64 offset, size_t size) {
+        std::ignore = offset;
+        std::ignore = size;
+
+        return std::nullopt;
+    }
+
+    void Provider::ViewedBuffer::detach(std::vector<u8> &buffer, bool keepContents) {
+        // Nobody is using a view right now, the buffer can be reallocated freely
+        if (m_storage.use_count() <= 1)
+            return;
+
+        // Moving the buffer keeps its storage in place, so the existing views stay valid
+        std::vector<u8> copy;
+        if (keepContents)
+            copy = buffer;
+
+        *m_storage = std::move(buffer);
+        buffer = std::move(copy);
+        m_storage = std::make_shared<std::vector<u8>>();
+    }
+
     void Provider::write(u64 offset, const void *buffer, size_t size) {
         if (!this->isWritable())
             return;
@@ -158,6 +218,7 @@ namespace hex::prv {
             return;
 
         this->markDataDirty(false);
+        m_undoRedoStack.sealOperations();
         EventProviderSaved::post(this);
     }
     void Provider::saveAs(const std::fs::path &path) {
@@ -263,25 +324,91 @@ namespace hex::prv {
 
 
     void Provider::applyOverlays(u64 offset, void *buffer, size_t size) const {
-        for (auto &overlay : m_overlays) {
-            auto overlayOffset = overlay->getAddress();
-            auto overlaySize   = overlay->getSize();
+        if (!m_hasOverlays || size == 0)
+            return;
+
+        std::shared_lock lock(m_overlayIndexMutex);
+
+        const u64 end = offset + size;
+        for (auto segment = findOverlaySegment(offset); segment != m_overlayIndex.end() && segment->start < end; ++segment) {
+            const auto &overlay = *segment->overlay;
+            const auto overlayOffset = overlay.getAddress();
 
-            u64 overlapMin = std::max(offset, overlayOffset);
-            u64 overlapMax = std::min(offset + size, overlayOffset + overlaySize);
+            // Also clamp to the overlay itself in case it got modified after the index was built
+            u64 overlapMin = std::max<u64>({ offset, segment->start, overlayOffset });
+            u64 overlapMax = std::min<u64>({ end, segment->end, overlayOffset + overlay.getSize() });
             if (overlapMax > overlapMin)
-                std::memcpy(static_cast<u8 *>(buffer) + std::max<u64>(0, overlapMin - offset), overlay->getData().data() + std::max<u64>(0, overlapMin - overlayOffset), overlapMax - overlapMin);
+                std::memcpy(static_cast<u8 *>(buffer) + (overlapMin - offset), overlay.getData().data() + (overlapMin - overlayOffset), overlapMax - overlapMin);
         }
     }
 
     Overlay *Provider::newOverlay() {
-        return m_overlays.emplace_back(std::make_unique<Overlay>()).get();
+        return m_overlays.emplace_back(std::make_unique<Overlay>([this] { this->rebuildOverlayIndex(); })).get();
     }
 
     void Provider::deleteOverlay(Overlay *overlay) {
-        m_overlays.remove_if([overlay](const auto &item) {
+        const auto it = std::ranges::find_if(m_overlays, [overlay](const auto &item) {
             return item.get() == overlay;
         });
+
+        if (it == m_overlays.end())
+            return;
+
+        // Reads running concurrently may still be looking at the overlay through the current index. Only free it once
+        // an index without it has been published, which waits for all of those reads to finish
+        auto removedOverlay = std::move(*it);
+        m_overlays.erase(it);
+
+        this->rebuildOverlayIndex();
+    }
+
+    void Provider::rebuildOverlayIndex() {
+        std::map<u64, OverlaySegment> segments;
+
+        // Cuts the segment that contains the address in two so that a new segment can start or end there
+        const auto splitAt = [&segments](u64 address) {
+            auto it = segments.upper_bound(address);
+            if (it == segments.begin())
+                return;
+
+            auto &segment = std::prev(it)->second;
+            if (segment.start < address && address < segment.end) {
+                segments.emplace(address, OverlaySegment { .start=address, .end=segment.end, .overlay=segment.overlay });
+                segment.end = address;
+            }
+        };
+
+        // Paint the overlays on top of each other in the order they were created in. This way, overlays
+        // created later replace the parts of earlier ones they overlap, exactly like they do when applied to a buffer
+        for (const auto &overlay : m_overlays) {
+            const auto start = overlay->getAddress();
+            const auto size  = overlay->getSize();
+            if (size == 0)
+                continue;
+
+            const auto end = start + std::min<u64>(size, std::numeric_limits<u64>::max() - start);
+            splitAt(start);
+            splitAt(end);
+
+            segments.erase(segments.lower_bound(start), segments.lower_bound(end));
+            segments.emplace(start, OverlaySegment { .start=start, .end=end, .overlay=overlay.get() });
+        }
+
+        std::vector<OverlaySegment> index;
+        index.reserve(segments.size());
+        for (const auto &segment : segments | std::views::values)
+            index.push_back(segment);
+
+        std::unique_lock lock(m_overlayIndexMutex);
+        m_overlayIndex = std::move(index);
+        m_hasOverlays = !m_overlayIndex.empty();
+    }
+
+    std::vector<Provider::OverlaySegment>::const_iterator Provider::findOverlaySegment(u64 address) const {
+        // Segments don't overlap, so their end addresses are sorted the same way as their start addresses
+        return std::ranges::partition_point(m_overlayIndex, [address](const OverlaySegment &segment) {
+            return segment.end <= address;
+        });
     }
 
     const std::list<std::unique_ptr<Overlay>> &Provider::getOverlays() const {
@@ -379,24 +506,15 @@ namespace hex::prv {
             return { Region { .address=this->getBaseAddress() + absoluteAddress, .size=this->getActualSize() - absoluteAddress }, true };
 
 
-        bool insideValidRegion = false;
-
-        std::optional<u64> nextRegionAddress;
-        for (const auto &overlay : m_overlays) {
-            Region overlayRegion = { .address=overlay->getAddress(), .size=overlay->getSize() };
-            if (!nextRegionAddress.has_value() || overlay->getAddress() < nextRegionAddress) {
-                nextRegionAddress = overlayRegion.getStartAddress();
-            }
-
-            if (Region { .address=address, .size=1 }.overlaps(overlayRegion)) {
-                insideValidRegion = true;
-            }
-        }
+        std::shared_lock lock(m_overlayIndexMutex);
 
-        if (!nextRegionAddress.has_value())
+        const auto segment = findOverlaySegment(address);
+        if (segment == m_overlayIndex.end())
             return { Region::Invalid(), false };
+        else if (segment->start <= address)
+            return { Region { .address=address, .size=segment->end - address }, true };
         else
-            return { Region { .address=address, .size=*nextRegionAddress - address }, insideValidRegion };
+            return { Region { .address=address, .size=segment->start - address }, false };
     }
 
 
@@ -0,0 +1,162 @@
+#include <hex/providers/undo_redo/compact_buffer.hpp>
+
+#include <hex/helpers/fmt.hpp>
+#include <hex/helpers/fs.hpp>
+#include <hex/helpers/logger.hpp>
+
+#include <wolv/io/file.hpp>
+#include <wolv/io/fs.hpp>
+#include <wolv/utils/string.hpp>
+
+#include <mutex>
+#include <optional>
+#include <random>
+
+namespace hex::prv::undo {
+
+    class SpillFile {
+    public:
+        SpillFile(std::fs::path path, wolv::io::File file) : m_path(std::move(path)), m_file(std::move(file)) { }
+
+        SpillFile(const SpillFile&) = delete;
+        SpillFile& operator=(const SpillFile&) = delete;
+
+        ~SpillFile() {
+            m_file.close();
+            wolv::io::fs::remove(m_path);
+        }
+
+        [[nodiscard]] std::optional<u64> write(std::span<const u8> data) {
+            std::scoped_lock lock(m_mutex);
+
+            const auto offset = m_size;
+            if (m_file.writeBufferAtomic(offset, data.data(), data.size()) != data.size())
+                return std::nullopt;
+
+            m_size += data.size();
+            return offset;
+        }
+
+        [[nodiscard]] std::vector<u8> read(u64 offset, size_t size) {
+            std::scoped_lock lock(m_mutex);
+
+            return m_file.readVectorAtomic(offset, size);
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::fs::path m_path;
+        wolv::io::File m_file;
+        u64 m_size = 0;
+    };
+
+    std::shared_ptr<SpillFile> createSpillFile() {
+        std::error_code error;
+        const auto directory = std::fs::temp_directory_path(error);
+        if (error)
+            return nullptr;
+
+        const auto path = directory / fmt::format("imhex_undo_{:08X}.tmp", std::random_device()());
+        wolv::io::File file(path, wolv::io::File::Mode::Create);
+        if (!file.isValid()) {
+            log::warn("Failed to create undo spill file '{}'", wolv::util::toUTF8String(path));
+            return nullptr;
+        }
+
+        return std::make_shared<SpillFile>(path, std::move(file));
+    }
+
+    namespace {
+
+        /**
+         * @brief Encodes data as a list of runs, each one stored as the byte value followed by the run length as a LEB128 number
+         * @return The encoded data or std::nullopt if the encoding wouldn't be smaller than the data itself
+         */
+        std::optional<std::vector<u8>> encodeRunLength(std::span<const u8> data) {
+            std::vector<u8> result;
+
+            for (size_t i = 0; i < data.size();) {
+                size_t runEnd = i + 1;
+                while (runEnd < data.size() && data[runEnd] == data[i])
+                    runEnd += 1;
+
+                result.push_back(data[i]);
+
+                u64 length = runEnd - i;
+                do {
+                    const u8 byte = length & 0x7F;
+                    length >>= 7;
+                    result.push_back(byte | (length != 0 ? 0x80 : 0x00));
+                } while (length != 0);
+
+                if (result.size() >= data.size())
+                    return std::nullopt;
+
+                i = runEnd;
+            }
+
+            return result;
+        }
+
+        std::vector<u8> decodeRunLength(std::span<const u8> encoded, size_t size) {
+            std::vector<u8> result;
+            result.reserve(size);
+
+            for (size_t i = 0; i < encoded.size();) {
+                const u8 value = encoded[i++];
+
+                u64 length = 0;
+                for (u32 shift = 0; i < encoded.size(); shift += 7) {
+                    const u8 byte = encoded[i++];
+                    length |= u64(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0)
+                        break;
+                }
+
+                result.insert(result.end(), length, value);
+            }
+
+            return result;
+        }
+
+    }
+
+    CompactBuffer::CompactBuffer(std::span<const u8> data) : m_size(data.size()) {
+        if (auto encoded = encodeRunLength(data); encoded.has_value()) {
+            m_encoding = Encoding::RunLength;
+            m_data = std::move(*encoded);
+        } else {
+            m_encoding = Encoding::Raw;
+            m_data.assign(data.begin(), data.end());
+        }
+    }
+
+    std::vector<u8> CompactBuffer::get() const {
+        const auto stored = m_spillFile != nullptr ? m_spillFile->read(m_spillOffset, m_spillSize) : m_data;
+
+        switch (m_encoding) {
+            case Encoding::RunLength:
+                return decodeRunLength(stored, m_size);
+            case Encoding::Raw:
+            default:
+                return stored;
+        }
+    }
+
+    void CompactBuffer::offload(const std::shared_ptr<SpillFile> &spillFile) {
+        if (spillFile == nullptr || m_spillFile != nullptr || m_data.empty())
+            return;
+
+        const auto offset = spillFile->write(m_data);
+        if (!offset.has_value())
+            return;
+
+        m_spillFile   = spillFile;
+        m_spillOffset = *offset;
+        m_spillSize   = m_data.size();
+
+        m_data.clear();
+        m_data.shrink_to_fit();
+    }
+
+}
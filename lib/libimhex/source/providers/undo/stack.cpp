@@ -3,6 +3,8 @@
 #include <hex/api/events/events_interaction.hpp>
 
 #include <hex/providers/provider.hpp>
+#include <hex/helpers/literals.hpp>
+#include <hex/helpers/logger.hpp>
 
 #include <wolv/utils/guards.hpp>
 
@@ -10,9 +12,11 @@
 
 namespace hex::prv::undo {
 
+    using namespace hex::literals;
+
     namespace {
 
-        std::recursive_mutex s_mutex;
+        std::atomic<size_t> s_memoryLimit = 256_MiB;
 
     }
 
@@ -20,13 +24,21 @@ namespace hex::prv::undo {
 
     }
 
-    std::recursive_mutex& Stack::getMutex() {
-        return s_mutex;
+    std::recursive_mutex& Stack::getMutex() const {
+        return m_mutex;
+    }
+
+    void Stack::setMemoryLimit(size_t limit) {
+        s_memoryLimit = limit;
+    }
+
+    size_t Stack::getMemoryLimit() {
+        return s_memoryLimit;
     }
 
 
     void Stack::undo(u32 count) {
-        std::lock_guard lock(s_mutex);
+        std::lock_guard lock(m_mutex);
 
         // If there are no operations, we can't undo anything.
         if (m_undoStack.empty())
@@ -42,12 +54,17 @@ namespace hex::prv::undo {
             m_redoStack.emplace_back(std::move(m_undoStack.back()));
             m_redoStack.back()->undo(m_provider);
             m_undoStack.pop_back();
+            m_mergeCounts.pop_back();
             EventDataChanged::post(m_provider);
         }
+
+        // Don't merge new operations into ones that have been undone and redone again
+        m_mergeBarrier = m_undoStack.size();
+        m_offloadedCount = std::min(m_offloadedCount, m_undoStack.size());
     }
 
     void Stack::redo(u32 count) {
-        std::lock_guard lock(s_mutex);
+        std::lock_guard lock(m_mutex);
 
         // If there are no operations, we can't redo anything.
         if (m_redoStack.empty())
@@ -59,43 +76,66 @@ namespace hex::prv::undo {
                 return;
             }
 
-            // Move last element from the undo stack to the redo stack
-            m_undoStack.emplace_back(std::move(m_redoStack.back()));
-            m_undoStack.back()->redo(m_provider);
+            // Move last element from the redo stack to the undo stack
+            auto &operation = m_undoStack.emplace_back(std::move(m_redoStack.back()));
             m_redoStack.pop_back();
+            m_mergeCounts.push_back(1);
+
+            const auto previousUsage = operation->getMemoryUsage();
+            operation->redo(m_provider);
+            m_memoryUsage = m_memoryUsage - previousUsage + operation->getMemoryUsage();
+
             EventDataChanged::post(m_provider);
         }
+
+        m_mergeBarrier = m_undoStack.size();
+        this->enforceMemoryLimit();
     }
 
     void Stack::groupOperations(u32 count, const UnlocalizedString &unlocalizedName) {
-        std::lock_guard lock(s_mutex);
+        std::lock_guard lock(m_mutex);
 
         if (count <= 1)
             return;
 
+        // Operations may have been merged together when they were added, so figure out
+        // how many entries on the stack the requested number of operations ended up in
+        size_t entryCount = 0;
+        for (u64 addedCount = 0; entryCount < m_undoStack.size() && addedCount < count; entryCount += 1)
+            addedCount += m_mergeCounts[m_mergeCounts.size() - entryCount - 1];
+
+        if (entryCount <= 1)
+            return;
+
         auto operation = std::make_unique<OperationGroup>(unlocalizedName);
 
-        i64 startIndex = std::max<i64>(0, m_undoStack.size() - count);
+        i64 startIndex = std::max<i64>(0, m_undoStack.size() - entryCount);
 
         // Move operations from our stack to the group in the same order they were added
-        for (u32 i = 0; i < count; i += 1) {
+        for (u32 i = 0; i < entryCount; i += 1) {
             i64 index = startIndex + i;
 
             if (index < 0 || u64(index) >= m_undoStack.size()) {
                 break;
             }
 
+            m_memoryUsage -= m_undoStack[index]->getMemoryUsage();
             m_undoStack[index]->undo(m_provider);
             operation->addOperation(std::move(m_undoStack[index]));
         }
 
         // Remove the empty operations from the stack
         m_undoStack.resize(startIndex);
+        m_mergeCounts.resize(startIndex);
+        m_mergeBarrier   = std::min<size_t>(m_mergeBarrier, startIndex);
+        m_offloadedCount = std::min<size_t>(m_offloadedCount, startIndex);
+
         this->add(std::move(operation));
+        m_mergeBarrier = m_undoStack.size();
     }
 
     void Stack::apply(const Stack &otherStack) {
-        std::lock_guard lock(s_mutex);
+        std::scoped_lock lock(m_mutex, otherStack.m_mutex);
 
         for (const auto &operation : otherStack.m_undoStack) {
             this->add(operation->clone());
@@ -103,7 +143,7 @@ namespace hex::prv::undo {
     }
 
     void Stack::reapply() {
-        std::lock_guard lock(s_mutex);
+        std::lock_guard lock(m_mutex);
 
         for (const auto &operation : m_undoStack) {
             operation->redo(m_provider);
@@ -115,30 +155,93 @@ namespace hex::prv::undo {
 
 
     bool Stack::add(std::unique_ptr<Operation> &&operation) {
-        std::lock_guard lock(s_mutex);
+        std::lock_guard lock(m_mutex);
 
         // Clear the redo stack
-        m_redoStack.clear();
+        this->clearRedoStack();
+
+        // Try folding the new operation into the previous one first so a large number of small edits doesn't
+        // end up as a large number of separate entries
+        if (m_undoStack.size() > m_mergeBarrier && m_undoStack.size() > m_offloadedCount) {
+            auto lastOperation = this->getLastOperation();
+            const auto previousUsage = lastOperation->getMemoryUsage();
+
+            if (lastOperation->merge(*operation)) {
+                operation->redo(m_provider);
+
+                m_mergeCounts.back() += 1;
+                m_memoryUsage = m_memoryUsage - previousUsage + lastOperation->getMemoryUsage();
+
+                EventDataChanged::post(m_provider);
+
+                return true;
+            }
+        }
 
         // Insert the new operation at the end of the list
         m_undoStack.emplace_back(std::move(operation));
+        m_mergeCounts.push_back(1);
 
         // Do the operation
         this->getLastOperation()->redo(m_provider);
+        m_memoryUsage += this->getLastOperation()->getMemoryUsage();
+
+        this->enforceMemoryLimit();
 
         EventDataChanged::post(m_provider);
 
         return true;
     }
 
+    void Stack::sealOperations() {
+        std::lock_guard lock(m_mutex);
+
+        m_mergeBarrier = m_undoStack.size();
+    }
+
+    void Stack::clearRedoStack() {
+        for (const auto &operation : m_redoStack)
+            m_memoryUsage -= operation->getMemoryUsage();
+
+        m_redoStack.clear();
+    }
+
+    void Stack::enforceMemoryLimit() {
+        const size_t limit = s_memoryLimit;
+        if (m_memoryUsage <= limit || m_spillFileFailed)
+            return;
+
+        if (m_spillFile == nullptr) {
+            m_spillFile = createSpillFile();
+            if (m_spillFile == nullptr) {
+                log::warn("Undo history exceeds its memory limit but can't be moved to disk");
+                m_spillFileFailed = true;
+                return;
+            }
+        }
+
+        // Move the data of the oldest operations to disk until there's some headroom left again.
+        // The most recent operation is always kept in memory since it's the most likely one to be undone
+        const auto target = limit / 4 * 3;
+        while (m_memoryUsage > target && m_offloadedCount + 1 < m_undoStack.size()) {
+            auto &operation = m_undoStack[m_offloadedCount];
+
+            const auto previousUsage = operation->getMemoryUsage();
+            operation->offload(m_spillFile);
+            m_memoryUsage = m_memoryUsage - previousUsage + operation->getMemoryUsage();
+
+            m_offloadedCount += 1;
+        }
+    }
+
     bool Stack::canUndo() const {
-        std::lock_guard lock(s_mutex);
+        std::lock_guard lock(m_mutex);
 
         return !m_undoStack.empty();
     }
 
     bool Stack::canRedo() const {
-        std::lock_guard lock(s_mutex);
+        std::lock_guard lock(m_mutex);
 
         return !m_redoStack.empty();
     }
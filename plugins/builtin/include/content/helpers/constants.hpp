@@ -1,9 +1,18 @@
 #pragma once
 
+#include <array>
+#include <functional>
+#include <span>
 #include <string>
 #include <vector>
 
+#include <hex/api/task_manager.hpp>
 #include <hex/helpers/binary_pattern.hpp>
+#include <hex/helpers/types.hpp>
+
+namespace hex::prv {
+    class Provider;
+}
 
 namespace hex::plugin::builtin {
 
@@ -24,4 +33,73 @@ namespace hex::plugin::builtin {
         std::vector<Constant> m_constants;
     };
 
-}
\ No newline at end of file
+    /**
+     * @brief Finds all constants of multiple groups in a single pass over the data
+     *
+     * The longest run of fully specified bytes of every constant is added to an Aho-Corasick automaton. Whenever one of
+     * these runs is found, the rest of its constant is checked at that position. Constants without any fully specified
+     * byte can't be found that way and get checked at every position instead.
+     * The groups passed to the constructor need to outlive the matcher
+     */
+    class ConstantMatcher {
+    public:
+        using Callback = std::function<void(u64 offset, const ConstantGroup &group, const Constant &constant)>;
+
+        explicit ConstantMatcher(const std::vector<ConstantGroup> &groups);
+
+        /**
+         * @brief Finds all constants that lie entirely within the data
+         * @param callback Function called with the offset of every occurrence. Occurrences aren't reported in any particular order
+         */
+        void find(std::span<const u8> data, const Callback &callback) const;
+
+        /**
+         * @brief Finds all constants that lie entirely within a region of a provider, reading it chunk by chunk
+         * @param callback Function called with the address of every occurrence. Occurrences aren't reported in any particular order
+         */
+        void findAll(Task &task, prv::Provider *provider, Region searchRegion, const Callback &callback) const;
+
+        [[nodiscard]] u64 getMaxSize() const { return m_maxSize; }
+
+    private:
+        struct Entry {
+            const ConstantGroup *group;
+            const Constant *constant;
+
+            // Location of the fully specified bytes that were added to the automaton
+            u32 anchorOffset, anchorSize;
+        };
+
+        struct State {
+            u32 firstEdge = 0, edgeCount = 0;
+            u32 firstOutput = 0, outputCount = 0;
+
+            u32 failure = 0;
+
+            // Closest state reachable through failure links that has any outputs
+            u32 outputLink = NoState;
+        };
+
+        struct Edge {
+            u8 byte;
+            u32 target;
+        };
+
+        constexpr static u32 NoState = 0xFFFF'FFFF;
+
+        [[nodiscard]] u32 getTransition(u32 state, u8 byte) const;
+        [[nodiscard]] bool matchesAt(const Entry &entry, std::span<const u8> data, u64 offset) const;
+
+    private:
+        std::vector<Entry> m_entries;
+        std::vector<u32> m_unanchoredEntries;
+
+        std::vector<State> m_states;
+        std::vector<Edge> m_edges;
+        std::vector<u32> m_outputs;
+        std::array<u32, 256> m_rootTransitions = { };
+
+        u64 m_maxSize = 0;
+    };
+
+}
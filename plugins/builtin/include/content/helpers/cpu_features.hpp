@@ -0,0 +1,25 @@
+#pragma once
+
+#include <hex.hpp>
+
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) && !defined(__EMSCRIPTEN__)
+    #define IMHEX_X86_DISPATCH
+
+    // Builds are only allowed to use SSE2 on x86. Functions using newer instructions are compiled for them explicitly
+    // and may only be called once isSSSE3Supported() confirmed the processor can run them. MSVC allows using them anywhere
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define IMHEX_TARGET_SSSE3
+    #else
+        #define IMHEX_TARGET_SSSE3 __attribute__((target("ssse3")))
+    #endif
+#endif
+
+namespace hex::plugin::builtin {
+
+    /**
+     * @brief Checks if the processor ImHex is running on supports the SSSE3 instruction set
+     * @return True if it does, always false on anything that's not x86
+     */
+    [[nodiscard]] bool isSSSE3Supported();
+
+}
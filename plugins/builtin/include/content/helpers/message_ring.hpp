@@ -0,0 +1,100 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <span>
+
+namespace hex::plugin::builtin {
+
+    /**
+     * @brief Fixed size queue that passes messages from one producer thread to one consumer thread without any locking
+     *
+     * Messages are stored back to back in a single byte ring buffer. If the consumer doesn't keep up
+     * and the buffer runs full, new messages are dropped instead of waiting for space to become available
+     */
+    class MessageHandoff {
+    public:
+        using Callback = std::function<void(std::span<const u8> data, std::chrono::system_clock::time_point timestamp)>;
+
+        explicit MessageHandoff(size_t capacity);
+
+        /**
+         * @brief Adds a message to the queue. May only be called from the producer thread
+         * @return False if there wasn't enough space left and the message got dropped
+         */
+        bool push(std::span<const u8> data, std::chrono::system_clock::time_point timestamp);
+
+        /**
+         * @brief Calls the callback for every message that has been pushed since the last call. May only be called from the consumer thread
+         * @return Number of messages that were processed
+         */
+        size_t popAll(const Callback &callback);
+
+        [[nodiscard]] u64 getDroppedCount() const { return m_droppedCount; }
+
+    private:
+        struct Header {
+            u32 size;
+            i64 timestamp;
+        };
+
+        // Marks the rest of the buffer as unused, the next message starts at the beginning of the buffer again
+        constexpr static u32 WrapMarker = 0xFFFF'FFFF;
+
+        std::unique_ptr<u8[]> m_buffer;
+        size_t m_capacity;
+
+        // Positions only ever increase, the actual location in the buffer is the position modulo the capacity
+        alignas(64) std::atomic<u64> m_writePosition = 0;
+        alignas(64) std::atomic<u64> m_readPosition = 0;
+        std::atomic<u64> m_droppedCount = 0;
+    };
+
+    /**
+     * @brief Keeps the most recent messages in a single fixed size arena
+     *
+     * Once either the maximum number of messages or the size of the arena has been reached, the oldest messages
+     * get dropped to make space for new ones. Every message is stored in one contiguous piece and gets a sequential
+     * ID that refers to it for as long as it hasn't been dropped
+     */
+    class MessageRing {
+    public:
+        struct Message {
+            u64 id;
+            u64 position;
+            u32 size;
+            std::chrono::system_clock::time_point timestamp;
+        };
+
+        MessageRing(size_t capacity, size_t maxCount);
+
+        void push(std::span<const u8> data, std::chrono::system_clock::time_point timestamp);
+        void clear();
+
+        [[nodiscard]] size_t getCount() const { return m_messages.size(); }
+        [[nodiscard]] const Message &at(size_t index) const { return m_messages[index]; }
+
+        /**
+         * @brief Looks up a message by its ID
+         * @return The message or nullptr if it has been dropped already or doesn't exist yet
+         */
+        [[nodiscard]] const Message *find(u64 id) const;
+
+        [[nodiscard]] std::span<const u8> getData(const Message &message) const;
+
+    private:
+        std::unique_ptr<u8[]> m_arena;
+        size_t m_capacity;
+        size_t m_maxCount;
+
+        std::deque<Message> m_messages;
+        u64 m_writePosition = 0;
+        u64 m_nextId = 0;
+    };
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <hex.hpp>
+#include <hex/api/task_manager.hpp>
+#include <hex/helpers/types.hpp>
+
+#include <array>
+#include <functional>
+#include <span>
+
+namespace hex::prv {
+    class Provider;
+}
+
+namespace hex::plugin::builtin {
+
+    /**
+     * @brief Extracts strings made up of a configurable set of ASCII characters from a provider
+     *
+     * Data is classified 64 bytes at a time into bitmasks of valid characters using SIMD lookup tables and
+     * runs of valid characters are then found using bit scans. Only multi-byte UTF-8 sequences and the
+     * bytes that end a string are still looked at one at a time.
+     */
+    class StringExtractor {
+    public:
+        enum class Encoding : u8 {
+            ASCII,
+            UTF8,
+            UTF16LE,
+            UTF16BE
+        };
+
+        using Callback = std::function<void(Region string)>;
+
+        /**
+         * @param validCharacters Characters below 0x80 that may be part of a string. Bytes above that only show up in UTF-8 sequences
+         * @param minLength Minimum size of a string in bytes. Empty strings are never reported
+         * @param nullTermination Only report strings that are directly followed by a null byte
+         */
+        StringExtractor(Encoding encoding, const std::array<bool, 0x80> &validCharacters, u64 minLength, bool nullTermination);
+
+        /**
+         * @brief Finds all strings in a region. Strings never extend past the end of the region
+         * @param callback Function called with every string that was found, in ascending order
+         */
+        void extract(Task &task, prv::Provider *provider, Region region, const Callback &callback) const;
+
+        constexpr static u64 BlockSize = 64;
+
+        // Bitmasks of the valid characters, null bytes, UTF-8 lead bytes and UTF-8 continuation bytes in a block of data
+        struct Masks {
+            u64 valid, zero, lead, continuation;
+        };
+
+    private:
+        constexpr static Masks AllSet = { .valid=~u64(0), .zero=~u64(0), .lead=~u64(0), .continuation=~u64(0) };
+
+        // Classifies consecutive blocks of BlockSize bytes, one entry of blockMasks per block
+        void classify(const u8 *data, std::span<Masks> blockMasks) const;
+
+        [[nodiscard]] bool isValid(u8 byte) const { return byte < 0x80 && m_validCharacters[byte]; }
+
+    private:
+        Encoding m_encoding;
+        std::array<bool, 0x80> m_validCharacters;
+        u64 m_minLength;
+        bool m_nullTermination;
+
+        // Bit n of entry i is set if the byte (n << 4) | i is a valid character
+        std::array<u8, 16> m_lowNibbleTable = { };
+    };
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <hex.hpp>
+#include <hex/api/task_manager.hpp>
+#include <hex/helpers/utils.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <array>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace hex::plugin::builtin {
+
+    /**
+     * @brief Value scanner that finds the addresses holding a value and narrows them down over multiple passes
+     *
+     * The first scan either looks for a specific value or, if the value isn't known yet, takes a snapshot of
+     * all given regions and treats every address in them as a candidate. Every following scan only re-reads the
+     * candidates that survived so far and keeps those that match the given condition, which makes it quick to
+     * find e.g. the health counter of a running game by repeatedly scanning for values that decreased.
+     *
+     * Candidates are stored in blocks of sorted 32 bit offsets and their last seen values. Blocks are processed
+     * in parallel and independently of each other.
+     */
+    class MemoryScanner {
+    public:
+        enum class ValueType : u8 {
+            U8, U16, U32, U64,
+            I8, I16, I32, I64,
+            F32, F64
+        };
+
+        enum class Condition : u8 {
+            Equal,
+            Changed,
+            Unchanged,
+            Increased,
+            Decreased
+        };
+
+        using Value = std::array<u8, 8>;
+
+        struct Candidate {
+            u64 address;
+            Value value;
+        };
+
+        /**
+         * @brief Scans the given regions for a value
+         * @param value Value to search for or std::nullopt to treat every address as a candidate
+         */
+        void firstScan(Task &task, prv::Provider *provider, std::span<const Region> regions, ValueType type, bool aligned, const std::optional<Value> &value);
+
+        /**
+         * @brief Re-reads all remaining candidates and drops the ones that don't match the condition anymore
+         * @param value Value to compare against. Only used for Condition::Equal
+         */
+        void nextScan(Task &task, prv::Provider *provider, Condition condition, const Value &value);
+
+        void reset();
+
+        [[nodiscard]] bool hasScanned() const;
+        [[nodiscard]] u64 getCandidateCount() const;
+        [[nodiscard]] std::vector<Candidate> getCandidates(u64 maxCount) const;
+        [[nodiscard]] ValueType getValueType() const { return m_valueType; }
+
+        [[nodiscard]] static size_t getValueSize(ValueType type);
+        [[nodiscard]] static std::optional<Value> parseValue(ValueType type, const std::string &input);
+        [[nodiscard]] static std::string formatValue(ValueType type, const Value &value);
+
+    private:
+        struct CandidateBlock {
+            u64 address = 0;
+
+            // Dense blocks hold a copy of all data in the block and every step-th address in it is a candidate.
+            // Sparse blocks only hold the offsets of their candidates and one value per candidate
+            bool dense = false;
+            u32 candidateEnd = 0;
+            u32 dataSize = 0;
+
+            std::vector<u32> offsets;
+            std::vector<u8> values;
+
+            u64 candidateCount = 0;
+        };
+
+        template<typename T>
+        [[nodiscard]] CandidateBlock scanBlock(prv::Provider *provider, const CandidateBlock &block, Condition condition, const Value &value) const;
+        [[nodiscard]] CandidateBlock processBlock(prv::Provider *provider, const CandidateBlock &block, Condition condition, const Value &value) const;
+
+        /**
+         * @brief Runs a function on all blocks in parallel
+         * @return The blocks returned by the function, in the same order as the input blocks
+         */
+        [[nodiscard]] std::vector<CandidateBlock> processBlocks(Task &task, const std::vector<CandidateBlock> &blocks, const std::function<CandidateBlock(const CandidateBlock &)> &processBlock) const;
+
+        void setBlocks(std::vector<CandidateBlock> &&blocks);
+
+    private:
+        ValueType m_valueType = ValueType::U32;
+        size_t m_valueSize = 4;
+        size_t m_step = 4;
+
+        std::vector<CandidateBlock> m_blocks;
+        u64 m_candidateCount = 0;
+        bool m_scanned = false;
+
+        mutable std::shared_mutex m_mutex;
+    };
+
+}
@@ -2,6 +2,10 @@
 
 #include <content/providers/file_provider.hpp>
 
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
 namespace hex::plugin::builtin {
 
     class Base64Provider : public FileProvider {
@@ -10,18 +14,62 @@ namespace hex::plugin::builtin {
         ~Base64Provider() override = default;
 
         void readRaw(u64 offset, void *buffer, size_t size) override;
+        void readRawBatch(std::span<const ReadRequest> requests) override { Provider::readRawBatch(requests); }
+        [[nodiscard]] std::optional<ContiguousView> tryGetContiguousViewRaw(u64 offset, size_t size) override { return Provider::tryGetContiguousViewRaw(offset, size); }
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
-        [[nodiscard]] u64 getActualSize() const override { return (3 * m_file.getSize()) / 4; }
+        [[nodiscard]] u64 getActualSize() const override;
 
         void resizeRaw(u64 newSize) override;
         void insertRaw(u64 offset, u64 size) override;
         void removeRaw(u64 offset, u64 size) override;
 
+        [[nodiscard]] OpenResult open() override;
+        void close() override;
+
         std::vector<fs::ItemFilter> getValidExtensions() const override;
 
         [[nodiscard]] UnlocalizedString getTypeName() const override {
             return "hex.builtin.provider.base64";
         }
+
+    private:
+        /**
+         * @brief Makes sure the block index matches the current encoded data
+         * @note Must be called with m_mutex held
+         */
+        void ensureIndex();
+        void invalidateIndex();
+
+        /**
+         * @brief Gets the decoded data of a block, decoding it if it's not cached yet
+         * @note Must be called with m_mutex held. The returned reference is only valid until the next call
+         */
+        const std::vector<u8>& getBlock(u64 blockIndex);
+        void writeBlock(u64 blockIndex, const std::vector<u8> &data);
+
+    private:
+        struct CachedBlock {
+            u64 index;
+            std::vector<u8> data;
+        };
+
+        // Recursive since writing to the file can end up querying the size of the provider again
+        mutable std::recursive_mutex m_mutex;
+
+        /**
+         * @brief Offset of the first encoded character of every block within the file.
+         * Line breaks and other characters that aren't part of the encoding are skipped over when
+         * indexing, so blocks can be found directly even if the data isn't one continuous string of characters.
+         * The last entry is the size of the encoded data
+         */
+        std::vector<u64> m_blockOffsets;
+        bool m_indexValid = false;
+        u64 m_indexedEncodedSize = 0;
+        u64 m_decodedSize = 0;
+
+        // Recently decoded blocks, most recently used one first
+        std::list<CachedBlock> m_cache;
+        std::unordered_map<u64, std::list<CachedBlock>::iterator> m_cacheLookup;
     };
 
-}
\ No newline at end of file
+}
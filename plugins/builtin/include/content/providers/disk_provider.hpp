@@ -6,14 +6,31 @@
 #include <hex/providers/matchers/magic.hpp>
 #include <hex/providers/matchers/provider_type.hpp>
 
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
 #include <fonts/vscode_icons.hpp>
 #include <wolv/io/handle.hpp>
 
+#include <jthread.hpp>
+
 namespace hex::plugin::builtin {
 
+    /**
+     * @brief Provider for raw disks and partitions
+     *
+     * Data is read in large chunks that are aligned to the sector size of the disk. Where possible, the disk is opened a
+     * second time bypassing the page cache of the system for these reads. Chunks are read on a pool of worker threads so
+     * multiple requests can be in flight at once, and once sequential access is detected, the chunks following the one being
+     * read get requested ahead of time. This keeps operations that walk over the whole disk, e.g. hashing or searching, busy
+     * at the bandwidth of the device instead of waiting for one small read after the other.
+     */
     class DiskProvider : public prv::CachedProvider,
                          public prv::IProviderDataDescription,
                          public prv::IProviderLoadInterface,
@@ -63,6 +80,44 @@ namespace hex::plugin::builtin {
         void writeToSource(u64 offset, const void *buffer, size_t size) override;
         [[nodiscard]] u64 getSourceSize() const override;
 
+        /**
+         * @brief Reads directly from the disk, bypassing the page cache where possible
+         * @note Offset, size and buffer should be aligned to m_alignment, otherwise the read may fall back to going through the page cache
+         */
+        bool readAligned(u64 offset, void *buffer, size_t size);
+        bool writeAligned(u64 offset, const void *buffer, size_t size);
+
+    private:
+        struct AlignedDeleter {
+            size_t alignment;
+            void operator()(u8 *pointer) const { ::operator delete[](pointer, std::align_val_t(alignment)); }
+        };
+        using AlignedBuffer = std::unique_ptr<u8[], AlignedDeleter>;
+
+        [[nodiscard]] AlignedBuffer allocateAligned(size_t size) const;
+
+        struct ChunkRequest {
+            AlignedBuffer data;
+            bool demanded = false;
+            bool started = false;
+            bool done = false;
+            bool failed = false;
+        };
+
+        void startReadWorkers();
+        void stopReadWorkers();
+        void readWorker(const std::stop_token &stopToken);
+
+        /**
+         * @brief Gets the request for a chunk, queueing it if it hasn't been requested yet
+         * @param demanded Whether the chunk is needed right now or just being read ahead
+         * @return The request or nullptr if the chunk lies past the end of the disk
+         * @note m_chunkMutex needs to be held while calling this
+         */
+        std::shared_ptr<ChunkRequest> queueChunk(u64 chunkIndex, bool demanded);
+        void pruneChunks(u64 currentIndex);
+
+    protected:
         struct DriveInfo {
             std::string path;
             std::string friendlyName;
@@ -86,6 +141,25 @@ namespace hex::plugin::builtin {
 
         bool m_readable = false;
         bool m_writable = false;
+
+        #if !defined(OS_WINDOWS)
+            // Second handle to the disk that bypasses the page cache, or -1 if that's not supported
+            int m_directHandle = -1;
+        #endif
+
+        size_t m_alignment   = 0;
+        size_t m_requestSize = 0;
+        size_t m_queueDepth  = 0;
+
+        std::mutex m_chunkMutex;
+        std::condition_variable m_chunkQueued, m_chunkDone;
+        std::map<u64, std::shared_ptr<ChunkRequest>> m_chunks;
+        std::deque<u64> m_chunkQueue;
+        std::vector<std::jthread> m_readWorkers;
+        // Chunk that continues the last read, no read can continue the sequence before anything has been read at all
+        constexpr static u64 NoPreviousChunk = std::numeric_limits<u64>::max();
+        u64 m_nextSequentialChunk = NoPreviousChunk;
+        u32 m_sequentialHits = 0;
     };
 
 }
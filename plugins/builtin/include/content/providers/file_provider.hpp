@@ -1,6 +1,8 @@
 #pragma once
 
+#include <hex/api/task_manager.hpp>
 #include <hex/providers/provider.hpp>
+#include <hex/providers/piece_table.hpp>
 #include <hex/providers/matchers/mime.hpp>
 #include <hex/providers/matchers/magic.hpp>
 #include <hex/providers/matchers/filename.hpp>
@@ -8,7 +10,11 @@
 
 #include <wolv/io/file.hpp>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <string_view>
 #include <fonts/vscode_icons.hpp>
 
@@ -27,7 +33,7 @@ namespace hex::plugin::builtin {
                          > {
     public:
         FileProvider() : IProviderDataBackupable(this) {}
-        ~FileProvider() override = default;
+        ~FileProvider() override;
 
         [[nodiscard]] bool isAvailable() const override;
         [[nodiscard]] bool isReadable() const override;
@@ -36,8 +42,12 @@ namespace hex::plugin::builtin {
         [[nodiscard]] bool isSavable() const override;
 
         void resizeRaw(u64 newSize) override;
+        void insertRaw(u64 offset, u64 size) override;
+        void removeRaw(u64 offset, u64 size) override;
 
         void readRaw(u64 offset, void *buffer, size_t size) override;
+        void readRawBatch(std::span<const ReadRequest> requests) override;
+        [[nodiscard]] std::optional<ContiguousView> tryGetContiguousViewRaw(u64 offset, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
 
         [[nodiscard]] u64 getActualSize() const override;
@@ -77,18 +87,102 @@ namespace hex::plugin::builtin {
 
         OpenResult open(bool directAccess);
 
+        struct FileMapping;
+
+        void mapFile();
+        void unmapFile();
+        void updateAccessPattern(const FileMapping &mapping, u64 offset, size_t size);
+
+        void readFromFile(u64 offset, void *buffer, size_t size);
+        void applyPendingEdits();
+
+        /**
+         * @brief Writes the file with the given pieces applied to a copy next to it and replaces the original with it
+         * @return Zero on success, otherwise the system error that made saving fail. The original file is left untouched in that case
+         */
+        i32 replaceWithPieces(const std::fs::path &path, const std::vector<prv::PieceTable::Piece> &pieces, const std::vector<u8> &addedData);
+
+        /**
+         * @brief Rearranges the file's contents in place to match the given pieces
+         * @return Zero on success, otherwise the system error that made writing the file fail
+         */
+        i32 rewritePieces(const std::vector<prv::PieceTable::Piece> &pieces, const std::vector<u8> &addedData);
+
+        /**
+         * @brief Loads the file into memory in the background, chunk by chunk
+         */
+        void startLoading();
+
+        /**
+         * @brief Loads all chunks that haven't been loaded yet
+         * @param task Task to report progress to, or nullptr if the chunks should be loaded right away on the current thread
+         */
+        void loadRemainingChunks(Task *task);
+
+        /**
+         * @brief Makes sure the entire file has been loaded into memory. Needs to be called before modifying the loaded data
+         */
+        void waitUntilLoaded();
+        void readPartiallyLoaded(u64 offset, void *buffer, size_t size);
+
+        /**
+         * @brief Updates the loaded data with only the blocks of the file that changed since it was loaded
+         * @return False if the data doesn't line up with the file anymore and needs to be loaded again entirely
+         */
+        bool reloadChangedBlocks();
+        void updateBlockChecksums(u64 offset, u64 size);
+
     protected:
         wolv::io::File m_file;
         size_t m_fileSize = 0;
 
         wolv::io::ChangeTracker m_changeTracker;
         std::vector<u8> m_data;
+        ViewedBuffer m_viewedData;
         bool m_loadedIntoMemory = false;
         bool m_ignoreNextChangeEvent = false;
         bool m_changeEventAcknowledgementPending = false;
 
         std::optional<struct stat> m_fileStats;
 
+        /**
+         * @brief State of loading the file into memory. Everything below m_loadedSize is available in m_data already,
+         * reads of the rest go to the file until the background task has loaded it as well
+         */
+        TaskHolder m_loadTask;
+        std::atomic<u64> m_loadedSize = 0;
+        mutable std::shared_mutex m_loadMutex;
+        std::mutex m_finishLoadingMutex;
+
+        /**
+         * @brief Checksums of every block of the file as it was loaded, used to only reload the blocks that actually changed
+         * when the file gets modified externally. Inserts, removals and resizes make the data not line up with the file anymore
+         */
+        std::vector<u64> m_blockChecksums;
+        bool m_layoutChanged = false;
+
+        /**
+         * @brief Read-only view of the file used to serve reads in direct access mode.
+         * Reads that fall outside of the mapping fall back to regular file reads.
+         * Contiguous views handed out by the provider share ownership of the mapping, so it
+         * only gets unmapped once the last of them has been released
+         */
+        mutable std::shared_mutex m_mappingMutex;
+        std::shared_ptr<const FileMapping> m_mapping;
+
+        std::atomic<u64> m_lastReadEnd = 0;
+        std::atomic<u32> m_sequentialReadCount = 0;
+        std::atomic<u32> m_randomReadCount = 0;
+        std::atomic<bool> m_sequentialAccessAdvised = false;
+
+        /**
+         * @brief Inserts and removals done in direct access mode, together with all writes made after them.
+         * Instead of moving the rest of the file around on every edit, the file gets rewritten once when saving
+         */
+        prv::PieceTable m_pieceTable;
+        mutable std::shared_mutex m_pieceTableMutex;
+        std::atomic<bool> m_hasPendingEdits = false;
+
         bool m_readable = false, m_writable = false;
     };
 
@@ -8,14 +8,38 @@
 #include <wolv/net/socket_client.hpp>
 
 #include <array>
+#include <chrono>
 #include <mutex>
 #include <string_view>
 #include <thread>
+#include <vector>
 #include <fonts/vscode_icons.hpp>
 #include <hex/providers/cached_provider.hpp>
 
 namespace hex::plugin::builtin {
 
+    namespace gdb {
+
+        /**
+         * @brief Protocol features of a GDB server, as reported in response to qSupported
+         */
+        struct ServerFeatures {
+            // Maximum number of bytes in a packet, excluding its framing and checksum
+            size_t packetSize = 0x400;
+
+            // The server supports the 'x' packet to read memory as binary instead of hex encoded data
+            bool binaryUpload = false;
+
+            // ACKs have been turned off so requests can be pipelined
+            bool noAckMode = false;
+        };
+
+        ServerFeatures negotiateFeatures(const wolv::net::SocketClient &socket);
+        bool readMemory(const wolv::net::SocketClient &socket, const ServerFeatures &features, u64 address, void *buffer, size_t size);
+        bool writeMemory(const wolv::net::SocketClient &socket, const ServerFeatures &features, u64 address, const void *buffer, size_t size);
+
+    }
+
     class GDBProvider : public prv::CachedProvider,
                         public prv::IProviderDataDescription,
                         public prv::IProviderLoadInterface,
@@ -37,6 +61,7 @@ namespace hex::plugin::builtin {
         void readFromSource(u64 offset, void *buffer, size_t size) override;
         void writeToSource(u64 offset, const void *buffer, size_t size) override;
         [[nodiscard]] u64 getSourceSize() const override;
+        void onCacheCleared() override;
 
         void save() override;
 
@@ -70,8 +95,15 @@ namespace hex::plugin::builtin {
         std::string m_ipAddress;
         int m_port = 0;
         std::mutex m_mutex;
+        gdb::ServerFeatures m_features;
 
         u64 m_size = 0;
+
+        // Data following the last block that was read sequentially, fetched together with that block
+        u64 m_nextSequentialOffset = 0;
+        u64 m_readaheadAddress = 0;
+        std::vector<u8> m_readaheadData;
+        std::chrono::steady_clock::time_point m_readaheadTime;
     };
 
 }
@@ -4,9 +4,12 @@
 #include <hex/providers/provider.hpp>
 #include <hex/ui/widgets.hpp>
 
-#include <wolv/container/interval_tree.hpp>
 #include <wolv/utils/expected.hpp>
 
+#include <functional>
+#include <span>
+#include <string_view>
+
 namespace hex::plugin::builtin {
     struct MemoryRegion {
         Region region;
@@ -31,13 +34,12 @@ namespace hex::plugin::builtin {
         [[nodiscard]] bool isResizable() const override { return false; }
         [[nodiscard]] bool isSavable() const override { return false; }
 
-        void setBaseAddress(u64 address) override;
         void drawSidebarInterface() override;
 
         void readRaw(u64 offset, void *buffer, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
         [[nodiscard]] u64 getActualSize() const override;
-        void processMemoryRegions(wolv::util::Expected<std::map<u64, std::vector<u8>>, std::string> data);
+        [[nodiscard]] std::optional<ContiguousView> tryGetContiguousViewRaw(u64 offset, size_t size) override;
         static bool memoryRegionFilter(const std::string &search, const MemoryRegion &memoryRegion);
         OpenResult open() override;
         void close() override;
@@ -61,10 +63,67 @@ namespace hex::plugin::builtin {
 
         std::pair<Region, bool> getRegionValidity(u64 address) const override;
 
+        /**
+         * @brief A single record as it was found in the file, before any address records have been applied to it
+         */
+        struct Record {
+            u8 type;
+            u64 address;
+            u64 dataOffset;
+            u32 dataSize;
+        };
+
+        /**
+         * @brief All records parsed from one chunk of a file
+         */
+        struct RecordChunk {
+            std::vector<Record> records;
+            std::vector<u8> data;
+
+            // Set if the chunk contained something that isn't a record at all
+            bool invalid = false;
+
+            [[nodiscard]] std::span<const u8> getData(const Record &record) const {
+                return { data.data() + record.dataOffset, record.dataSize };
+            }
+        };
+
+        struct DataBlock {
+            u64 address;
+            std::span<const u8> data;
+        };
+
+        using ChunkParser = std::function<RecordChunk(std::string_view)>;
+
     protected:
+        /**
+         * @brief Splits a file into chunks at record boundaries and parses them in parallel
+         * @param startCode Character every record starts with
+         * @param parser Function parsing all records of a chunk. Throws a std::runtime_error if a record is malformed
+         * @return Parsed chunks in file order
+         */
+        static wolv::util::Expected<std::vector<RecordChunk>, std::string> parseChunks(std::string_view string, char startCode, const ChunkParser &parser);
+
+        /**
+         * @brief Builds the provider's data from all data records found in the file
+         * @note Blocks are placed in order of their address, blocks at the same address overwrite each other in the order they're passed in
+         */
+        void processMemoryRegions(std::vector<DataBlock> blocks);
+
+        struct Extent {
+            u64 address;
+            std::vector<u8> data;
+
+            [[nodiscard]] u64 getEndAddress() const { return address + data.size() - 1; }
+        };
+
+        [[nodiscard]] std::vector<Extent>::const_iterator findExtent(u64 address) const;
+
         bool m_dataValid = false;
         size_t m_dataSize = 0x00;
-        wolv::container::IntervalTree<std::vector<u8>> m_data;
+
+        // Non-overlapping data extents sorted by address. Records that directly follow each other are merged into one extent
+        std::vector<Extent> m_extents;
 
         ui::SearchableWidget<MemoryRegion> m_regionSearchWidget = ui::SearchableWidget<MemoryRegion>(memoryRegionFilter);
         std::vector<MemoryRegion> m_memoryRegions;
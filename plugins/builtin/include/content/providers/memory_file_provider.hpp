@@ -33,6 +33,7 @@ namespace hex::plugin::builtin {
         void close() override { }
 
         void readRaw(u64 offset, void *buffer, size_t size) override;
+        [[nodiscard]] std::optional<ContiguousView> tryGetContiguousViewRaw(u64 offset, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
         [[nodiscard]] u64 getActualSize() const override { return m_data.size(); }
 
@@ -64,6 +65,7 @@ namespace hex::plugin::builtin {
 
     private:
         std::vector<u8> m_data;
+        ViewedBuffer m_viewedData;
         std::string m_name;
         bool m_readOnly = false;
     };
@@ -11,10 +11,15 @@
 #include <hex/ui/widgets.hpp>
 #include <hex/helpers/utils.hpp>
 
+#include <content/memory_scanner.hpp>
+
+#include <atomic>
 #include <set>
+#include <shared_mutex>
 #include <thread>
 #include <fonts/vscode_icons.hpp>
 #include <hex/helpers/auto_reset.hpp>
+#include <hex/api/task_manager.hpp>
 
 #include <nlohmann/json.hpp>
 
@@ -63,6 +68,7 @@ namespace hex::plugin::builtin {
         [[nodiscard]] bool isDumpable() const override { return false; }
 
         void readRaw(u64 address, void *buffer, size_t size) override;
+        void readRawBatch(std::span<const ReadRequest> requests) override;
         void writeRaw(u64 address, const void *buffer, size_t size) override;
         [[nodiscard]] u64 getActualSize() const override { return 0xFFFF'FFFF'FFFF;  }
 
@@ -101,9 +107,37 @@ namespace hex::plugin::builtin {
 
             return m_selectedProcess->name;
         }
+
+        /**
+         * @brief Copies the contents of the given regions into memory in the background.
+         * Once done, reads from these regions are served from the copy instead of the process
+         */
+        void takeSnapshot(std::vector<Region> regions);
+        void discardSnapshot();
+        [[nodiscard]] bool hasSnapshot() const;
+
     private:
         void reloadProcessModules();
 
+        /**
+         * @brief Reads directly from the process. Ranges that aren't mapped in the process are skipped and read as zeros
+         */
+        void readProcessMemory(std::span<const ReadRequest> requests);
+        void drawSnapshotInterface(const std::vector<Region> &listedRegions);
+        void drawScannerInterface();
+
+        /**
+         * @brief Gets all address ranges of the process that are worth scanning, sorted and without overlaps
+         */
+        [[nodiscard]] std::vector<Region> getScanRegions() const;
+        void startScan(std::optional<MemoryScanner::Value> value, bool firstScan);
+
+        /**
+         * @brief Read-only provider that always reads from the running process, even while a snapshot is active.
+         * The value scanner reads through it since comparing against frozen values would never find any changes
+         */
+        class LiveMemoryView;
+
     private:
         struct Process {
             u32 id;
@@ -139,6 +173,29 @@ namespace hex::plugin::builtin {
 #endif
 
         bool m_enumerationFailed = false;
+
+        // Sorted, non-overlapping list of all readable address ranges of the process
+        std::vector<Region> m_readableRegions;
+        mutable std::shared_mutex m_readableRegionsMutex;
+
+        struct SnapshotRegion {
+            Region region;
+            std::vector<u8> data;
+        };
+
+        std::vector<SnapshotRegion> m_snapshot;
+        mutable std::shared_mutex m_snapshotMutex;
+        TaskHolder m_snapshotTask;
+
+        MemoryScanner m_scanner;
+        TaskHolder m_scanTask;
+        MemoryScanner::ValueType m_scanValueType = MemoryScanner::ValueType::U32;
+        MemoryScanner::Condition m_scanCondition = MemoryScanner::Condition::Equal;
+        bool m_scanAligned = true;
+        std::string m_scanInput;
+
+        std::vector<MemoryScanner::Candidate> m_scanResults;
+        std::atomic<bool> m_scanResultsOutdated = false;
     };
 
 }
@@ -3,7 +3,9 @@
 #include <hex/helpers/fmt.hpp>
 #include <hex/providers/provider.hpp>
 #include <hex/helpers/udp_server.hpp>
+#include <content/helpers/message_ring.hpp>
 #include <nlohmann/json.hpp>
+#include <memory>
 #include <mutex>
 #include <fonts/vscode_icons.hpp>
 
@@ -49,17 +51,23 @@ namespace hex::plugin::builtin {
     protected:
         void receive(std::span<const u8> data);
 
+        /**
+         * @brief Moves all messages the server thread received since the last call into the message store
+         * @note Needs to be called with m_mutex held
+         */
+        void processReceivedMessages() const;
+
     private:
         UDPServer m_udpServer;
         int m_port = 0;
+        u64 m_maxMessageCount = 100'000;
+        u64 m_maxBufferSize = 64 * 1024 * 1024;
 
-        struct Message {
-            std::vector<u8> data;
-            std::chrono::system_clock::time_point timestamp;
-        };
+        // The server thread only ever touches the handoff queue, never the message store or the mutex
+        std::unique_ptr<MessageHandoff> m_handoff;
 
         mutable std::mutex m_mutex;
-        std::vector<Message> m_messages;
+        std::unique_ptr<MessageRing> m_messages;
         u64 m_selectedMessage = 0;
     };
 
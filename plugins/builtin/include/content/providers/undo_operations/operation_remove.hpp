@@ -1,6 +1,7 @@
 #pragma once
 
 #include <hex/providers/undo_redo/operations/operation.hpp>
+#include <hex/providers/undo_redo/compact_buffer.hpp>
 
 #include <hex/helpers/fmt.hpp>
 #include <hex/helpers/utils.hpp>
@@ -15,12 +16,14 @@ namespace hex::plugin::builtin::undo {
         void undo(prv::Provider *provider) override {
             provider->insertRaw(m_offset, m_size);
 
-            provider->writeRaw(m_offset, m_removedData.data(), m_removedData.size());
+            const auto removedData = m_removedData.get();
+            provider->writeRaw(m_offset, removedData.data(), removedData.size());
         }
 
         void redo(prv::Provider *provider) override {
-            m_removedData.resize(m_size);
-            provider->readRaw(m_offset, m_removedData.data(), m_removedData.size());
+            std::vector<u8> removedData(m_size);
+            provider->readRaw(m_offset, removedData.data(), removedData.size());
+            m_removedData = prv::undo::CompactBuffer(removedData);
 
             provider->removeRaw(m_offset, m_size);
         }
@@ -39,10 +42,18 @@ namespace hex::plugin::builtin::undo {
 
         bool shouldHighlight() const override { return false; }
 
+        [[nodiscard]] size_t getMemoryUsage() const override {
+            return m_removedData.getMemoryUsage();
+        }
+
+        void offload(const std::shared_ptr<prv::undo::SpillFile> &spillFile) override {
+            m_removedData.offload(spillFile);
+        }
+
     private:
         u64 m_offset;
         u64 m_size;
-        std::vector<u8> m_removedData;
+        prv::undo::CompactBuffer m_removedData;
     };
 
 }
\ No newline at end of file
@@ -1,28 +1,71 @@
 #pragma once
 
 #include <hex/helpers/crypto.hpp>
+#include <hex/helpers/literals.hpp>
 #include <hex/providers/undo_redo/operations/operation.hpp>
+#include <hex/providers/undo_redo/compact_buffer.hpp>
 
 #include <hex/helpers/fmt.hpp>
 #include <hex/helpers/utils.hpp>
 
 #include <fonts/vscode_icons.hpp>
 
+#include <algorithm>
+
 namespace hex::plugin::builtin::undo {
 
     class OperationWrite : public prv::undo::Operation {
     public:
-        OperationWrite(u64 offset, u64 size, const u8 *oldData, const u8 *newData) :
-            m_offset(offset),
-            m_oldData(oldData, oldData + size),
-            m_newData(newData, newData + size) { }
+        OperationWrite(u64 offset, u64 size, const u8 *oldData, const u8 *newData) : m_offset(offset) {
+            this->setData({ oldData, oldData + size }, { newData, newData + size });
+        }
 
         void undo(prv::Provider *provider) override {
-            provider->writeRaw(m_offset, m_oldData.data(), m_oldData.size());
+            const auto oldData = this->getOldData();
+            provider->writeRaw(m_offset, oldData.data(), oldData.size());
         }
 
         void redo(prv::Provider *provider) override {
-            provider->writeRaw(m_offset, m_newData.data(), m_newData.size());
+            const auto newData = m_newData.get();
+            provider->writeRaw(m_offset, newData.data(), newData.size());
+        }
+
+        [[nodiscard]] bool merge(const Operation &other) override {
+            using namespace hex::literals;
+
+            // Only combine writes that overlap or directly follow each other into reasonably small operations
+            constexpr static u64 MaxMergedSize = 4_KiB;
+
+            const auto write = dynamic_cast<const OperationWrite*>(&other);
+            if (write == nullptr)
+                return false;
+
+            const auto endAddress = m_offset + m_newData.size();
+            if (write->m_offset < m_offset || write->m_offset > endAddress)
+                return false;
+
+            const auto mergedEndAddress = std::max(endAddress, write->m_offset + write->m_newData.size());
+            if (mergedEndAddress - m_offset > MaxMergedSize)
+                return false;
+
+            auto oldData = this->getOldData();
+            auto newData = m_newData.get();
+            const auto otherOldData = write->getOldData();
+            const auto otherNewData = write->m_newData.get();
+
+            // Data the other write touched that wasn't modified by this one yet still needs to be restored to its original value
+            const auto relativeOffset = write->m_offset - m_offset;
+            oldData.resize(mergedEndAddress - m_offset);
+            newData.resize(mergedEndAddress - m_offset);
+            for (size_t i = 0; i < otherNewData.size(); i += 1) {
+                if (relativeOffset + i >= endAddress - m_offset)
+                    oldData[relativeOffset + i] = otherOldData[i];
+                newData[relativeOffset + i] = otherNewData[i];
+            }
+
+            this->setData(oldData, newData);
+
+            return true;
         }
 
         [[nodiscard]] std::string format() const override {
@@ -31,7 +74,7 @@ namespace hex::plugin::builtin::undo {
 
         std::vector<std::string> formatContent() const override {
             return {
-                fmt::format("{} {} {}", hex::crypt::encode16(m_oldData), ICON_VS_ARROW_RIGHT, hex::crypt::encode16(m_newData)),
+                fmt::format("{} {} {}", hex::crypt::encode16(this->getOldData()), ICON_VS_ARROW_RIGHT, hex::crypt::encode16(m_newData.get())),
             };
         }
 
@@ -40,12 +83,41 @@ namespace hex::plugin::builtin::undo {
         }
 
         [[nodiscard]] Region getRegion() const override {
-            return { m_offset, m_oldData.size() };
+            return { m_offset, m_newData.size() };
+        }
+
+        [[nodiscard]] size_t getMemoryUsage() const override {
+            return m_newData.getMemoryUsage() + m_delta.getMemoryUsage();
+        }
+
+        void offload(const std::shared_ptr<prv::undo::SpillFile> &spillFile) override {
+            m_newData.offload(spillFile);
+            m_delta.offload(spillFile);
+        }
+
+    private:
+        void setData(const std::vector<u8> &oldData, std::vector<u8> newData) {
+            m_newData = prv::undo::CompactBuffer(newData);
+
+            // Only the difference between the old and new data is kept. Bytes that weren't changed, or changed
+            // the same way, turn into long runs that compress well
+            for (size_t i = 0; i < newData.size(); i += 1)
+                newData[i] ^= oldData[i];
+            m_delta = prv::undo::CompactBuffer(newData);
+        }
+
+        [[nodiscard]] std::vector<u8> getOldData() const {
+            auto result = m_delta.get();
+            const auto newData = m_newData.get();
+            for (size_t i = 0; i < result.size(); i += 1)
+                result[i] ^= newData[i];
+
+            return result;
         }
 
     private:
         u64 m_offset;
-        std::vector<u8> m_oldData, m_newData;
+        prv::undo::CompactBuffer m_newData, m_delta;
     };
 
 }
@@ -35,8 +35,12 @@ namespace hex::plugin::builtin {
         void insertRaw(u64 offset, u64 size) override;
         void removeRaw(u64 offset, u64 size) override;
         void read(u64 offset, void *buffer, size_t size, bool overlays = true) override;
+        void readBatch(std::span<const ReadRequest> requests, bool overlays = true) override;
         void write(u64 offset, const void *buffer, size_t size) override;
         void readRaw(u64 offset, void *buffer, size_t size) override;
+        void readRawBatch(std::span<const ReadRequest> requests) override;
+        [[nodiscard]] std::optional<ContiguousView> tryGetContiguousView(const Region &region) override;
+        [[nodiscard]] std::optional<ContiguousView> tryGetContiguousViewRaw(u64 offset, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
 
         void markDataDirty(bool dirty = true) override;
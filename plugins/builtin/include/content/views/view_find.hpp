@@ -7,6 +7,7 @@
 #include <hex/helpers/binary_pattern.hpp>
 #include <ui/widgets.hpp>
 
+#include <functional>
 #include <vector>
 
 #include <wolv/container/interval_tree.hpp>
@@ -120,7 +121,19 @@ namespace hex::plugin::builtin {
         std::string m_replaceBuffer;
 
     private:
-        static std::vector<Occurrence> searchStrings(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Strings &settings);
+        using PartitionSearch = std::function<std::vector<Occurrence>(Task &task, Region partition)>;
+        using OccurrenceFilter = std::function<bool(const Occurrence &occurrence)>;
+
+        /**
+         * @brief Splits the search region into partitions and searches them in parallel
+         * @param alignment Partitions start at multiples of this value, relative to the start of the search region
+         * @param searchPartition Function that searches a single partition. Has to return the occurrences it found in address order
+         * @return Occurrences of all partitions in address order
+         */
+        static std::vector<Occurrence> searchPartitioned(Task &task, Region searchRegion, u64 alignment, const PartitionSearch &searchPartition);
+
+        static std::vector<Occurrence> searchStrings(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Strings &settings, const OccurrenceFilter &filter = { });
+        static std::vector<Occurrence> scanStrings(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Strings &settings);
         static std::vector<Occurrence> searchSequence(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Sequence &settings);
         static std::vector<Occurrence> searchRegex(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Regex &settings);
         static std::vector<Occurrence> searchBinaryPattern(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::BinaryPattern &settings);
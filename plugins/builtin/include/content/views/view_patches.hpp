@@ -4,6 +4,14 @@
 
 #include <hex/ui/view.hpp>
 
+#include <map>
+#include <shared_mutex>
+#include <vector>
+
+namespace hex::prv::undo {
+    class Operation;
+}
+
 namespace hex::plugin::builtin {
 
     class ViewPatches : public View::Window {
@@ -15,11 +23,63 @@ namespace hex::plugin::builtin {
         void drawAlwaysVisibleContent() override;
         void drawHelpText() override;
 
+    private:
+        /**
+         * @brief Set of modified address ranges that can be updated incrementally
+         *
+         * Every range keeps track of how many operations cover it, so the region of a single operation
+         * can be removed again without affecting overlapping regions of other operations
+         */
+        class ModifiedRegions {
+        public:
+            void add(const Region &region);
+            void remove(const Region &region);
+            void clear() { m_segments.clear(); }
+
+            [[nodiscard]] bool contains(u64 address) const;
+            [[nodiscard]] bool empty() const { return m_segments.empty(); }
+
+        private:
+            struct Segment {
+                u64 endAddress;
+                u32 count;
+            };
+
+            void splitAt(u64 address);
+            void mergeAround(u64 startAddress, u64 endAddress);
+
+            std::map<u64, Segment> m_segments;
+        };
+
+        struct TrackedOperation {
+            const prv::undo::Operation *operation;
+            Region region;
+        };
+
+        /**
+         * @brief Operations whose regions are currently part of the modified regions, together with the state of the undo stack
+         * they were taken from. Comparing that state with the current one tells which single operation got added, merged, undone
+         * or redone since the last update
+         */
+        struct TrackedState {
+            std::vector<TrackedOperation> operations;
+
+            size_t appliedCount = 0, undoneCount = 0;
+            const prv::undo::Operation *lastApplied = nullptr;
+            const prv::undo::Operation *lastUndone  = nullptr;
+            bool valid = false;
+        };
+
+        void updateModifiedRegions(prv::Provider *provider);
+        void rebuildModifiedRegions(prv::Provider *provider);
+
     private:
         u64 m_selectedPatch = 0x00;
         PerProvider<u32> m_numOperations;
         PerProvider<u32> m_savedOperations;
-        PerProvider<std::set<u64>> m_modifiedAddresses;
+        std::shared_mutex m_modifiedRegionsMutex;
+        PerProvider<ModifiedRegions> m_modifiedRegions;
+        PerProvider<TrackedState> m_trackedState;
     };
 
-}
\ No newline at end of file
+}
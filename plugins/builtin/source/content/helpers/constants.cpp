@@ -1,11 +1,27 @@
 #include <content/helpers/constants.hpp>
 
+#include <hex/helpers/literals.hpp>
+#include <hex/providers/provider.hpp>
+
 #include <nlohmann/json.hpp>
 #include <wolv/io/file.hpp>
 #include <wolv/utils/string.hpp>
 
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <utility>
+
 namespace hex::plugin::builtin {
 
+    using namespace hex::literals;
+
+    namespace {
+
+        constexpr static u64 ChunkSize = 1_MiB;
+
+    }
+
     ConstantGroup::ConstantGroup(const std::fs::path &path) {
         if (!wolv::io::fs::exists(path))
             throw std::runtime_error("Path does not exist");
@@ -34,4 +50,188 @@ namespace hex::plugin::builtin {
         }
     }
 
+    ConstantMatcher::ConstantMatcher(const std::vector<ConstantGroup> &groups) {
+        // The automaton is built as a regular trie first and flattened into m_states and m_edges afterwards
+        struct Node {
+            std::vector<std::pair<u8, u32>> children;
+            std::vector<u32> outputs;
+        };
+        std::vector<Node> nodes(1);
+
+        for (const auto &group : groups) {
+            for (const auto &constant : group.getConstants()) {
+                const auto &patterns = constant.value.getPatterns();
+                if (patterns.empty())
+                    continue;
+
+                m_maxSize = std::max<u64>(m_maxSize, patterns.size());
+
+                // Use the longest run of fully specified bytes as the part that's searched for
+                u32 anchorOffset = 0, anchorSize = 0;
+                for (u32 start = 0; start < patterns.size();) {
+                    u32 end = start;
+                    while (end < patterns.size() && patterns[end].mask == 0xFF)
+                        end += 1;
+
+                    if (end - start > anchorSize) {
+                        anchorOffset = start;
+                        anchorSize   = end - start;
+                    }
+
+                    start = end + 1;
+                }
+
+                const auto entryIndex = u32(m_entries.size());
+                m_entries.push_back({ .group=&group, .constant=&constant, .anchorOffset=anchorOffset, .anchorSize=anchorSize });
+
+                if (anchorSize == 0) {
+                    m_unanchoredEntries.push_back(entryIndex);
+                    continue;
+                }
+
+                u32 node = 0;
+                for (u32 i = anchorOffset; i < anchorOffset + anchorSize; i += 1) {
+                    const u8 byte = patterns[i].value;
+
+                    const auto &children = nodes[node].children;
+                    if (auto it = std::ranges::find(children, byte, &std::pair<u8, u32>::first); it != children.end()) {
+                        node = it->second;
+                    } else {
+                        const auto child = u32(nodes.size());
+                        nodes[node].children.emplace_back(byte, child);
+                        nodes.emplace_back();
+                        node = child;
+                    }
+                }
+
+                nodes[node].outputs.push_back(entryIndex);
+            }
+        }
+
+        m_states.resize(nodes.size());
+        for (u32 index = 0; index < nodes.size(); index += 1) {
+            auto &node = nodes[index];
+            auto &state = m_states[index];
+
+            std::ranges::sort(node.children);
+
+            state.firstEdge = u32(m_edges.size());
+            state.edgeCount = u32(node.children.size());
+            for (const auto &[byte, target] : node.children)
+                m_edges.push_back({ .byte=byte, .target=target });
+
+            state.firstOutput = u32(m_outputs.size());
+            state.outputCount = u32(node.outputs.size());
+            std::ranges::copy(node.outputs, std::back_inserter(m_outputs));
+        }
+
+        for (const auto &[byte, target] : nodes.front().children)
+            m_rootTransitions[byte] = target;
+
+        // Failure links point to the state of the longest proper suffix of the current match that's also in the automaton.
+        // Processing states breadth first guarantees that the links of all shallower states are known already
+        std::deque<u32> queue;
+        for (const auto &[byte, target] : nodes.front().children)
+            queue.push_back(target);
+
+        while (!queue.empty()) {
+            const auto index = queue.front();
+            queue.pop_front();
+
+            for (const auto &[byte, target] : nodes[index].children) {
+                const auto failure = index == 0 ? 0 : this->getTransition(m_states[index].failure, byte);
+                m_states[target].failure = failure;
+                m_states[target].outputLink = m_states[failure].outputCount > 0 ? failure : m_states[failure].outputLink;
+
+                queue.push_back(target);
+            }
+        }
+    }
+
+    u32 ConstantMatcher::getTransition(u32 state, u8 byte) const {
+        while (state != 0) {
+            const auto &current = m_states[state];
+            const auto edges = std::span(m_edges).subspan(current.firstEdge, current.edgeCount);
+
+            const auto it = std::ranges::lower_bound(edges, byte, {}, &Edge::byte);
+            if (it != edges.end() && it->byte == byte)
+                return it->target;
+
+            state = current.failure;
+        }
+
+        return m_rootTransitions[byte];
+    }
+
+    bool ConstantMatcher::matchesAt(const Entry &entry, std::span<const u8> data, u64 offset) const {
+        const auto &patterns = entry.constant->value.getPatterns();
+        if (offset + patterns.size() > data.size())
+            return false;
+
+        // Fully specified bytes are already known to match
+        if (entry.anchorSize == patterns.size())
+            return true;
+
+        for (u64 i = 0; i < patterns.size(); i += 1) {
+            if ((data[offset + i] & patterns[i].mask) != patterns[i].value)
+                return false;
+        }
+
+        return true;
+    }
+
+    void ConstantMatcher::find(std::span<const u8> data, const Callback &callback) const {
+        for (const auto entryIndex : m_unanchoredEntries) {
+            const auto &entry = m_entries[entryIndex];
+            for (u64 offset = 0; offset + entry.constant->value.getSize() <= data.size(); offset += 1) {
+                if (this->matchesAt(entry, data, offset))
+                    callback(offset, *entry.group, *entry.constant);
+            }
+        }
+
+        u32 state = 0;
+        for (u64 i = 0; i < data.size(); i += 1) {
+            state = this->getTransition(state, data[i]);
+
+            // Every state along the output links ends in a match of at least one anchor
+            for (u32 output = m_states[state].outputCount > 0 ? state : m_states[state].outputLink; output != NoState; output = m_states[output].outputLink) {
+                const auto &outputState = m_states[output];
+                for (u32 j = outputState.firstOutput; j < outputState.firstOutput + outputState.outputCount; j += 1) {
+                    const auto &entry = m_entries[m_outputs[j]];
+
+                    const auto anchorEnd = i + 1;
+                    if (anchorEnd < entry.anchorOffset + entry.anchorSize)
+                        continue;
+
+                    const auto offset = anchorEnd - entry.anchorSize - entry.anchorOffset;
+                    if (this->matchesAt(entry, data, offset))
+                        callback(offset, *entry.group, *entry.constant);
+                }
+            }
+        }
+    }
+
+    void ConstantMatcher::findAll(Task &task, prv::Provider *provider, Region searchRegion, const Callback &callback) const {
+        if (m_maxSize == 0 || searchRegion.getSize() == 0)
+            return;
+
+        // Chunks overlap by the size of the largest constant so constants crossing a chunk boundary are found too
+        std::vector<u8> buffer(ChunkSize + m_maxSize - 1);
+        for (u64 offset = 0; offset < searchRegion.getSize(); offset += ChunkSize) {
+            task.update(offset);
+
+            const auto readSize = std::min<u64>(buffer.size(), searchRegion.getSize() - offset);
+            const bool lastChunk = offset + ChunkSize >= searchRegion.getSize();
+            provider->read(searchRegion.getStartAddress() + offset, buffer.data(), readSize);
+
+            this->find(std::span(buffer).first(readSize), [&](u64 matchOffset, const ConstantGroup &group, const Constant &constant) {
+                // Occurrences starting in the overlap get found again by the next chunk
+                if (!lastChunk && matchOffset >= ChunkSize)
+                    return;
+
+                callback(searchRegion.getStartAddress() + offset + matchOffset, group, constant);
+            });
+        }
+    }
+
 }
@@ -0,0 +1,30 @@
+#include <content/helpers/cpu_features.hpp>
+
+#if defined(IMHEX_X86_DISPATCH) && defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace hex::plugin::builtin {
+
+    bool isSSSE3Supported() {
+        #if defined(__SSSE3__)
+            return true;
+        #elif defined(IMHEX_X86_DISPATCH) && defined(_MSC_VER) && !defined(__clang__)
+            static const bool supported = [] {
+                int info[4] = { };
+                __cpuid(info, 1);
+
+                return (info[2] & (1 << 9)) != 0;
+            }();
+
+            return supported;
+        #elif defined(IMHEX_X86_DISPATCH)
+            static const bool supported = __builtin_cpu_supports("ssse3");
+
+            return supported;
+        #else
+            return false;
+        #endif
+    }
+
+}
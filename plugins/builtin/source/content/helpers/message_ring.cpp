@@ -0,0 +1,123 @@
+#include <content/helpers/message_ring.hpp>
+
+#include <hex/helpers/utils.hpp>
+
+#include <cstring>
+
+namespace hex::plugin::builtin {
+
+    MessageHandoff::MessageHandoff(size_t capacity)
+        : m_buffer(std::make_unique_for_overwrite<u8[]>(hex::alignTo<size_t>(capacity, alignof(Header)))),
+          m_capacity(hex::alignTo<size_t>(capacity, alignof(Header))) { }
+
+    bool MessageHandoff::push(std::span<const u8> data, std::chrono::system_clock::time_point timestamp) {
+        const auto recordSize = hex::alignTo<size_t>(sizeof(Header) + data.size(), alignof(Header));
+
+        auto writePosition = m_writePosition.load(std::memory_order_relaxed);
+        const auto readPosition = m_readPosition.load(std::memory_order_acquire);
+
+        // Records never wrap around, if there's not enough space left at the end of the buffer, the record is placed at its start
+        const auto offset    = writePosition % m_capacity;
+        const auto remaining = m_capacity - offset;
+        const auto padding   = remaining < recordSize ? remaining : 0;
+
+        if (writePosition + padding + recordSize - readPosition > m_capacity) {
+            m_droppedCount += 1;
+            return false;
+        }
+
+        if (padding > 0) {
+            if (remaining >= sizeof(Header)) {
+                const Header marker = { .size=WrapMarker, .timestamp=0 };
+                std::memcpy(m_buffer.get() + offset, &marker, sizeof(marker));
+            }
+
+            writePosition += padding;
+        }
+
+        const Header header = { .size=u32(data.size()), .timestamp=timestamp.time_since_epoch().count() };
+        u8 *record = m_buffer.get() + writePosition % m_capacity;
+        std::memcpy(record, &header, sizeof(header));
+        std::memcpy(record + sizeof(header), data.data(), data.size());
+
+        m_writePosition.store(writePosition + recordSize, std::memory_order_release);
+
+        return true;
+    }
+
+    size_t MessageHandoff::popAll(const Callback &callback) {
+        auto readPosition = m_readPosition.load(std::memory_order_relaxed);
+        const auto writePosition = m_writePosition.load(std::memory_order_acquire);
+
+        size_t count = 0;
+        while (readPosition != writePosition) {
+            const auto offset    = readPosition % m_capacity;
+            const auto remaining = m_capacity - offset;
+
+            Header header = { .size=WrapMarker, .timestamp=0 };
+            if (remaining >= sizeof(Header))
+                std::memcpy(&header, m_buffer.get() + offset, sizeof(header));
+
+            if (header.size == WrapMarker) {
+                readPosition += remaining;
+                continue;
+            }
+
+            const auto timestamp = std::chrono::system_clock::time_point(std::chrono::system_clock::duration(header.timestamp));
+            callback({ m_buffer.get() + offset + sizeof(Header), header.size }, timestamp);
+
+            readPosition += hex::alignTo<size_t>(sizeof(Header) + header.size, alignof(Header));
+            count += 1;
+        }
+
+        m_readPosition.store(readPosition, std::memory_order_release);
+
+        return count;
+    }
+
+
+    MessageRing::MessageRing(size_t capacity, size_t maxCount)
+        : m_arena(std::make_unique_for_overwrite<u8[]>(capacity)), m_capacity(capacity), m_maxCount(maxCount) { }
+
+    void MessageRing::push(std::span<const u8> data, std::chrono::system_clock::time_point timestamp) {
+        if (data.size() > m_capacity || m_maxCount == 0)
+            return;
+
+        // Messages are always stored in one piece, so if one doesn't fit at the end of the arena anymore, it goes to its start instead
+        auto position = m_writePosition;
+        const auto remaining = m_capacity - position % m_capacity;
+        if (remaining < data.size())
+            position += remaining;
+
+        while (!m_messages.empty() && (m_messages.size() >= m_maxCount || position + data.size() - m_messages.front().position > m_capacity))
+            m_messages.pop_front();
+
+        std::memcpy(m_arena.get() + position % m_capacity, data.data(), data.size());
+        m_messages.push_back({ .id=m_nextId, .position=position, .size=u32(data.size()), .timestamp=timestamp });
+
+        m_nextId += 1;
+        m_writePosition = position + data.size();
+    }
+
+    void MessageRing::clear() {
+        m_messages.clear();
+        m_writePosition = 0;
+    }
+
+    const MessageRing::Message *MessageRing::find(u64 id) const {
+        if (m_messages.empty() || id < m_messages.front().id)
+            return nullptr;
+
+        // IDs are sequential, so the index of a message follows directly from its ID
+        const auto index = id - m_messages.front().id;
+        if (index >= m_messages.size())
+            return nullptr;
+
+        return &m_messages[index];
+    }
+
+    std::span<const u8> MessageRing::getData(const Message &message) const {
+        return { m_arena.get() + message.position % m_capacity, message.size };
+    }
+
+}
@@ -0,0 +1,439 @@
+#include <content/helpers/string_extractor.hpp>
+#include <content/helpers/cpu_features.hpp>
+
+#include <hex/providers/provider.hpp>
+
+#include <wolv/literals.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <span>
+#include <vector>
+
+#if defined(IMHEX_X86_DISPATCH)
+    #include <immintrin.h>
+
+    #if defined(__AVX2__)
+        #define STRINGS_VECTOR_AVX2
+    #else
+        #define STRINGS_VECTOR_SSSE3
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define STRINGS_VECTOR_NEON
+#endif
+
+namespace hex::plugin::builtin {
+
+    using namespace wolv::literals;
+
+    namespace {
+
+        // Amount of data read from the provider and classified at once
+        constexpr static u64 ChunkSize = 1_MiB;
+        constexpr static u64 BlockSize = StringExtractor::BlockSize;
+
+        // Maximum number of bytes checked ahead when skipping over strings that are too short to be reported
+        constexpr static u64 RunFilterLength = 16;
+
+        constexpr static u64 EvenBits = 0x5555'5555'5555'5555;
+        constexpr static u64 OddBits  = ~EvenBits;
+
+        // Bit n of entry i is set for every high nibble i below 8, the valid character table holds the low nibbles
+        constexpr static std::array<u8, 16> HighNibbleTable = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+        /**
+         * @brief Finds the first set bit at or after a position in a bitmask that's generated block by block
+         * @return Position of the bit or end if there is none before it
+         */
+        u64 findFirstSet(u64 position, u64 end, const auto &getBlockMask) {
+            while (position < end) {
+                const u64 mask = getBlockMask(position / BlockSize) >> (position % BlockSize);
+                if (mask != 0)
+                    return std::min<u64>(position + std::countr_zero(mask), end);
+
+                position = (position / BlockSize + 1) * BlockSize;
+            }
+
+            return end;
+        }
+
+        // A byte is a valid character if the bit of its high nibble is set in the table entry of its low nibble.
+        // Bytes between 0xC0 and 0xF7 are UTF-8 lead bytes, which is checked by offsetting them to start at zero
+
+        #if defined(STRINGS_VECTOR_AVX2)
+
+            void classifyAVX2(const u8 *data, std::span<StringExtractor::Masks> blockMasks, const std::array<u8, 16> &lowNibbleTable) {
+                const auto lowTable  = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lowNibbleTable.data())));
+                const auto highTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(HighNibbleTable.data())));
+                const auto nibbleMask = _mm256_set1_epi8(0x0F);
+                const auto zero = _mm256_setzero_si256();
+
+                for (auto &masks : blockMasks) {
+                    masks = { };
+                    for (u32 i = 0; i < BlockSize; i += 32) {
+                        const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+                        const auto low  = _mm256_and_si256(bytes, nibbleMask);
+                        const auto high = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibbleMask);
+                        const auto valid = _mm256_and_si256(_mm256_shuffle_epi8(lowTable, low), _mm256_shuffle_epi8(highTable, high));
+
+                        const auto leadOffset = _mm256_sub_epi8(bytes, _mm256_set1_epi8(char(0xC0)));
+                        const auto lead = _mm256_cmpeq_epi8(_mm256_min_epu8(leadOffset, _mm256_set1_epi8(0x37)), leadOffset);
+                        const auto continuation = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, _mm256_set1_epi8(char(0xC0))), _mm256_set1_epi8(char(0x80)));
+
+                        masks.valid |= u64(~u32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(valid, zero)))) << i;
+                        masks.zero  |= u64(u32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, zero)))) << i;
+                        masks.lead  |= u64(u32(_mm256_movemask_epi8(lead))) << i;
+                        masks.continuation |= u64(u32(_mm256_movemask_epi8(continuation))) << i;
+                    }
+
+                    data += BlockSize;
+                }
+            }
+
+        #elif defined(STRINGS_VECTOR_SSSE3)
+
+            IMHEX_TARGET_SSSE3 void classifySSSE3(const u8 *data, std::span<StringExtractor::Masks> blockMasks, const std::array<u8, 16> &lowNibbleTable) {
+                const auto lowTable  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lowNibbleTable.data()));
+                const auto highTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HighNibbleTable.data()));
+                const auto nibbleMask = _mm_set1_epi8(0x0F);
+                const auto zero = _mm_setzero_si128();
+
+                for (auto &masks : blockMasks) {
+                    masks = { };
+                    for (u32 i = 0; i < BlockSize; i += 16) {
+                        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+                        const auto low  = _mm_and_si128(bytes, nibbleMask);
+                        const auto high = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibbleMask);
+                        const auto valid = _mm_and_si128(_mm_shuffle_epi8(lowTable, low), _mm_shuffle_epi8(highTable, high));
+
+                        const auto leadOffset = _mm_sub_epi8(bytes, _mm_set1_epi8(char(0xC0)));
+                        const auto lead = _mm_cmpeq_epi8(_mm_min_epu8(leadOffset, _mm_set1_epi8(0x37)), leadOffset);
+                        const auto continuation = _mm_cmpeq_epi8(_mm_and_si128(bytes, _mm_set1_epi8(char(0xC0))), _mm_set1_epi8(char(0x80)));
+
+                        masks.valid |= u64(~u32(_mm_movemask_epi8(_mm_cmpeq_epi8(valid, zero))) & 0xFFFF) << i;
+                        masks.zero  |= u64(u32(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero)))) << i;
+                        masks.lead  |= u64(u32(_mm_movemask_epi8(lead))) << i;
+                        masks.continuation |= u64(u32(_mm_movemask_epi8(continuation))) << i;
+                    }
+
+                    data += BlockSize;
+                }
+            }
+
+        #elif defined(STRINGS_VECTOR_NEON)
+
+            // NEON has no movemask instruction, so the lanes get weighted by their bit and added up pairwise instead
+            u64 toBitmask(uint8x16_t mask0, uint8x16_t mask1, uint8x16_t mask2, uint8x16_t mask3) {
+                const uint8x16_t weights = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+
+                const auto sum0 = vpaddq_u8(vandq_u8(mask0, weights), vandq_u8(mask1, weights));
+                const auto sum1 = vpaddq_u8(vandq_u8(mask2, weights), vandq_u8(mask3, weights));
+                const auto sum  = vpaddq_u8(sum0, sum1);
+
+                return vgetq_lane_u64(vreinterpretq_u64_u8(vpaddq_u8(sum, sum)), 0);
+            }
+
+            void classifyNEON(const u8 *data, std::span<StringExtractor::Masks> blockMasks, const std::array<u8, 16> &lowNibbleTable) {
+                const auto lowTable  = vld1q_u8(lowNibbleTable.data());
+                const auto highTable = vld1q_u8(HighNibbleTable.data());
+
+                for (auto &masks : blockMasks) {
+                    std::array<uint8x16_t, 4> valid, zero, lead, continuation;
+                    for (u32 i = 0; i < 4; i += 1) {
+                        const auto bytes = vld1q_u8(data + i * 16);
+
+                        valid[i] = vtstq_u8(vqtbl1q_u8(lowTable, vandq_u8(bytes, vdupq_n_u8(0x0F))), vqtbl1q_u8(highTable, vshrq_n_u8(bytes, 4)));
+                        zero[i]  = vceqq_u8(bytes, vdupq_n_u8(0x00));
+                        lead[i]  = vcleq_u8(vsubq_u8(bytes, vdupq_n_u8(0xC0)), vdupq_n_u8(0x37));
+                        continuation[i] = vceqq_u8(vandq_u8(bytes, vdupq_n_u8(0xC0)), vdupq_n_u8(0x80));
+                    }
+
+                    masks = {
+                        .valid = toBitmask(valid[0], valid[1], valid[2], valid[3]),
+                        .zero  = toBitmask(zero[0], zero[1], zero[2], zero[3]),
+                        .lead  = toBitmask(lead[0], lead[1], lead[2], lead[3]),
+                        .continuation = toBitmask(continuation[0], continuation[1], continuation[2], continuation[3])
+                    };
+
+                    data += BlockSize;
+                }
+            }
+
+        #endif
+
+    }
+
+    StringExtractor::StringExtractor(Encoding encoding, const std::array<bool, 0x80> &validCharacters, u64 minLength, bool nullTermination)
+        : m_encoding(encoding), m_validCharacters(validCharacters), m_minLength(std::max<u64>(minLength, 1)), m_nullTermination(nullTermination) {
+        for (u32 byte = 0x00; byte < 0x80; byte += 1) {
+            if (m_validCharacters[byte])
+                m_lowNibbleTable[byte & 0x0F] |= u8(1 << (byte >> 4));
+        }
+    }
+
+    void StringExtractor::classify(const u8 *data, std::span<Masks> blockMasks) const {
+        #if defined(STRINGS_VECTOR_AVX2)
+            classifyAVX2(data, blockMasks, m_lowNibbleTable);
+        #elif defined(STRINGS_VECTOR_NEON)
+            classifyNEON(data, blockMasks, m_lowNibbleTable);
+        #else
+            // Release builds only target SSE2, which has no byte shuffle to look the characters up with. Nearly every x86 processor supports SSSE3 though
+            #if defined(STRINGS_VECTOR_SSSE3)
+                if (isSSSE3Supported()) {
+                    classifySSSE3(data, blockMasks, m_lowNibbleTable);
+                    return;
+                }
+            #endif
+
+            for (auto &masks : blockMasks) {
+                masks = { };
+                for (u32 i = 0; i < BlockSize; i += 1) {
+                    const u8 byte = data[i];
+
+                    masks.valid |= u64(this->isValid(byte)) << i;
+                    masks.zero  |= u64(byte == 0x00) << i;
+                    masks.lead  |= u64(byte >= 0xC0 && byte <= 0xF7) << i;
+                    masks.continuation |= u64((byte & 0xC0) == 0x80) << i;
+                }
+
+                data += BlockSize;
+            }
+        #endif
+    }
+
+    void StringExtractor::extract(Task &task, prv::Provider *provider, Region region, const Callback &callback) const {
+        using enum Encoding;
+
+        if (region.getSize() == 0)
+            return;
+
+        std::vector<u8> buffer(ChunkSize);
+        std::vector<Masks> blockMasks(ChunkSize / BlockSize);
+
+        // State of the string that's currently being read. It's carried over from one chunk to the next
+        u64 stringStart = region.getStartAddress();
+        u64 length = 0;
+        u8 remainingContinuationBytes = 0;
+
+        const auto endString = [&](u64 address, u8 terminator) {
+            if (length >= m_minLength && (!m_nullTermination || terminator == 0x00))
+                callback(Region { .address=stringStart, .size=length });
+
+            stringStart = address + 1;
+            length = 0;
+        };
+
+        // Decides whether a single byte continues the current string. This covers every case, the bitmasks are only used to skip over the common ones quickly
+        const auto continuesString = [&](u8 byte) -> bool {
+            switch (m_encoding) {
+                case UTF16LE:
+                    return length % 2 == 1 ? byte == 0x00 : this->isValid(byte);
+                case UTF16BE:
+                    return length % 2 == 0 ? byte == 0x00 : this->isValid(byte);
+                case UTF8:
+                    if (remainingContinuationBytes > 0) {
+                        if ((byte & 0b1100'0000) == 0b1000'0000) {
+                            remainingContinuationBytes -= 1;
+                            return true;
+                        }
+
+                        remainingContinuationBytes = 0;
+                        return false;
+                    }
+
+                    if (byte <= 0x7F)
+                        return this->isValid(byte);
+
+                    if ((byte & 0b1110'0000) == 0b1100'0000) {
+                        // 2-byte start (U+80..U+7FF), excluding the overlong encodings 0xC0 and 0xC1
+                        remainingContinuationBytes = 1;
+                        return byte >= 0xC2;
+                    } else if ((byte & 0b1111'0000) == 0b1110'0000) {
+                        // 3-byte start (U+800..U+FFFF). E0 must be followed by >= 0xA0, ED must be <= 0x9F (avoid surrogates)
+                        remainingContinuationBytes = 2;
+                        return byte != 0xE0 && byte != 0xED;
+                    } else if ((byte & 0b1111'1000) == 0b1111'0000) {
+                        // 4-byte start (U+10000..U+10FFFF), rejecting anything above U+10FFFF
+                        remainingContinuationBytes = 3;
+                        return byte <= 0xF4;
+                    }
+
+                    return false;
+                case ASCII:
+                default:
+                    return this->isValid(byte);
+            }
+        };
+
+        u8 lastByte = 0x00;
+        for (u64 offset = 0; offset < region.getSize(); offset += ChunkSize) {
+            const auto chunkAddress = region.getStartAddress() + offset;
+            task.update(offset);
+
+            const auto size = std::min<u64>(ChunkSize, region.getSize() - offset);
+            provider->read(chunkAddress, buffer.data(), size);
+
+            // Pad the last block with null bytes so it can be classified in one piece. Its bits past the end of the chunk get overridden below
+            const auto blockCount = (size + BlockSize - 1) / BlockSize;
+            std::fill(buffer.begin() + size, buffer.begin() + blockCount * BlockSize, 0x00);
+            this->classify(buffer.data(), std::span(blockMasks).first(blockCount));
+
+            // Bytes that can be part of a string at all. Any other byte ends the current string no matter which byte was expected next
+            const auto getMemberMask = [&](u64 block) {
+                const auto &masks = blockMasks[block];
+                switch (m_encoding) {
+                    case UTF8:      return masks.valid | masks.lead | masks.continuation;
+                    case UTF16LE:
+                    case UTF16BE:   return masks.valid | masks.zero;
+                    default:        return masks.valid;
+                }
+            };
+
+            // Masks of a block where everything past the end of the chunk is set. Strings continuing in another chunk are therefore never skipped
+            const auto getMasks = [&](u64 block) -> Masks {
+                if (block >= blockCount)
+                    return AllSet;
+
+                auto masks = blockMasks[block];
+                if (block == blockCount - 1 && size % BlockSize != 0) {
+                    const auto padding = ~u64(0) << (size % BlockSize);
+                    masks.valid |= padding;
+                    masks.zero  |= padding;
+                    masks.lead  |= padding;
+                    masks.continuation |= padding;
+                }
+
+                return masks;
+            };
+
+            // Bytes that follow the pattern of a string whose characters are at even or at odd positions
+            const auto getPatternMask = [&](u64 block, bool characterAtEvenPosition) {
+                const auto masks = getMasks(block);
+                switch (m_encoding) {
+                    case UTF16LE:
+                    case UTF16BE: {
+                        const auto characterBits = characterAtEvenPosition ? EvenBits : OddBits;
+                        return (masks.valid & characterBits) | (masks.zero & ~characterBits);
+                    }
+                    case UTF8: {
+                        // Inside of a string, lead bytes are always followed by a continuation byte and continuation bytes always follow one of the two
+                        const auto previous = block == 0 ? AllSet : getMasks(block - 1);
+                        const auto next = getMasks(block + 1);
+
+                        const auto continuationFollows = (masks.continuation >> 1) | (next.continuation << (BlockSize - 1));
+                        const auto sequenceBefore = ((masks.lead | masks.continuation) << 1) | ((previous.lead | previous.continuation) >> (BlockSize - 1));
+
+                        return masks.valid | (masks.lead & continuationFollows) | (masks.continuation & sequenceBefore);
+                    }
+                    default:
+                        return masks.valid;
+                }
+            };
+
+            // Positions where a pattern of at least RunFilterLength bytes starts. Strings shorter than that are never reported.
+            // The last byte of a UTF-8 string may be a lead byte whose sequence got cut off, so it's left out of the pattern
+            const auto filterLength = std::min<u64>(m_minLength, RunFilterLength) - (m_encoding == UTF8 ? 1 : 0);
+            const auto getLongRunMask = [&](u64 block) {
+                if (filterLength == 0)
+                    return getMemberMask(block);
+
+                const auto getRuns = [&](bool characterAtEvenPosition) {
+                    const auto current = getPatternMask(block, characterAtEvenPosition);
+                    const auto next    = getPatternMask(block + 1, characterAtEvenPosition);
+
+                    u64 runs = current;
+                    for (u64 shift = 1; shift < filterLength; shift += 1)
+                        runs &= (current >> shift) | (next << (BlockSize - shift));
+
+                    return runs;
+                };
+
+                switch (m_encoding) {
+                    case UTF16LE:   return (getRuns(true) & EvenBits) | (getRuns(false) & OddBits);
+                    case UTF16BE:   return (getRuns(false) & EvenBits) | (getRuns(true) & OddBits);
+                    default:        return getRuns(true);
+                }
+            };
+
+            const auto isSet = [&](u64 position, const auto &getBlockMask) {
+                return ((getBlockMask(position / BlockSize) >> (position % BlockSize)) & 1) != 0;
+            };
+
+            // Whether the parser is back in its initial state at a position, no matter in which state it was before. That's the case after
+            // any byte that can't be part of a string and after two bytes that can never both continue a UTF-16 string either
+            const auto isResetPoint = [&](u64 position, u64 lowerBound) {
+                if (!isSet(position - 1, getMemberMask))
+                    return true;
+                if (position - lowerBound < 2)
+                    return false;
+
+                const auto getZeroMask  = [&](u64 block) { return blockMasks[block].zero; };
+                const auto getValidMask = [&](u64 block) { return blockMasks[block].valid; };
+                switch (m_encoding) {
+                    case UTF16LE:   return isSet(position - 1, getZeroMask) && isSet(position - 2, getZeroMask);
+                    case UTF16BE:   return isSet(position - 1, getValidMask) && isSet(position - 2, getValidMask);
+                    default:        return false;
+                }
+            };
+
+            u64 position = 0, skipBlockedUntil = 0;
+            while (position < size) {
+                // Strings that can't reach the minimum length are skipped all at once. Every string that starts before the next long run
+                // is too short to be reported, so parsing can continue from the last position before it where the parser is known to be reset
+                if (length == 0 && remainingContinuationBytes == 0 && position >= skipBlockedUntil) {
+                    const auto candidate = findFirstSet(position, size, getLongRunMask);
+                    if (candidate == size)
+                        break;
+
+                    auto start = candidate;
+                    while (start > position && !isResetPoint(start, position))
+                        start -= 1;
+
+                    position = start;
+                    stringStart = chunkAddress + position;
+
+                    // Everything up to the candidate needs to be parsed normally, otherwise the same candidate would be found over and over again
+                    skipBlockedUntil = candidate + 1;
+                }
+
+                // Outside of multi-byte UTF-8 sequences, strings continue for as long as the bytes alternate the same way
+                if (remainingContinuationBytes == 0) {
+                    const bool characterAtEvenPosition = ((position - length) % 2 == 0) == (m_encoding != UTF16BE);
+
+                    const auto runEnd = findFirstSet(position, size, [&](u64 block) {
+                        const auto &masks = blockMasks[block];
+                        if (m_encoding == UTF16LE || m_encoding == UTF16BE) {
+                            const auto characterBits = characterAtEvenPosition ? EvenBits : OddBits;
+                            return ~((masks.valid & characterBits) | (masks.zero & ~characterBits));
+                        }
+
+                        return ~masks.valid;
+                    });
+
+                    length += runEnd - position;
+                    position = runEnd;
+                    if (position == size)
+                        break;
+                }
+
+                const u8 byte = buffer[position];
+                if (continuesString(byte))
+                    length += 1;
+                else
+                    endString(chunkAddress + position, byte);
+
+                position += 1;
+            }
+
+            lastByte = buffer[size - 1];
+        }
+
+        // A string that runs up to the end of the region ends with its own last byte
+        if (length > 0)
+            endString(region.getEndAddress(), lastByte);
+    }
+
+}
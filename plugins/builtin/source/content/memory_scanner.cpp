@@ -0,0 +1,385 @@
+#include <content/memory_scanner.hpp>
+
+#include <hex/helpers/fmt.hpp>
+
+#include <wolv/literals.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace hex::plugin::builtin {
+
+    using namespace wolv::literals;
+    using namespace std::chrono_literals;
+
+    namespace {
+
+        // Size of the address range covered by a single candidate block. Offsets inside of a block need to fit into 32 bits
+        constexpr static u64 BlockSize = 16_MiB;
+
+        // Sparse candidates get re-read with a single read of their whole range if they're on average
+        // at most this many bytes apart. Otherwise, they're read individually in one batch
+        constexpr static u64 MaxAverageCandidateDistance = 64;
+
+        template<typename T>
+        T load(const u8 *data) {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+
+            return value;
+        }
+
+        template<typename T>
+        bool matches(MemoryScanner::Condition condition, const u8 *current, const u8 *previous, T target) {
+            switch (condition) {
+                using enum MemoryScanner::Condition;
+
+                case Equal:     return load<T>(current) == target;
+                case Changed:   return std::memcmp(current, previous, sizeof(T)) != 0;
+                case Unchanged: return std::memcmp(current, previous, sizeof(T)) == 0;
+                case Increased: return load<T>(current) > load<T>(previous);
+                case Decreased: return load<T>(current) < load<T>(previous);
+            }
+
+            return false;
+        }
+
+        decltype(auto) visitValueType(MemoryScanner::ValueType type, auto &&function) {
+            switch (type) {
+                using enum MemoryScanner::ValueType;
+
+                case U16:   return function(std::type_identity<u16>());
+                case U32:   return function(std::type_identity<u32>());
+                case U64:   return function(std::type_identity<u64>());
+                case I8:    return function(std::type_identity<i8>());
+                case I16:   return function(std::type_identity<i16>());
+                case I32:   return function(std::type_identity<i32>());
+                case I64:   return function(std::type_identity<i64>());
+                case F32:   return function(std::type_identity<float>());
+                case F64:   return function(std::type_identity<double>());
+                case U8:
+                default:    return function(std::type_identity<u8>());
+            }
+        }
+
+        template<typename Type, typename StorageType>
+        std::optional<MemoryScanner::Value> parseNumericValue(const std::string &string) {
+            StorageType value;
+
+            std::size_t processed = 0;
+            try {
+                if constexpr (std::floating_point<Type>)
+                    value = std::stod(string, &processed);
+                else if constexpr (std::signed_integral<Type>)
+                    value = std::stoll(string, &processed, 0);
+                else
+                    value = std::stoull(string, &processed, 0);
+            } catch (std::exception &) {
+                return std::nullopt;
+            }
+
+            if (processed != string.size())
+                return std::nullopt;
+
+            if (value < std::numeric_limits<Type>::lowest() || value > std::numeric_limits<Type>::max())
+                return std::nullopt;
+
+            const auto typedValue = Type(value);
+
+            MemoryScanner::Value result = { };
+            std::memcpy(result.data(), &typedValue, sizeof(Type));
+
+            return result;
+        }
+
+        u64 getDenseCandidateCount(u64 candidateEnd, u64 dataSize, size_t valueSize, size_t step) {
+            if (candidateEnd == 0 || dataSize < valueSize)
+                return 0;
+
+            const auto lastOffset = std::min<u64>(candidateEnd - 1, dataSize - valueSize);
+            return lastOffset / step + 1;
+        }
+
+    }
+
+    void MemoryScanner::firstScan(Task &task, prv::Provider *provider, std::span<const Region> regions, ValueType type, bool aligned, const std::optional<Value> &value) {
+        {
+            std::unique_lock lock(m_mutex);
+
+            // Candidates of a previous scan are only valid for the old value type
+            m_blocks.clear();
+            m_candidateCount = 0;
+            m_scanned = false;
+
+            m_valueType = type;
+            m_valueSize = getValueSize(type);
+            m_step      = aligned ? m_valueSize : 1;
+        }
+
+        // Split all regions into blocks that initially have every address in them as a candidate
+        std::vector<CandidateBlock> blocks;
+        for (const auto &region : regions) {
+            const auto regionEnd = region.getStartAddress() + region.getSize();
+
+            auto address = region.getStartAddress();
+            if (aligned && address % m_valueSize != 0)
+                address += m_valueSize - address % m_valueSize;
+
+            for (; address < regionEnd; address += BlockSize) {
+                CandidateBlock block;
+                block.address      = address;
+                block.dense        = true;
+                block.candidateEnd = u32(std::min<u64>(BlockSize, regionEnd - address));
+
+                // Values starting near the end of the block extend into the next one
+                block.dataSize     = u32(std::min<u64>(BlockSize + m_valueSize - 1, regionEnd - address));
+                block.candidateCount = getDenseCandidateCount(block.candidateEnd, block.dataSize, m_valueSize, m_step);
+
+                if (block.candidateCount > 0)
+                    blocks.push_back(std::move(block));
+            }
+        }
+
+        if (value.has_value()) {
+            this->setBlocks(this->processBlocks(task, blocks, [&](const CandidateBlock &block) {
+                return this->processBlock(provider, block, Condition::Equal, *value);
+            }));
+        } else {
+            // Without a value to look for, take a snapshot of all the data so later scans have something to compare against
+            this->setBlocks(this->processBlocks(task, blocks, [&](const CandidateBlock &block) {
+                auto result = block;
+                result.values.resize(block.dataSize);
+                provider->read(block.address, result.values.data(), result.values.size());
+
+                return result;
+            }));
+        }
+    }
+
+    void MemoryScanner::nextScan(Task &task, prv::Provider *provider, Condition condition, const Value &value) {
+        // Scans only ever run one at a time so the blocks can't change underneath us. The current candidates
+        // stay untouched until the scan is done, that way an interrupted scan doesn't lose any of them
+        this->setBlocks(this->processBlocks(task, m_blocks, [&](const CandidateBlock &block) {
+            return this->processBlock(provider, block, condition, value);
+        }));
+    }
+
+    void MemoryScanner::reset() {
+        std::unique_lock lock(m_mutex);
+
+        m_blocks.clear();
+        m_blocks.shrink_to_fit();
+        m_candidateCount = 0;
+        m_scanned = false;
+    }
+
+    bool MemoryScanner::hasScanned() const {
+        std::shared_lock lock(m_mutex);
+        return m_scanned;
+    }
+
+    u64 MemoryScanner::getCandidateCount() const {
+        std::shared_lock lock(m_mutex);
+        return m_candidateCount;
+    }
+
+    std::vector<MemoryScanner::Candidate> MemoryScanner::getCandidates(u64 maxCount) const {
+        std::shared_lock lock(m_mutex);
+
+        std::vector<Candidate> result;
+        result.reserve(std::min(maxCount, m_candidateCount));
+
+        const auto addCandidate = [&](u64 address, const u8 *data) {
+            Candidate candidate = { .address=address, .value={ } };
+            std::memcpy(candidate.value.data(), data, m_valueSize);
+            result.push_back(candidate);
+        };
+
+        for (const auto &block : m_blocks) {
+            if (block.dense) {
+                const auto count = getDenseCandidateCount(block.candidateEnd, block.dataSize, m_valueSize, m_step);
+                for (u64 i = 0; i < count && result.size() < maxCount; i += 1)
+                    addCandidate(block.address + i * m_step, block.values.data() + i * m_step);
+            } else {
+                for (u64 i = 0; i < block.offsets.size() && result.size() < maxCount; i += 1)
+                    addCandidate(block.address + block.offsets[i], block.values.data() + i * m_valueSize);
+            }
+
+            if (result.size() >= maxCount)
+                break;
+        }
+
+        return result;
+    }
+
+    size_t MemoryScanner::getValueSize(ValueType type) {
+        return visitValueType(type, []<typename T>(std::type_identity<T>) {
+            return sizeof(T);
+        });
+    }
+
+    std::optional<MemoryScanner::Value> MemoryScanner::parseValue(ValueType type, const std::string &input) {
+        switch (type) {
+            using enum ValueType;
+
+            case U8:    return parseNumericValue<u8,  u64>(input);
+            case U16:   return parseNumericValue<u16, u64>(input);
+            case U32:   return parseNumericValue<u32, u64>(input);
+            case U64:   return parseNumericValue<u64, u64>(input);
+            case I8:    return parseNumericValue<i8,  i64>(input);
+            case I16:   return parseNumericValue<i16, i64>(input);
+            case I32:   return parseNumericValue<i32, i64>(input);
+            case I64:   return parseNumericValue<i64, i64>(input);
+            case F32:   return parseNumericValue<float, double>(input);
+            case F64:   return parseNumericValue<double, double>(input);
+            default:    return std::nullopt;
+        }
+    }
+
+    std::string MemoryScanner::formatValue(ValueType type, const Value &value) {
+        return visitValueType(type, [&]<typename T>(std::type_identity<T>) {
+            // Print single byte values as numbers instead of characters
+            if constexpr (sizeof(T) == 1)
+                return fmt::format("{}", i64(load<T>(value.data())));
+            else
+                return fmt::format("{}", load<T>(value.data()));
+        });
+    }
+
+    template<typename T>
+    MemoryScanner::CandidateBlock MemoryScanner::scanBlock(prv::Provider *provider, const CandidateBlock &block, Condition condition, const Value &value) const {
+        const auto target = load<T>(value.data());
+
+        CandidateBlock result;
+        result.address = block.address;
+
+        const auto addMatch = [&](u32 offset, const u8 *data) {
+            result.offsets.push_back(offset);
+            result.values.insert(result.values.end(), data, data + sizeof(T));
+        };
+
+        if (block.dense) {
+            std::vector<u8> current(block.dataSize);
+            provider->read(block.address, current.data(), current.size());
+
+            // Dense blocks from a first scan with a value don't have any previous data yet. That's fine since only Condition::Equal is used there
+            const auto previous = block.values.empty() ? current.data() : block.values.data();
+            for (u64 offset = 0; offset < block.candidateEnd && offset + sizeof(T) <= current.size(); offset += m_step) {
+                if (matches<T>(condition, current.data() + offset, previous + offset, target))
+                    addMatch(u32(offset), current.data() + offset);
+            }
+
+            // Stay dense if nothing got filtered out. Storing every candidate individually would take up more space than the data itself
+            if (result.offsets.size() == block.candidateCount) {
+                result = block;
+                result.values = std::move(current);
+
+                return result;
+            }
+        } else {
+            const auto count = block.offsets.size();
+            std::vector<u8> current(count * sizeof(T));
+
+            const u64 firstOffset = block.offsets.front();
+            const u64 span = u64(block.offsets.back()) + sizeof(T) - firstOffset;
+            if (span <= count * MaxAverageCandidateDistance) {
+                std::vector<u8> data(span);
+                provider->read(block.address + firstOffset, data.data(), data.size());
+
+                for (size_t i = 0; i < count; i += 1)
+                    std::memcpy(current.data() + i * sizeof(T), data.data() + (block.offsets[i] - firstOffset), sizeof(T));
+            } else {
+                std::vector<prv::Provider::ReadRequest> requests;
+                requests.reserve(count);
+                for (size_t i = 0; i < count; i += 1)
+                    requests.push_back({ .offset=block.address + block.offsets[i], .buffer=current.data() + i * sizeof(T), .size=sizeof(T) });
+
+                provider->readBatch(requests);
+            }
+
+            for (size_t i = 0; i < count; i += 1) {
+                const auto currentValue = current.data() + i * sizeof(T);
+                if (matches<T>(condition, currentValue, block.values.data() + i * sizeof(T), target))
+                    addMatch(block.offsets[i], currentValue);
+            }
+        }
+
+        result.offsets.shrink_to_fit();
+        result.values.shrink_to_fit();
+        result.candidateCount = result.offsets.size();
+
+        return result;
+    }
+
+    MemoryScanner::CandidateBlock MemoryScanner::processBlock(prv::Provider *provider, const CandidateBlock &block, Condition condition, const Value &value) const {
+        return visitValueType(m_valueType, [&]<typename T>(std::type_identity<T>) {
+            return this->scanBlock<T>(provider, block, condition, value);
+        });
+    }
+
+    std::vector<MemoryScanner::CandidateBlock> MemoryScanner::processBlocks(Task &task, const std::vector<CandidateBlock> &blocks, const std::function<CandidateBlock(const CandidateBlock &)> &processBlock) const {
+        std::vector<CandidateBlock> results(blocks.size());
+        if (blocks.empty())
+            return results;
+
+        task.setMaxValue(blocks.size());
+
+        // Workers keep grabbing the next unprocessed block until none are left so they all stay busy,
+        // no matter how much work the individual blocks turn out to be
+        std::atomic<size_t> nextBlock = 0;
+        std::atomic<bool> interrupted = false;
+        const auto worker = [&] {
+            while (!interrupted) {
+                const auto index = nextBlock.fetch_add(1);
+                if (index >= blocks.size())
+                    break;
+
+                results[index] = processBlock(blocks[index]);
+            }
+        };
+
+        const auto workerCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, blocks.size());
+        std::vector<std::future<void>> workers;
+        workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; i += 1)
+            workers.push_back(std::async(std::launch::async, worker));
+
+        for (auto &future : workers) {
+            while (future.wait_for(50ms) == std::future_status::timeout) {
+                if (task.shouldInterrupt())
+                    interrupted = true;
+                else
+                    task.update(std::min(nextBlock.load(), blocks.size()));
+            }
+        }
+
+        // Rethrows any exception that happened inside of a worker, after all of them have stopped
+        for (auto &future : workers)
+            future.get();
+
+        task.update();
+
+        return results;
+    }
+
+    void MemoryScanner::setBlocks(std::vector<CandidateBlock> &&blocks) {
+        std::erase_if(blocks, [](const CandidateBlock &block) { return block.candidateCount == 0; });
+
+        u64 candidateCount = 0;
+        for (const auto &block : blocks)
+            candidateCount += block.candidateCount;
+
+        std::unique_lock lock(m_mutex);
+
+        m_blocks         = std::move(blocks);
+        m_candidateCount = candidateCount;
+        m_scanned        = true;
+    }
+
+}
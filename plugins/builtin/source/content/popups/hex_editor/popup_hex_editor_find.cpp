@@ -230,37 +230,25 @@ namespace hex::plugin::builtin {
         if (providerSize == 0x00)
             return std::nullopt;
 
-        prv::ProviderReader reader(provider);
-
-        auto startAbsolutePosition = provider->getBaseAddress();
-        auto endAbsolutePosition = provider->getBaseAddress() + providerSize - 1;
+        const Region searchRegion = { .address=provider->getBaseAddress(), .size=providerSize };
+        const ByteSequenceSearcher searcher(sequence);
 
+        std::optional<u64> occurrence;
         if (!m_searchBackwards) {
-            if (m_reachedEnd || !m_foundRegion.has_value()) {
-                reader.seek(startAbsolutePosition);
-            } else {
-                reader.seek(m_foundRegion->getStartAddress() + 1);
-            }
-            reader.setEndAddress(endAbsolutePosition);
-
-            auto occurrence = searchInterruptable(reader.begin(), reader.end(), sequence.begin(), sequence.end(), task);
-            if (occurrence != reader.end()) {
-                return Region{.address=occurrence.getAddress(), .size=sequence.size()};
-            }
+            if (m_reachedEnd || !m_foundRegion.has_value())
+                occurrence = searcher.findNext(task, provider, searchRegion, searchRegion.getStartAddress());
+            else
+                occurrence = searcher.findNext(task, provider, searchRegion, m_foundRegion->getStartAddress() + 1);
         } else {
-            if (m_reachedEnd || !m_foundRegion.has_value()) {
-                reader.setEndAddress(endAbsolutePosition);
-            } else {
-                reader.setEndAddress(m_foundRegion->getEndAddress() - 1);
-            }
-            reader.seek(startAbsolutePosition);
-
-            auto occurrence = searchInterruptable(reader.rbegin(), reader.rend(), sequence.rbegin(), sequence.rend(), task);
-            if (occurrence != reader.rend()) {
-                return Region{.address=occurrence.getAddress() - (sequence.size() - 1), .size=sequence.size()};
-            }
+            if (m_reachedEnd || !m_foundRegion.has_value())
+                occurrence = searcher.findPrevious(task, provider, searchRegion, searchRegion.getEndAddress());
+            else if (m_foundRegion->getEndAddress() > searchRegion.getStartAddress())
+                occurrence = searcher.findPrevious(task, provider, searchRegion, m_foundRegion->getEndAddress() - 1);
         }
 
+        if (occurrence.has_value())
+            return Region { .address=*occurrence, .size=sequence.size() };
+
         return std::nullopt;
     }
 
@@ -1,63 +1,343 @@
 #include <content/providers/base64_provider.hpp>
+#include <content/helpers/cpu_features.hpp>
 
-#include <hex/helpers/crypto.hpp>
+#include <hex/helpers/literals.hpp>
 #include <hex/helpers/utils.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#if defined(IMHEX_X86_DISPATCH)
+    #include <immintrin.h>
+    #define BASE64_VECTOR_X86
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define BASE64_VECTOR_NEON
+#endif
+
 namespace hex::plugin::builtin {
 
-    void Base64Provider::readRaw(u64 offset, void *buffer, size_t size) {
-        const u64 base64Offset = 4 * (offset / 3);
-        const u64 base64Size = std::min<u64>(hex::alignTo<u64>(4 * (size / 3), 4) + 4, m_fileSize);
+    using namespace hex::literals;
 
-        std::vector<u8> bytes(base64Size);
-        FileProvider::readRaw(base64Offset, bytes.data(), bytes.size());
+    namespace {
 
-        auto decoded = crypt::decode64(bytes);
-        if (decoded.empty())
-            return;
+        // Number of encoded characters per block. Has to be a multiple of 4 so blocks always start at the start of a group
+        constexpr static u64 BlockEncodedSize = 4_KiB;
+        constexpr static u64 BlockDecodedSize = (BlockEncodedSize / 4) * 3;
+
+        constexpr static size_t MaxCachedBlocks = 64;
+
+        constexpr static std::string_view Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        constexpr static u8 PaddingCharacter = '=';
+
+        constexpr static u8 InvalidValue = 0xFF;
+        constexpr static u8 PaddingValue = 0xFE;
+
+        constexpr static auto DecodeTable = [] {
+            std::array<u8, 256> table = { };
+            table.fill(InvalidValue);
+
+            for (size_t i = 0; i < Alphabet.size(); i += 1)
+                table[u8(Alphabet[i])] = u8(i);
+            table[PaddingCharacter] = PaddingValue;
+
+            return table;
+        }();
+
+        constexpr bool isEncodingCharacter(u8 c) {
+            return DecodeTable[c] != InvalidValue;
+        }
+
+        // Number of characters decoded per step of the vectorized decoder
+        constexpr static size_t VectorGroupSize = 64;
+
+        #if defined(BASE64_VECTOR_X86)
+
+            IMHEX_TARGET_SSSE3 size_t decodeSSSE3(std::span<const u8> input, u8 *&output) {
+                // The high nibble of a character selects the offset that turns it into its 6 bit value. '/' shares its high nibble with '+'
+                // but needs a different offset, so it gets a slot of its own. Characters are invalid if the bits their low and high nibbles
+                // select from the two validation tables overlap
+                const auto lowNibbleTable  = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+                const auto highNibbleTable = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+                const auto offsetTable     = _mm_setr_epi8(0, 63 - '/', 62 - '+', 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a', 0, 0, 0, 0, 0, 0, 0, 0);
+                const auto nibbleMask      = _mm_set1_epi8(0x2F);
+
+                // Groups of four 6 bit values get merged into 24 bit values, whose bytes are then moved to the front in big endian order
+                const auto packTable = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+                size_t i = 0;
+                for (; i + VectorGroupSize <= input.size(); i += VectorGroupSize) {
+                    // Bytes decoded from a group that turns out to contain invalid characters are simply overwritten by the scalar decoder later on
+                    auto errors = _mm_setzero_si128();
+                    for (size_t j = 0; j < VectorGroupSize; j += 16) {
+                        const auto characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + i + j));
+                        const auto highNibbles = _mm_and_si128(_mm_srli_epi32(characters, 4), nibbleMask);
+                        const auto lowNibbles  = _mm_and_si128(characters, nibbleMask);
+
+                        errors = _mm_or_si128(errors, _mm_and_si128(_mm_shuffle_epi8(lowNibbleTable, lowNibbles), _mm_shuffle_epi8(highNibbleTable, highNibbles)));
+
+                        const auto isSlash = _mm_cmpeq_epi8(characters, nibbleMask);
+                        const auto values  = _mm_add_epi8(characters, _mm_shuffle_epi8(offsetTable, _mm_add_epi8(isSlash, highNibbles)));
+
+                        const auto pairs  = _mm_maddubs_epi16(values, _mm_set1_epi32(0x0140'0140));
+                        const auto groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x0001'1000));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + (j / 4) * 3), _mm_shuffle_epi8(groups, packTable));
+                    }
+
+                    // Padding or invalid characters are left to the scalar decoder
+                    if (_mm_movemask_epi8(_mm_cmpgt_epi8(errors, _mm_setzero_si128())) != 0)
+                        break;
+
+                    output += (VectorGroupSize / 4) * 3;
+                }
+
+                return i;
+            }
+
+            size_t decodeVectorized(std::span<const u8> input, u8 *&output) {
+                if (!isSSSE3Supported())
+                    return 0;
+
+                return decodeSSSE3(input, output);
+            }
+
+        #elif defined(BASE64_VECTOR_NEON)
+
+            uint8x16_t translateCharacters(uint8x16_t characters, uint8x16_t &errors) {
+                const auto inRange = [characters](char first, char last) {
+                    return vcleq_u8(vsubq_u8(characters, vdupq_n_u8(u8(first))), vdupq_n_u8(u8(last - first)));
+                };
+
+                const auto upper = inRange('A', 'Z');
+                const auto lower = inRange('a', 'z');
+                const auto digit = inRange('0', '9');
+                const auto plus  = vceqq_u8(characters, vdupq_n_u8('+'));
+                const auto slash = vceqq_u8(characters, vdupq_n_u8('/'));
+
+                const auto valid = vorrq_u8(vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(digit, plus)), slash);
+                errors = vorrq_u8(errors, vmvnq_u8(valid));
+
+                auto offset = vandq_u8(upper, vdupq_n_u8(u8(-'A')));
+                offset = vorrq_u8(offset, vandq_u8(lower, vdupq_n_u8(u8(26 - 'a'))));
+                offset = vorrq_u8(offset, vandq_u8(digit, vdupq_n_u8(u8(52 - '0'))));
+                offset = vorrq_u8(offset, vandq_u8(plus,  vdupq_n_u8(u8(62 - '+'))));
+                offset = vorrq_u8(offset, vandq_u8(slash, vdupq_n_u8(u8(63 - '/'))));
+
+                return vaddq_u8(characters, offset);
+            }
+
+            size_t decodeVectorized(std::span<const u8> input, u8 *&output) {
+                size_t i = 0;
+                for (; i + VectorGroupSize <= input.size(); i += VectorGroupSize) {
+                    // Loading de-interleaves the characters so every register holds the same character of 16 groups
+                    auto characters = vld4q_u8(input.data() + i);
+
+                    auto errors = vdupq_n_u8(0x00);
+                    const auto a = translateCharacters(characters.val[0], errors);
+                    const auto b = translateCharacters(characters.val[1], errors);
+                    const auto c = translateCharacters(characters.val[2], errors);
+                    const auto d = translateCharacters(characters.val[3], errors);
+
+                    // Padding or invalid characters are left to the scalar decoder
+                    const auto errorBits = vorr_u8(vget_low_u8(errors), vget_high_u8(errors));
+                    if (vget_lane_u64(vreinterpret_u64_u8(errorBits), 0) != 0)
+                        break;
+
+                    uint8x16x3_t bytes;
+                    bytes.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+                    bytes.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+                    bytes.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+                    vst3q_u8(output, bytes);
+
+                    output += (VectorGroupSize / 4) * 3;
+                }
+
+                return i;
+            }
+
+        #else
+
+            size_t decodeVectorized(std::span<const u8>, u8 *&) {
+                return 0;
+            }
+
+        #endif
+
+        std::vector<u8> decodeBlock(std::span<const u8> input) {
+            std::vector<u8> result((input.size() / 4) * 3 + 16);
+            auto output = result.data();
+
+            // Decode as much as possible using vector instructions first. They check for invalid characters once per group
+            // of 64 characters and leave the group containing padding, as well as everything following it, to the scalar loop.
+            // The buffer has some room left after the bytes the full groups decode to, the vectorized decoders may write a few bytes past their output
+            size_t i = decodeVectorized(input, output);
+
+            // Decode the remaining full groups of four characters until padding or an invalid character shows up
+            for (; i + 4 <= input.size(); i += 4) {
+                const u32 a = DecodeTable[input[i + 0]];
+                const u32 b = DecodeTable[input[i + 1]];
+                const u32 c = DecodeTable[input[i + 2]];
+                const u32 d = DecodeTable[input[i + 3]];
+
+                if (((a | b | c | d) & 0x80) != 0)
+                    break;
+
+                const u32 value = (a << 18) | (b << 12) | (c << 6) | d;
+                output[0] = u8(value >> 16);
+                output[1] = u8(value >> 8);
+                output[2] = u8(value >> 0);
+                output += 3;
+            }
+
+            // Decode the last, potentially padded or incomplete group
+            u32 value = 0;
+            u32 characterCount = 0;
+            for (; i < input.size() && characterCount < 4; i += 1) {
+                const auto digit = DecodeTable[input[i]];
+                if (digit == PaddingValue)
+                    break;
+
+                value = (value << 6) | digit;
+                characterCount += 1;
+            }
+
+            if (characterCount >= 2) {
+                value <<= 6 * (4 - characterCount);
+                for (u32 j = 0; j < characterCount - 1; j += 1)
+                    *output++ = u8(value >> (16 - j * 8));
+            }
+
+            result.resize(output - result.data());
+            return result;
+        }
+
+        std::vector<u8> encodeBlock(std::span<const u8> input) {
+            std::vector<u8> result;
+            result.reserve(((input.size() + 2) / 3) * 4);
+
+            size_t i = 0;
+            for (; i + 3 <= input.size(); i += 3) {
+                const u32 value = (u32(input[i]) << 16) | (u32(input[i + 1]) << 8) | input[i + 2];
+                result.push_back(Alphabet[(value >> 18) & 0x3F]);
+                result.push_back(Alphabet[(value >> 12) & 0x3F]);
+                result.push_back(Alphabet[(value >>  6) & 0x3F]);
+                result.push_back(Alphabet[(value >>  0) & 0x3F]);
+            }
+
+            if (const auto remaining = input.size() - i; remaining > 0) {
+                const u32 value = (u32(input[i]) << 16) | (remaining > 1 ? u32(input[i + 1]) << 8 : 0);
+                result.push_back(Alphabet[(value >> 18) & 0x3F]);
+                result.push_back(Alphabet[(value >> 12) & 0x3F]);
+                result.push_back(remaining > 1 ? Alphabet[(value >> 6) & 0x3F] : PaddingCharacter);
+                result.push_back(PaddingCharacter);
+            }
+
+            return result;
+        }
 
-        u64 startOffset = offset % 3;
-        std::memcpy(buffer, decoded.data() + startOffset, std::min<size_t>(decoded.size() - startOffset, size));
     }
 
-    void Base64Provider::writeRaw(u64 offset, const void *buffer, size_t size) {
-        const u64 base64Offset = 4 * (offset / 3);
-        const u64 base64Size = hex::alignTo<u64>(4 * (size / 3), 4) + 4;
+    prv::Provider::OpenResult Base64Provider::open() {
+        auto result = FileProvider::open();
 
-        std::vector<u8> bytes(base64Size);
-        FileProvider::readRaw(base64Offset, bytes.data(), bytes.size());
+        std::scoped_lock lock(m_mutex);
+        this->invalidateIndex();
+        if (!result.isFailure())
+            this->ensureIndex();
 
-        auto decoded = crypt::decode64(bytes);
-        if (decoded.empty())
-            return;
+        return result;
+    }
 
-        u64 startOffset = offset % 3;
-        std::memcpy(decoded.data() + startOffset, buffer, std::min<size_t>(decoded.size() - startOffset, size));
+    void Base64Provider::close() {
+        {
+            std::scoped_lock lock(m_mutex);
+            this->invalidateIndex();
+        }
 
-        auto encoded = crypt::encode64(decoded);
-        if (encoded.empty())
-            return;
+        FileProvider::close();
+    }
+
+    u64 Base64Provider::getActualSize() const {
+        std::scoped_lock lock(m_mutex);
+
+        // The index is built lazily whenever the encoded data changed size, e.g. after the file got reloaded
+        const_cast<Base64Provider*>(this)->ensureIndex();
+
+        return m_decodedSize;
+    }
+
+    void Base64Provider::readRaw(u64 offset, void *buffer, size_t size) {
+        std::scoped_lock lock(m_mutex);
+        this->ensureIndex();
+
+        auto output = static_cast<u8*>(buffer);
+        while (size > 0 && offset < m_decodedSize) {
+            const auto &block = this->getBlock(offset / BlockDecodedSize);
+            const auto blockOffset = offset % BlockDecodedSize;
+            if (blockOffset >= block.size())
+                break;
 
-        FileProvider::writeRaw(base64Offset, encoded.data(), encoded.size());
+            const auto readSize = std::min<u64>(block.size() - blockOffset, size);
+            std::memcpy(output, block.data() + blockOffset, readSize);
+
+            output += readSize;
+            offset += readSize;
+            size   -= readSize;
+        }
+    }
+
+    void Base64Provider::writeRaw(u64 offset, const void *buffer, size_t size) {
+        std::scoped_lock lock(m_mutex);
+        this->ensureIndex();
+
+        auto input = static_cast<const u8*>(buffer);
+        while (size > 0 && offset < m_decodedSize) {
+            const auto blockIndex = offset / BlockDecodedSize;
+            auto block = this->getBlock(blockIndex);
+            const auto blockOffset = offset % BlockDecodedSize;
+            if (blockOffset >= block.size())
+                break;
+
+            const auto writeSize = std::min<u64>(block.size() - blockOffset, size);
+            std::memcpy(block.data() + blockOffset, input, writeSize);
+            this->writeBlock(blockIndex, block);
+
+            input  += writeSize;
+            offset += writeSize;
+            size   -= writeSize;
+        }
     }
 
     void Base64Provider::resizeRaw(u64 newSize) {
         u64 newFileLength = 4 * (newSize / 3);
         FileProvider::resizeRaw(newFileLength);
+
+        std::scoped_lock lock(m_mutex);
+        this->invalidateIndex();
     }
 
     void Base64Provider::insertRaw(u64 offset, u64 size) {
         u64 newFileLength = 4 * ((getActualSize() + size) / 3);
         FileProvider::insertRaw(4 * (offset / 3), newFileLength);
 
-        constexpr static auto NullByte = 0x00;
-        for (u64 i = 0; i < size; i++)
-            writeRaw(offset + i, &NullByte, 1);
+        {
+            std::scoped_lock lock(m_mutex);
+            this->invalidateIndex();
+        }
+
+        const std::vector<u8> zeros(size, 0x00);
+        writeRaw(offset, zeros.data(), zeros.size());
     }
 
     void Base64Provider::removeRaw(u64 offset, u64 size) {
         u64 newFileLength = 4 * ((getActualSize() - size) / 3);
         FileProvider::removeRaw(4 * (offset / 3), newFileLength);
+
+        std::scoped_lock lock(m_mutex);
+        this->invalidateIndex();
     }
 
     std::vector<fs::ItemFilter> Base64Provider::getValidExtensions() const {
@@ -67,4 +347,98 @@ namespace hex::plugin::builtin {
         };
     }
 
-}
\ No newline at end of file
+    void Base64Provider::ensureIndex() {
+        const auto encodedSize = FileProvider::getActualSize();
+        if (m_indexValid && m_indexedEncodedSize == encodedSize)
+            return;
+
+        this->invalidateIndex();
+
+        // Walk over the whole file once and remember where every block starts
+        u64 characterCount = 0;
+        u64 paddingCount = 0;
+
+        std::vector<u8> buffer(std::min<u64>(1_MiB, encodedSize));
+        for (u64 offset = 0; offset < encodedSize; offset += buffer.size()) {
+            const auto readSize = std::min<u64>(buffer.size(), encodedSize - offset);
+            FileProvider::readRaw(offset, buffer.data(), readSize);
+
+            for (u64 i = 0; i < readSize; i += 1) {
+                const auto c = buffer[i];
+                if (!isEncodingCharacter(c))
+                    continue;
+
+                if (characterCount % BlockEncodedSize == 0)
+                    m_blockOffsets.push_back(offset + i);
+
+                characterCount += 1;
+                paddingCount = c == PaddingCharacter ? paddingCount + 1 : 0;
+            }
+        }
+
+        m_blockOffsets.push_back(encodedSize);
+        m_decodedSize = ((characterCount - paddingCount) * 3) / 4;
+        m_indexedEncodedSize = encodedSize;
+        m_indexValid = true;
+    }
+
+    void Base64Provider::invalidateIndex() {
+        m_indexValid = false;
+        m_blockOffsets.clear();
+        m_decodedSize = 0;
+
+        m_cache.clear();
+        m_cacheLookup.clear();
+    }
+
+    const std::vector<u8>& Base64Provider::getBlock(u64 blockIndex) {
+        if (auto it = m_cacheLookup.find(blockIndex); it != m_cacheLookup.end()) {
+            m_cache.splice(m_cache.begin(), m_cache, it->second);
+            return it->second->data;
+        }
+
+        // Read the encoded characters of the block, dropping line breaks and anything else that's not part of the encoding
+        const auto startOffset = m_blockOffsets[blockIndex];
+        const auto endOffset   = m_blockOffsets[blockIndex + 1];
+
+        std::vector<u8> encoded(endOffset - startOffset);
+        FileProvider::readRaw(startOffset, encoded.data(), encoded.size());
+        std::erase_if(encoded, [](u8 c) { return !isEncodingCharacter(c); });
+
+        m_cache.push_front({ blockIndex, decodeBlock(encoded) });
+        m_cacheLookup[blockIndex] = m_cache.begin();
+
+        if (m_cache.size() > MaxCachedBlocks) {
+            m_cacheLookup.erase(m_cache.back().index);
+            m_cache.pop_back();
+        }
+
+        return m_cache.front().data;
+    }
+
+    void Base64Provider::writeBlock(u64 blockIndex, const std::vector<u8> &data) {
+        const auto encoded = encodeBlock(data);
+
+        const auto startOffset = m_blockOffsets[blockIndex];
+        const auto endOffset   = m_blockOffsets[blockIndex + 1];
+
+        // Replace the encoded characters in place so the layout of the file, including all line breaks, stays the same
+        std::vector<u8> bytes(endOffset - startOffset);
+        FileProvider::readRaw(startOffset, bytes.data(), bytes.size());
+
+        auto encodedIt = encoded.begin();
+        for (auto &byte : bytes) {
+            if (encodedIt == encoded.end())
+                break;
+
+            if (isEncodingCharacter(byte))
+                byte = *encodedIt++;
+        }
+
+        FileProvider::writeRaw(startOffset, bytes.data(), bytes.size());
+
+        if (auto it = m_cacheLookup.find(blockIndex); it != m_cacheLookup.end())
+            it->second->data = data;
+    }
+
+}
@@ -226,7 +226,7 @@ namespace hex::plugin::builtin {
     }
 
     void CommandProvider::save() {
-        Provider::save();
+        CachedProvider::save();
         std::ignore = executeCommand(m_saveCommand);
     }
 
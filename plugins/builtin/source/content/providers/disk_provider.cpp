@@ -3,6 +3,7 @@
 
 #include "content/providers/disk_provider.hpp"
 
+#include <hex/api/content_registry/settings.hpp>
 #include <hex/api/localization_manager.hpp>
 
 #include <hex/helpers/logger.hpp>
@@ -11,9 +12,12 @@
 #include <hex/helpers/scaling.hpp>
 #include <hex/ui/imgui_imhex_extensions.h>
 
+#include <wolv/literals.hpp>
 #include <wolv/utils/string.hpp>
 
+#include <algorithm>
 #include <bitset>
+#include <cstring>
 #include <filesystem>
 
 #include <imgui.h>
@@ -54,6 +58,8 @@
 
 namespace hex::plugin::builtin {
 
+    using namespace wolv::literals;
+
     bool DiskProvider::isAvailable() const {
         #if defined(OS_WINDOWS)
             return m_diskHandle != INVALID_HANDLE_VALUE;
@@ -259,14 +265,43 @@ namespace hex::plugin::builtin {
             m_diskSize = diskSize;
             blkdev_get_sector_size(m_diskHandle, reinterpret_cast<int *>(&m_sectorSize));
 
+            // Open the disk a second time for reads that bypass the page cache. Data that's only
+            // streamed through once shouldn't push everything else out of the system's memory
+            #if defined(O_DIRECT)
+                m_directHandle = ::open(path.c_str(), O_RDONLY | O_DIRECT);
+            #elif defined(OS_MACOS)
+                m_directHandle = ::open(path.c_str(), O_RDONLY);
+                if (m_directHandle != -1 && ::fcntl(m_directHandle, F_NOCACHE, 1) == -1) {
+                    ::close(m_directHandle);
+                    m_directHandle = -1;
+                }
+            #endif
+
         #endif
 
-        this->setCacheBlockSize(m_sectorSize);
+        if (m_sectorSize == 0)
+            m_sectorSize = 512;
+
+        // Direct reads need their buffers, offsets and sizes aligned to the block size of the disk. Aligning to whole pages covers all common sector sizes
+        m_alignment = std::max<size_t>(m_sectorSize, 4_KiB);
+
+        const auto requestSize = ContentRegistry::Settings::read<u64>("hex.builtin.setting.general", "hex.builtin.setting.general.disk_request_size", 1_MiB);
+        const auto queueDepth  = ContentRegistry::Settings::read<int>("hex.builtin.setting.general", "hex.builtin.setting.general.disk_queue_depth", 8);
+        m_requestSize = hex::alignTo<size_t>(std::max<size_t>(requestSize, m_alignment), m_alignment);
+        m_queueDepth  = size_t(std::clamp(queueDepth, 1, 64));
+
+        // Every cache miss reads one whole request, so make sure the cache can hold a good amount of them
+        this->setCacheBlockSize(m_requestSize);
+        this->setCacheBudget(std::max<size_t>(this->getCacheBudget(), m_requestSize * 16));
+
+        this->startReadWorkers();
+
         return result;
     }
 
     void DiskProvider::close() {
         CachedProvider::close();
+        this->stopReadWorkers();
 
         #if defined(OS_WINDOWS)
 
@@ -279,63 +314,275 @@ namespace hex::plugin::builtin {
 
             if (m_diskHandle != -1)
                 ::close(m_diskHandle);
+            if (m_directHandle != -1)
+                ::close(m_directHandle);
 
-            m_diskHandle = -1;
+            m_diskHandle   = -1;
+            m_directHandle = -1;
 
         #endif
     }
 
     void DiskProvider::readFromSource(u64 offset, void *buffer, size_t size) {
+        auto out = static_cast<u8 *>(buffer);
+        while (size > 0) {
+            const auto chunkIndex  = offset / m_requestSize;
+            const auto chunkOffset = offset % m_requestSize;
+            const auto toRead      = std::min<u64>(m_requestSize - chunkOffset, size);
+
+            std::shared_ptr<ChunkRequest> chunk;
+            {
+                std::unique_lock lock(m_chunkMutex);
+
+                // Once two chunks have been read right after each other, assume the rest is going to be read sequentially as well
+                // and keep the chunks following the current one in flight. Any other access pattern stops the readahead again
+                if (chunkIndex == m_nextSequentialChunk)
+                    m_sequentialHits += 1;
+                else if (chunkIndex + 1 != m_nextSequentialChunk)
+                    m_sequentialHits = 0;
+                m_nextSequentialChunk = chunkIndex + 1;
+
+                chunk = this->queueChunk(chunkIndex, true);
+                if (m_sequentialHits > 0) {
+                    for (u64 i = 1; i <= m_queueDepth; i += 1)
+                        this->queueChunk(chunkIndex + i, false);
+                }
+
+                m_chunkDone.wait(lock, [&] { return chunk->done; });
+
+                // The cache holds on to the data from here on
+                m_chunks.erase(chunkIndex);
+                this->pruneChunks(chunkIndex);
+            }
+
+            if (chunk->failed)
+                std::memset(out, 0x00, toRead);
+            else
+                std::memcpy(out, chunk->data.get() + chunkOffset, toRead);
+
+            out    += toRead;
+            offset += toRead;
+            size   -= toRead;
+        }
+    }
+
+    void DiskProvider::writeToSource(u64 offset, const void *buffer, size_t size) {
+        // Disks can only be written in whole sectors, so fill in the parts of the first and last sector that aren't being written
+        const auto alignedStart = offset - offset % m_sectorSize;
+        const auto alignedEnd   = hex::alignTo<u64>(offset + size, m_sectorSize);
+        const auto alignedSize  = alignedEnd - alignedStart;
+
+        auto data = this->allocateAligned(alignedSize);
+        if (offset != alignedStart)
+            this->readAligned(alignedStart, data.get(), m_sectorSize);
+        if (offset + size != alignedEnd)
+            this->readAligned(alignedEnd - m_sectorSize, data.get() + alignedSize - m_sectorSize, m_sectorSize);
+
+        std::memcpy(data.get() + (offset - alignedStart), buffer, size);
+        this->writeAligned(alignedStart, data.get(), alignedSize);
+
+        // Chunks that were read ahead before this write hold outdated data now. Chunks that are being waited for
+        // can't be affected since the cache never reads and writes the same block at the same time
+        std::scoped_lock lock(m_chunkMutex);
+        std::erase_if(m_chunks, [&](const auto &entry) {
+            const auto &[index, chunk] = entry;
+            const auto chunkStart = index * m_requestSize;
+
+            return !chunk->demanded && chunkStart < alignedEnd && chunkStart + m_requestSize > alignedStart;
+        });
+    }
+
+    bool DiskProvider::readAligned(u64 offset, void *buffer, size_t size) {
         #if defined(OS_WINDOWS)
             OVERLAPPED operation = { };
             operation.Offset     = static_cast<DWORD>(offset & 0xFFFF'FFFF);
             operation.OffsetHigh = static_cast<DWORD>(offset >> 32);
             operation.hEvent     = ::CreateEvent(nullptr, TRUE, FALSE, nullptr);
             if (operation.hEvent == nullptr)
-                return;
+                return false;
 
             DWORD bytesRead = 0;
             auto success = ::ReadFile(m_diskHandle, buffer, size, &bytesRead, &operation);
             if (!success && ::GetLastError() == ERROR_IO_PENDING)
-                std::ignore = ::GetOverlappedResult(m_diskHandle, &operation, &bytesRead, TRUE);
+                success = ::GetOverlappedResult(m_diskHandle, &operation, &bytesRead, TRUE);
 
             ::CloseHandle(operation.hEvent);
 
+            if (success && bytesRead < size)
+                std::memset(static_cast<u8 *>(buffer) + bytesRead, 0x00, size - bytesRead);
+
+            return success;
+
         #else
-            std::ignore = ::pread(m_diskHandle, buffer, size, static_cast<off_t>(offset));
+            auto out = static_cast<u8 *>(buffer);
+            size_t bytesRead = 0;
+            while (bytesRead < size) {
+                ssize_t result = -1;
+                if (m_directHandle != -1)
+                    result = ::pread(m_directHandle, out + bytesRead, size - bytesRead, static_cast<off_t>(offset + bytesRead));
+
+                // Not all devices support direct reads, fall back to a regular read in that case
+                if (result < 0)
+                    result = ::pread(m_diskHandle, out + bytesRead, size - bytesRead, static_cast<off_t>(offset + bytesRead));
+
+                if (result < 0)
+                    return false;
+
+                // Reached the end of the disk
+                if (result == 0) {
+                    std::memset(out + bytesRead, 0x00, size - bytesRead);
+                    break;
+                }
+
+                bytesRead += size_t(result);
+            }
+
+            return true;
 
         #endif
     }
 
-    void DiskProvider::writeToSource(u64 offset, const void *buffer, size_t size) {
-        const auto sectorOffset = offset % m_sectorSize;
-        const auto sectorBase   = offset - sectorOffset;
-        std::vector<u8> sectorData(m_sectorSize);
-        if (sectorOffset != 0 || size != m_sectorSize)
-            this->readFromSource(sectorBase, sectorData.data(), sectorData.size());
-        std::memcpy(sectorData.data() + sectorOffset, buffer, size);
-
+    bool DiskProvider::writeAligned(u64 offset, const void *buffer, size_t size) {
         #if defined(OS_WINDOWS)
             OVERLAPPED operation = { };
-            operation.Offset     = static_cast<DWORD>(sectorBase & 0xFFFF'FFFF);
-            operation.OffsetHigh = static_cast<DWORD>(sectorBase >> 32);
+            operation.Offset     = static_cast<DWORD>(offset & 0xFFFF'FFFF);
+            operation.OffsetHigh = static_cast<DWORD>(offset >> 32);
             operation.hEvent     = ::CreateEvent(nullptr, TRUE, FALSE, nullptr);
             if (operation.hEvent == nullptr)
-                return;
+                return false;
 
             DWORD bytesWritten = 0;
-            auto success = ::WriteFile(m_diskHandle, sectorData.data(), sectorData.size(), &bytesWritten, &operation);
+            auto success = ::WriteFile(m_diskHandle, buffer, size, &bytesWritten, &operation);
             if (!success && ::GetLastError() == ERROR_IO_PENDING)
-                std::ignore = ::GetOverlappedResult(m_diskHandle, &operation, &bytesWritten, TRUE);
+                success = ::GetOverlappedResult(m_diskHandle, &operation, &bytesWritten, TRUE);
 
             ::CloseHandle(operation.hEvent);
 
+            return success;
+
         #else
-            std::ignore = ::pwrite(m_diskHandle, sectorData.data(), sectorData.size(), static_cast<off_t>(sectorBase));
+            return ::pwrite(m_diskHandle, buffer, size, static_cast<off_t>(offset)) == ssize_t(size);
 
         #endif
     }
 
+    DiskProvider::AlignedBuffer DiskProvider::allocateAligned(size_t size) const {
+        const auto alignedSize = hex::alignTo<size_t>(size, m_alignment);
+
+        return AlignedBuffer(static_cast<u8 *>(::operator new[](alignedSize, std::align_val_t(m_alignment))), AlignedDeleter { m_alignment });
+    }
+
+    void DiskProvider::startReadWorkers() {
+        for (size_t i = 0; i < m_queueDepth; i += 1) {
+            m_readWorkers.emplace_back([this](const std::stop_token &stopToken) {
+                this->readWorker(stopToken);
+            });
+        }
+    }
+
+    void DiskProvider::stopReadWorkers() {
+        {
+            std::scoped_lock lock(m_chunkMutex);
+            for (auto &worker : m_readWorkers)
+                worker.request_stop();
+        }
+        m_chunkQueued.notify_all();
+
+        // Joins all workers
+        m_readWorkers.clear();
+
+        m_chunks.clear();
+        m_chunkQueue.clear();
+        m_nextSequentialChunk = NoPreviousChunk;
+        m_sequentialHits = 0;
+    }
+
+    void DiskProvider::readWorker(const std::stop_token &stopToken) {
+        while (true) {
+            u64 chunkIndex = 0;
+            std::shared_ptr<ChunkRequest> chunk;
+            {
+                std::unique_lock lock(m_chunkMutex);
+                m_chunkQueued.wait(lock, [&] {
+                    return !m_chunkQueue.empty() || stopToken.stop_requested();
+                });
+
+                if (stopToken.stop_requested())
+                    break;
+
+                chunkIndex = m_chunkQueue.front();
+                m_chunkQueue.pop_front();
+
+                // The chunk might have been dropped again while it was waiting in the queue
+                auto it = m_chunks.find(chunkIndex);
+                if (it == m_chunks.end())
+                    continue;
+
+                chunk = it->second;
+                chunk->started = true;
+            }
+
+            auto data = this->allocateAligned(m_requestSize);
+            const bool success = this->readAligned(chunkIndex * m_requestSize, data.get(), m_requestSize);
+
+            {
+                std::scoped_lock lock(m_chunkMutex);
+                chunk->data   = std::move(data);
+                chunk->failed = !success;
+                chunk->done   = true;
+            }
+            m_chunkDone.notify_all();
+        }
+    }
+
+    std::shared_ptr<DiskProvider::ChunkRequest> DiskProvider::queueChunk(u64 chunkIndex, bool demanded) {
+        if (auto it = m_chunks.find(chunkIndex); it != m_chunks.end()) {
+            auto &chunk = it->second;
+
+            // A chunk that was only being read ahead is needed right now, move it to the front of the queue
+            if (demanded && !chunk->demanded) {
+                chunk->demanded = true;
+                if (!chunk->started) {
+                    std::erase(m_chunkQueue, chunkIndex);
+                    m_chunkQueue.push_front(chunkIndex);
+                }
+            }
+
+            return chunk;
+        }
+
+        if (!demanded && chunkIndex * m_requestSize >= m_diskSize)
+            return nullptr;
+
+        auto chunk = std::make_shared<ChunkRequest>();
+        chunk->demanded = demanded;
+        m_chunks.emplace(chunkIndex, chunk);
+
+        if (demanded)
+            m_chunkQueue.push_front(chunkIndex);
+        else
+            m_chunkQueue.push_back(chunkIndex);
+        m_chunkQueued.notify_one();
+
+        return chunk;
+    }
+
+    void DiskProvider::pruneChunks(u64 currentIndex) {
+        // Drop chunks that were read ahead but aren't going to be used anymore because the reads moved somewhere else.
+        // Chunks currently being read are left alone, they're pruned once they're done
+        std::erase_if(m_chunks, [&](const auto &entry) {
+            const auto &[index, chunk] = entry;
+            if (chunk->demanded || (chunk->started && !chunk->done))
+                return false;
+
+            return index < currentIndex || index > currentIndex + m_queueDepth;
+        });
+
+        std::erase_if(m_chunkQueue, [this](u64 index) {
+            return !m_chunks.contains(index);
+        });
+    }
+
     u64 DiskProvider::getSourceSize() const {
         return m_diskSize;
     }
@@ -348,10 +595,13 @@ namespace hex::plugin::builtin {
     }
 
     std::vector<DiskProvider::Description> DiskProvider::getDataDescription() const {
+        const auto cacheStatistics = this->getCacheStatistics();
+
         return {
             { "hex.builtin.provider.disk.selected_disk"_lang, wolv::util::toUTF8String(m_path) },
             { "hex.builtin.provider.disk.disk_size"_lang,     hex::toByteString(m_diskSize)    },
-            { "hex.builtin.provider.disk.sector_size"_lang,   hex::toByteString(m_sectorSize)  }
+            { "hex.builtin.provider.disk.sector_size"_lang,   hex::toByteString(m_sectorSize)  },
+            { "hex.builtin.provider.cache_statistics"_lang,   fmt::format("hex.builtin.provider.cache_statistics.value"_lang, cacheStatistics.hits, cacheStatistics.misses, cacheStatistics.evictions, hex::toByteString(cacheStatistics.bytesFetched)) }
         };
     }
 
@@ -12,13 +12,19 @@
 
 #include <hex/helpers/utils.hpp>
 #include <hex/helpers/fmt.hpp>
+#include <hex/helpers/logger.hpp>
 #include <fmt/chrono.h>
 
 #include <wolv/utils/string.hpp>
 #include <wolv/literals.hpp>
 
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
+#include <limits>
+#include <ranges>
+#include <span>
 
 #if defined(OS_WINDOWS)
     #include <windows.h>
@@ -28,10 +34,91 @@
     #include <sys/xattr.h>
 #endif
 
+#if defined(OS_MACOS) || defined(OS_LINUX) || defined(OS_FREEBSD)
+    #include <sys/mman.h>
+    #include <cstdio>
+#endif
+
+#if defined(OS_LINUX)
+    #include <sys/uio.h>
+#endif
+
 namespace hex::plugin::builtin {
 
     using namespace wolv::literals;
 
+    namespace {
+
+        // Number of consecutive reads that need to follow each other before the mapping is
+        // switched over to sequential readahead, and the number of scattered reads needed to switch back
+        constexpr static u32 SequentialReadThreshold = 8;
+        constexpr static u32 RandomReadThreshold = 4;
+
+        // Maximum number of buffers passed to a single vectored read
+        constexpr static size_t MaxIoVectorCount = 1024;
+
+        // Files are loaded into memory in chunks of this size. Every chunk is made up of multiple checksum blocks
+        constexpr static u64 LoadChunkSize     = 4_MiB;
+        constexpr static u64 ChecksumBlockSize = 64_KiB;
+
+        u64 calculateChecksum(std::span<const u8> data) {
+            constexpr static u64 Multiplier = 0xFF51'AFD7'ED55'8CCD;
+
+            u64 checksum = 0x9E37'79B9'7F4A'7C15 ^ data.size();
+            size_t i = 0;
+            for (; i + sizeof(u64) <= data.size(); i += sizeof(u64)) {
+                u64 word;
+                std::memcpy(&word, data.data() + i, sizeof(word));
+
+                checksum = (checksum ^ word) * Multiplier;
+                checksum ^= checksum >> 32;
+            }
+
+            for (; i < data.size(); i += 1) {
+                checksum = (checksum ^ data[i]) * Multiplier;
+                checksum ^= checksum >> 32;
+            }
+
+            return checksum;
+        }
+
+        u64 getBlockCount(u64 size) {
+            return (size + ChecksumBlockSize - 1) / ChecksumBlockSize;
+        }
+
+    }
+
+    struct FileProvider::FileMapping {
+        FileMapping() = default;
+        FileMapping(const FileMapping&) = delete;
+        FileMapping& operator=(const FileMapping&) = delete;
+
+        ~FileMapping() {
+            if (data == nullptr)
+                return;
+
+            #if defined(OS_WINDOWS)
+                UnmapViewOfFile(data);
+                CloseHandle(HANDLE(handle));
+            #elif defined(OS_MACOS) || defined(OS_LINUX) || defined(OS_FREEBSD)
+                ::munmap(const_cast<u8*>(data), size);
+            #endif
+        }
+
+        const u8 *data = nullptr;
+        size_t size = 0;
+        #if defined(OS_WINDOWS)
+            void *handle = nullptr;
+        #endif
+    };
+
+    FileProvider::~FileProvider() {
+        m_loadTask.interrupt();
+        m_loadTask.wait();
+
+        this->unmapFile();
+    }
+
     bool FileProvider::isAvailable() const {
         return true;
     }
@@ -49,25 +136,167 @@ namespace hex::plugin::builtin {
     }
 
     bool FileProvider::isSavable() const {
-        return m_loadedIntoMemory;
+        return m_loadedIntoMemory || m_hasPendingEdits;
     }
 
     void FileProvider::readRaw(u64 offset, void *buffer, size_t size) {
         if (m_fileSize == 0 || (offset + size) > m_fileSize || buffer == nullptr || size == 0)
             return;
 
-        if (m_loadedIntoMemory)
-            std::memcpy(buffer, m_data.data() + offset, size);
-        else
-            m_file.readBufferAtomic(offset, static_cast<u8*>(buffer), size);
+        if (m_loadedIntoMemory) {
+            if (offset + size <= m_loadedSize.load(std::memory_order_acquire))
+                std::memcpy(buffer, m_data.data() + offset, size);
+            else
+                this->readPartiallyLoaded(offset, buffer, size);
+
+            return;
+        }
+
+        if (m_hasPendingEdits) {
+            std::shared_lock lock(m_pieceTableMutex);
+            m_pieceTable.read(offset, buffer, size, [this](u64 fileOffset, void *data, size_t dataSize) {
+                this->readFromFile(fileOffset, data, dataSize);
+            });
+
+            return;
+        }
+
+        this->readFromFile(offset, buffer, size);
+    }
+
+    void FileProvider::readFromFile(u64 offset, void *buffer, size_t size) {
+        {
+            std::shared_lock lock(m_mappingMutex);
+            if (m_mapping != nullptr && (offset + size) <= m_mapping->size) {
+                std::memcpy(buffer, m_mapping->data + offset, size);
+                this->updateAccessPattern(*m_mapping, offset, size);
+                return;
+            }
+        }
+
+        m_file.readBufferAtomic(offset, static_cast<u8*>(buffer), size);
+    }
+
+    void FileProvider::readPartiallyLoaded(u64 offset, void *buffer, size_t size) {
+        // The file only gets closed once everything has been loaded, which can't happen while it's being read from here
+        std::shared_lock lock(m_loadMutex);
+
+        const auto loadedSize = m_loadedSize.load(std::memory_order_acquire);
+        const auto loadedPart = offset < loadedSize ? std::min<u64>(size, loadedSize - offset) : 0;
+
+        std::memcpy(buffer, m_data.data() + offset, loadedPart);
+        if (loadedPart < size)
+            m_file.readBufferAtomic(offset + loadedPart, static_cast<u8*>(buffer) + loadedPart, size - loadedPart);
+    }
+
+    void FileProvider::readRawBatch(std::span<const ReadRequest> requests) {
+        if (m_loadedIntoMemory || m_hasPendingEdits) {
+            Provider::readRawBatch(requests);
+            return;
+        }
+
+        // Whatever can't be read is returned as zeros instead of leaving the buffer untouched
+        const auto readOrZero = [this](u64 offset, u8 *buffer, size_t size) {
+            const auto bytesRead = std::min(m_file.readBufferAtomic(offset, buffer, size), size);
+            std::memset(buffer + bytesRead, 0x00, size - bytesRead);
+        };
+
+        std::vector<ReadRequest> unmappedRequests;
+        {
+            std::shared_lock lock(m_mappingMutex);
+            for (const auto &request : requests) {
+                if (request.buffer == nullptr || request.size == 0)
+                    continue;
+
+                if (m_fileSize == 0 || (request.offset + request.size) > m_fileSize) {
+                    std::memset(request.buffer, 0x00, request.size);
+                    continue;
+                }
+
+                if (m_mapping != nullptr && (request.offset + request.size) <= m_mapping->size) {
+                    std::memcpy(request.buffer, m_mapping->data + request.offset, request.size);
+                    this->updateAccessPattern(*m_mapping, request.offset, request.size);
+                } else {
+                    unmappedRequests.push_back(request);
+                }
+            }
+        }
+
+        #if defined(OS_LINUX)
+
+            // Requests that directly follow each other in the file are fetched using a single syscall
+            const auto fileDescriptor = ::fileno(m_file.getHandle());
+            std::vector<iovec> ioVectors;
+            for (size_t index = 0; index < unmappedRequests.size();) {
+                const auto runStart = unmappedRequests[index].offset;
+                const auto runIndex = index;
+                auto runEnd = runStart;
+
+                ioVectors.clear();
+                while (index < unmappedRequests.size() && unmappedRequests[index].offset == runEnd && ioVectors.size() < MaxIoVectorCount) {
+                    const auto &request = unmappedRequests[index];
+                    ioVectors.push_back({ .iov_base = request.buffer, .iov_len = request.size });
+
+                    runEnd += request.size;
+                    index += 1;
+                }
+
+                const auto result = ::preadv(fileDescriptor, ioVectors.data(), int(ioVectors.size()), off_t(runStart));
+                if (result >= 0 && u64(result) == runEnd - runStart)
+                    continue;
+
+                // The read stopped early or failed entirely. Retry everything from where it stopped one request at a time
+                auto transferred = result < 0 ? 0 : u64(result);
+                for (const auto &request : std::span(unmappedRequests).subspan(runIndex, index - runIndex)) {
+                    const auto done = std::min<u64>(transferred, request.size);
+                    transferred -= done;
+
+                    if (done < request.size)
+                        readOrZero(request.offset + done, static_cast<u8*>(request.buffer) + done, request.size - done);
+                }
+            }
+
+        #else
+
+            for (const auto &request : unmappedRequests)
+                readOrZero(request.offset, static_cast<u8*>(request.buffer), request.size);
+
+        #endif
+    }
+
+    std::optional<prv::Provider::ContiguousView> FileProvider::tryGetContiguousViewRaw(u64 offset, size_t size) {
+        if (m_fileSize == 0 || (offset + size) > m_fileSize || size == 0)
+            return std::nullopt;
+
+        if (m_loadedIntoMemory) {
+            if (offset + size > m_loadedSize.load(std::memory_order_acquire))
+                return std::nullopt;
+
+            return m_viewedData.createView(m_data, offset, size);
+        }
+
+        // The file contents don't match the data anymore until the pending edits have been saved
+        if (m_hasPendingEdits)
+            return std::nullopt;
+
+        std::shared_lock lock(m_mappingMutex);
+        if (m_mapping == nullptr || (offset + size) > m_mapping->size)
+            return std::nullopt;
+
+        this->updateAccessPattern(*m_mapping, offset, size);
+        return ContiguousView({ m_mapping->data + offset, size }, m_mapping);
     }
 
     void FileProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
-        if ((offset + size) > this->getActualSize() || buffer == nullptr || size == 0)
+        if ((offset + size) > FileProvider::getActualSize() || buffer == nullptr || size == 0)
             return;
 
         if (m_loadedIntoMemory) {
+            this->waitUntilLoaded();
             std::memcpy(m_data.data() + offset, buffer, size);
+        } else if (m_hasPendingEdits) {
+            std::unique_lock lock(m_pieceTableMutex);
+            m_pieceTable.write(offset, buffer, size);
         } else {
             this->createBackupIfNeeded(m_file.getPath());
             m_file.writeBufferAtomic(offset, static_cast<const u8*>(buffer), size);
@@ -76,12 +305,22 @@ namespace hex::plugin::builtin {
 
     void FileProvider::save() {
         if (m_loadedIntoMemory) {
+            this->waitUntilLoaded();
+
             m_ignoreNextChangeEvent = true;
             this->createBackupIfNeeded(m_file.getPath());
             m_file.open();
             m_file.writeVectorAtomic(0x00, m_data);
             m_file.setSize(m_data.size());
+
+            // The file matches the data exactly again now
+            m_blockChecksums.resize(getBlockCount(m_data.size()));
+            this->updateBlockChecksums(0, m_data.size());
+            m_layoutChanged = false;
         } else {
+            if (m_hasPendingEdits)
+                this->applyPendingEdits();
+
             m_file.flush();
         }
 
@@ -113,15 +352,243 @@ namespace hex::plugin::builtin {
 
     void FileProvider::resizeRaw(u64 newSize) {
         if (m_loadedIntoMemory) {
+            this->waitUntilLoaded();
+            m_viewedData.detach(m_data);
             m_data.resize(newSize);
+            m_loadedSize = newSize;
+            m_layoutChanged = true;
         } else {
-            this->createBackupIfNeeded(m_file.getPath());
-            m_file.setSize(newSize);
+            std::unique_lock lock(m_pieceTableMutex);
+            m_pieceTable.resize(newSize);
+            m_hasPendingEdits = m_pieceTable.isModified();
         }
 
         m_fileSize = newSize;
     }
 
+    void FileProvider::insertRaw(u64 offset, u64 size) {
+        if ((offset > m_fileSize) || size == 0)
+            return;
+
+        if (m_loadedIntoMemory) {
+            this->waitUntilLoaded();
+            m_viewedData.detach(m_data);
+            m_data.insert(m_data.begin() + offset, size, 0x00);
+            m_fileSize = m_data.size();
+            m_loadedSize = m_fileSize;
+            m_layoutChanged = true;
+            return;
+        }
+
+        std::unique_lock lock(m_pieceTableMutex);
+        m_pieceTable.insert(offset, size);
+        m_fileSize = m_pieceTable.getSize();
+        m_hasPendingEdits = m_pieceTable.isModified();
+    }
+
+    void FileProvider::removeRaw(u64 offset, u64 size) {
+        if (offset >= m_fileSize || size == 0)
+            return;
+
+        size = std::min<u64>(size, m_fileSize - offset);
+
+        if (m_loadedIntoMemory) {
+            this->waitUntilLoaded();
+            m_viewedData.detach(m_data);
+            m_data.erase(m_data.begin() + offset, m_data.begin() + offset + size);
+            m_fileSize = m_data.size();
+            m_loadedSize = m_fileSize;
+            m_layoutChanged = true;
+            return;
+        }
+
+        std::unique_lock lock(m_pieceTableMutex);
+        m_pieceTable.remove(offset, size);
+        m_fileSize = m_pieceTable.getSize();
+        m_hasPendingEdits = m_pieceTable.isModified();
+    }
+
+    void FileProvider::applyPendingEdits() {
+        const auto path = m_file.getPath();
+        this->createBackupIfNeeded(path);
+
+        m_changeTracker.stopTracking();
+        this->unmapFile();
+
+        {
+            // Reads resolve the pieces to locations in the file, keep them out until the file matches the edited layout
+            std::unique_lock lock(m_pieceTableMutex);
+
+            std::error_code ec;
+            if (std::fs::is_regular_file(path, ec)) {
+                // The edited file is written to a copy first and only replaces the original once it's complete.
+                // If anything fails along the way, the original file is untouched and the pending edits remain valid
+                const auto error = this->replaceWithPieces(path, m_pieceTable.getPieces(), m_pieceTable.getAddedData());
+                if (error != 0) {
+                    ui::ToastError::open(fmt::format("hex.builtin.provider.file.error.save"_lang, wolv::util::toUTF8String(path), formatSystemError(error)));
+                } else {
+                    m_pieceTable.reset(m_fileSize);
+                    m_hasPendingEdits = false;
+                }
+            } else {
+                // Device nodes and the like can't be replaced and have to be rewritten in place. If that fails part way through,
+                // the pieces don't describe the file's contents anymore. Drop them and show what actually ended up in the file instead
+                const auto error = this->rewritePieces(m_pieceTable.getPieces(), m_pieceTable.getAddedData());
+                if (error != 0) {
+                    ui::ToastError::open(fmt::format("hex.builtin.provider.file.error.save"_lang, wolv::util::toUTF8String(path), formatSystemError(error)));
+                    m_fileSize = m_file.getSize();
+                }
+
+                m_pieceTable.reset(m_fileSize);
+                m_hasPendingEdits = false;
+            }
+        }
+
+        m_fileStats = m_file.getFileInfo();
+        this->mapFile();
+
+        m_changeTracker = wolv::io::ChangeTracker(m_file);
+        m_changeTracker.startTracking([this]{ this->handleFileChange(); });
+    }
+
+    i32 FileProvider::replaceWithPieces(const std::fs::path &path, const std::vector<prv::PieceTable::Piece> &pieces, const std::vector<u8> &addedData) {
+        using enum prv::PieceTable::Source;
+
+        errno = 0;
+
+        auto tempPath = path;
+        tempPath += ".imhex_save";
+
+        wolv::io::File tempFile(tempPath, wolv::io::File::Mode::Create);
+        if (!tempFile.isValid())
+            return tempFile.getOpenError().value_or(EIO);
+
+        // Pieces are in address order, so the new file can be written front to back in one go
+        std::vector<u8> buffer(1_MiB);
+        const auto writePieces = [&] {
+            for (const auto &piece : pieces) {
+                if (piece.source == Added) {
+                    if (tempFile.writeBufferAtomic(piece.address, addedData.data() + piece.sourceOffset, piece.size) != piece.size)
+                        return false;
+                    continue;
+                }
+
+                for (u64 done = 0; done < piece.size;) {
+                    const auto size = std::min<u64>(buffer.size(), piece.size - done);
+
+                    if (piece.source == Original) {
+                        if (m_file.readBufferAtomic(piece.sourceOffset + done, buffer.data(), size) != size)
+                            return false;
+                    } else {
+                        std::fill_n(buffer.begin(), size, 0x00);
+                    }
+
+                    if (tempFile.writeBufferAtomic(piece.address + done, buffer.data(), size) != size)
+                        return false;
+
+                    done += size;
+                }
+            }
+
+            tempFile.flush();
+            return tempFile.getSize() == m_fileSize;
+        };
+
+        std::error_code ec;
+        if (!writePieces()) {
+            const auto error = errno != 0 ? errno : EIO;
+            tempFile.close();
+            std::fs::remove(tempPath, ec);
+            return error;
+        }
+        tempFile.close();
+
+        std::fs::permissions(tempPath, std::fs::status(path, ec).permissions(), ec);
+
+        // Windows refuses to replace a file that is still open
+        m_file.close();
+        std::fs::rename(tempPath, path, ec);
+        m_file = wolv::io::File(path, wolv::io::File::Mode::Write);
+
+        if (ec) {
+            const auto error = ec.value() != 0 ? ec.value() : EIO;
+            std::fs::remove(tempPath, ec);
+            return error;
+        }
+
+        return 0;
+    }
+
+    i32 FileProvider::rewritePieces(const std::vector<prv::PieceTable::Piece> &pieces, const std::vector<u8> &addedData) {
+        using enum prv::PieceTable::Source;
+
+        // Rewrites the file in place, for files that can't be replaced by a new copy.
+        // If the file has to grow, do that first. If that fails, nothing has been modified yet
+        errno = 0;
+        const auto originalSize = m_file.getSize();
+        if (m_fileSize > originalSize) {
+            m_file.setSize(m_fileSize);
+            if (m_file.getSize() != m_fileSize)
+                return errno != 0 ? errno : EIO;
+        }
+
+        std::vector<u8> buffer(1_MiB);
+        const auto moveData = [&](const prv::PieceTable::Piece &piece) {
+            // Data moving towards the end of the file is copied back to front, so no part of it gets overwritten before it has been read
+            const bool backwards = piece.address > piece.sourceOffset;
+            for (u64 done = 0; done < piece.size;) {
+                const auto size   = std::min<u64>(buffer.size(), piece.size - done);
+                const auto offset = backwards ? piece.size - done - size : done;
+
+                if (m_file.readBufferAtomic(piece.sourceOffset + offset, buffer.data(), size) != size)
+                    return false;
+                if (m_file.writeBufferAtomic(piece.address + offset, buffer.data(), size) != size)
+                    return false;
+
+                done += size;
+            }
+
+            return true;
+        };
+
+        // Pieces of the original file keep their order. Moving the ones that go towards the start of the file front to back
+        // and then the ones that go towards the end back to front never overwrites data another piece still needs to read.
+        // Pieces that stay where they are don't need to be touched at all
+        for (const auto &piece : pieces) {
+            if (piece.source == Original && piece.address < piece.sourceOffset && !moveData(piece))
+                return errno != 0 ? errno : EIO;
+        }
+        for (const auto &piece : pieces | std::views::reverse) {
+            if (piece.source == Original && piece.address > piece.sourceOffset && !moveData(piece))
+                return errno != 0 ? errno : EIO;
+        }
+
+        // Everything else comes from memory and can only be written once no piece needs to read the original data anymore
+        std::fill(buffer.begin(), buffer.end(), 0x00);
+        for (const auto &piece : pieces) {
+            if (piece.source == Added) {
+                if (m_file.writeBufferAtomic(piece.address, addedData.data() + piece.sourceOffset, piece.size) != piece.size)
+                    return errno != 0 ? errno : EIO;
+            } else if (piece.source == Zero) {
+                for (u64 done = 0; done < piece.size;) {
+                    const auto size = std::min<u64>(buffer.size(), piece.size - done);
+                    if (m_file.writeBufferAtomic(piece.address + done, buffer.data(), size) != size)
+                        return errno != 0 ? errno : EIO;
+
+                    done += size;
+                }
+            }
+        }
+
+        if (m_fileSize < originalSize) {
+            m_file.setSize(m_fileSize);
+            if (m_file.getSize() != m_fileSize)
+                return errno != 0 ? errno : EIO;
+        }
+
+        return 0;
+    }
+
     u64 FileProvider::getActualSize() const {
         return m_fileSize;
     }
@@ -333,20 +800,40 @@ namespace hex::plugin::builtin {
                     }
 
                     m_fileSize = m_data.size();
+                    m_loadedSize = m_fileSize;
                     m_loadedIntoMemory = true;
                 } else {
-                    m_data = m_file.readVectorAtomic(0x00, m_fileSize);
-                    if (!m_data.empty()) {
-                        m_changeTracker = wolv::io::ChangeTracker(m_file);
-                        m_changeTracker.startTracking([this]{ this->handleFileChange(); });
-                        m_loadedIntoMemory = true;
-                    }
+                    // The data gets loaded in the background, reads are served from the file until then
+                    m_data.resize(m_fileSize);
+                    m_loadedSize = 0;
+                    m_blockChecksums.assign(getBlockCount(m_fileSize), 0);
+
+                    m_changeTracker = wolv::io::ChangeTracker(m_file);
+                    m_changeTracker.startTracking([this]{ this->handleFileChange(); });
+                    m_loadedIntoMemory = true;
                 }
             }
         }
 
-        if (m_loadedIntoMemory)
-            m_file.close();
+        {
+            std::unique_lock lock(m_pieceTableMutex);
+            m_pieceTable.reset(m_loadedIntoMemory ? 0 : m_fileSize);
+            m_hasPendingEdits = false;
+        }
+
+        m_layoutChanged = false;
+
+        if (m_loadedIntoMemory) {
+            if (m_loadedSize == m_fileSize)
+                m_file.close();
+            else
+                this->startLoading();
+        } else {
+            this->mapFile();
+
+            m_changeTracker = wolv::io::ChangeTracker(m_file);
+            m_changeTracker.startTracking([this]{ this->handleFileChange(); });
+        }
 
         m_changeEventAcknowledgementPending = false;
 
@@ -355,9 +842,24 @@ namespace hex::plugin::builtin {
 
 
     void FileProvider::close() {
+        m_loadTask.interrupt();
+        m_loadTask.wait();
+        m_loadTask = { };
+
+        this->unmapFile();
         m_file.close();
+        m_viewedData.detach(m_data, false);
         m_data.clear();
+        m_loadedSize = 0;
+        m_blockChecksums.clear();
         m_changeTracker.stopTracking();
+
+        {
+            std::unique_lock lock(m_pieceTableMutex);
+            m_pieceTable.reset(0);
+            m_hasPendingEdits = false;
+        }
+
         m_readable = false;
         m_writable = false;
     }
@@ -413,8 +915,25 @@ namespace hex::plugin::builtin {
     }
 
     void FileProvider::convertToMemoryFile() {
+        // Edits that haven't been saved yet only exist in the piece table, carry them over into the loaded data
+        std::optional<std::vector<u8>> editedData;
+        if (m_hasPendingEdits) {
+            editedData.emplace(m_fileSize);
+            this->readRaw(0, editedData->data(), editedData->size());
+        }
+
         this->close();
         this->open(false);
+
+        if (editedData.has_value() && m_loadedIntoMemory) {
+            this->waitUntilLoaded();
+
+            m_viewedData.detach(m_data, false);
+            m_data          = std::move(*editedData);
+            m_fileSize      = m_data.size();
+            m_loadedSize    = m_fileSize;
+            m_layoutChanged = true;
+        }
     }
 
     void FileProvider::convertToDirectAccess() {
@@ -423,6 +942,13 @@ namespace hex::plugin::builtin {
     }
 
     void FileProvider::handleFileChange() {
+        // In direct access mode all reads go straight to the file already. Only the mapping needs to be updated so it matches
+        // the new size of the file. Reads past the end of the new mapping go to the file and come back short instead of faulting
+        if (!m_loadedIntoMemory) {
+            this->mapFile();
+            return;
+        }
+
         if (m_ignoreNextChangeEvent) {
             m_ignoreNextChangeEvent = false;
             return;
@@ -434,8 +960,12 @@ namespace hex::plugin::builtin {
 
         m_changeEventAcknowledgementPending = true;
         ui::BannerButtonProviderSpecific::open(this, ICON_VS_INFO, "hex.builtin.provider.file.reload_changes", ImColor(66, 104, 135), "hex.builtin.provider.file.reload_changes.reload", [this] {
-            this->close();
-            (void)this->open(!m_loadedIntoMemory);
+            if (this->reloadChangedBlocks()) {
+                m_changeEventAcknowledgementPending = false;
+            } else {
+                this->close();
+                (void)this->open(!m_loadedIntoMemory);
+            }
 
             getUndoStack().reapply();
             EventDataChanged::post(this);
@@ -444,5 +974,197 @@ namespace hex::plugin::builtin {
         });
     }
 
+    void FileProvider::startLoading() {
+        m_loadTask = TaskManager::createTask("hex.builtin.provider.file.loading", ProgressValue::Size(m_fileSize), [this](Task &task) {
+            this->loadRemainingChunks(&task);
+        });
+    }
+
+    void FileProvider::loadRemainingChunks(Task *task) {
+        while (true) {
+            const auto offset = m_loadedSize.load();
+            if (offset >= m_fileSize)
+                break;
+
+            const auto size = std::min<u64>(LoadChunkSize, m_fileSize - offset);
+            m_file.readBufferAtomic(offset, m_data.data() + offset, size);
+            this->updateBlockChecksums(offset, size);
+
+            m_loadedSize.store(offset + size, std::memory_order_release);
+
+            if (task != nullptr)
+                task->update(offset + size);
+        }
+
+        // Nothing needs to be read from the file anymore
+        std::unique_lock lock(m_loadMutex);
+        m_file.close();
+    }
+
+    void FileProvider::waitUntilLoaded() {
+        if (m_loadedSize.load() >= m_fileSize)
+            return;
+
+        m_loadTask.wait();
+
+        // Finish loading right here if the task got interrupted before it was done. Only one thread may do that,
+        // everyone else waits for it since the file gets closed once everything has been loaded
+        std::scoped_lock lock(m_finishLoadingMutex);
+        if (m_loadedSize.load() < m_fileSize)
+            this->loadRemainingChunks(nullptr);
+    }
+
+    void FileProvider::updateBlockChecksums(u64 offset, u64 size) {
+        for (u64 blockOffset = offset; blockOffset < offset + size; blockOffset += ChecksumBlockSize) {
+            const auto blockSize = std::min<u64>(ChecksumBlockSize, m_data.size() - blockOffset);
+            m_blockChecksums[blockOffset / ChecksumBlockSize] = calculateChecksum({ m_data.data() + blockOffset, blockSize });
+        }
+    }
+
+    bool FileProvider::reloadChangedBlocks() {
+        if (!m_loadedIntoMemory || m_layoutChanged)
+            return false;
+
+        this->waitUntilLoaded();
+        if (m_blockChecksums.size() != getBlockCount(m_data.size()))
+            return false;
+
+        const auto &path = getPickedPath();
+        wolv::io::File file(path, wolv::io::File::Mode::Read);
+        if (!file.isValid())
+            return false;
+
+        const auto newSize = file.getSize();
+        if (newSize == 0)
+            return false;
+
+        // Blocks whose checksum still matches the one of the loaded data are identical and don't have to be copied again.
+        // Modifications made since loading are left in place there, they're being reapplied on top of the reloaded data anyway
+        const auto oldBlockCount = m_blockChecksums.size();
+        m_viewedData.detach(m_data);
+        m_data.resize(newSize);
+        m_fileSize = newSize;
+        m_loadedSize = newSize;
+        m_blockChecksums.resize(getBlockCount(newSize));
+
+        std::vector<u8> buffer(ChecksumBlockSize);
+        u64 changedSize = 0;
+        for (u64 block = 0; block < m_blockChecksums.size(); block += 1) {
+            const auto offset = block * ChecksumBlockSize;
+            const auto size = std::min<u64>(ChecksumBlockSize, newSize - offset);
+            file.readBufferAtomic(offset, buffer.data(), size);
+
+            const auto checksum = calculateChecksum({ buffer.data(), size });
+            if (block < oldBlockCount && m_blockChecksums[block] == checksum)
+                continue;
+
+            std::memcpy(m_data.data() + offset, buffer.data(), size);
+            m_blockChecksums[block] = checksum;
+            changedSize += size;
+        }
+
+        m_fileStats = file.getFileInfo();
+        log::info("Reloaded {} of changed data from '{}'", hex::toByteString(changedSize), wolv::util::toUTF8String(path));
+
+        return true;
+    }
+
+    void FileProvider::mapFile() {
+        this->unmapFile();
+
+        if (!m_file.isValid())
+            return;
+
+        const auto fileSize = m_file.getSize();
+        if (fileSize == 0 || fileSize > std::numeric_limits<size_t>::max())
+            return;
+
+        auto mapping = std::make_shared<FileMapping>();
+
+        #if defined(OS_WINDOWS)
+
+            auto fileHandle = HANDLE(_get_osfhandle(_fileno(m_file.getHandle())));
+            HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mappingHandle == nullptr) {
+                log::warn("Failed to create file mapping for '{}': {}", wolv::util::toUTF8String(m_file.getPath()), formatSystemError(GetLastError()));
+                return;
+            }
+
+            auto view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+            if (view == nullptr) {
+                log::warn("Failed to map view of '{}': {}", wolv::util::toUTF8String(m_file.getPath()), formatSystemError(GetLastError()));
+                CloseHandle(mappingHandle);
+                return;
+            }
+
+            mapping->handle = mappingHandle;
+            mapping->data   = static_cast<const u8*>(view);
+            mapping->size   = fileSize;
+
+        #elif defined(OS_MACOS) || defined(OS_LINUX) || defined(OS_FREEBSD)
+
+            auto view = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, ::fileno(m_file.getHandle()), 0);
+            if (view == MAP_FAILED) {
+                log::warn("Failed to map '{}': {}", wolv::util::toUTF8String(m_file.getPath()), formatSystemError(errno));
+                return;
+            }
+
+            // The hex editor jumps around in the file, don't let the kernel read ahead by default
+            ::madvise(view, fileSize, MADV_RANDOM);
+
+            mapping->data = static_cast<const u8*>(view);
+            mapping->size = fileSize;
+
+        #endif
+
+        std::unique_lock lock(m_mappingMutex);
+        m_mapping = std::move(mapping);
+
+        m_lastReadEnd = 0;
+        m_sequentialReadCount = 0;
+        m_randomReadCount = 0;
+        m_sequentialAccessAdvised = false;
+    }
+
+    void FileProvider::unmapFile() {
+        // Views that are still in use keep the old mapping alive, it's released together with the last of them
+        std::shared_ptr<const FileMapping> mapping;
+        {
+            std::unique_lock lock(m_mappingMutex);
+            mapping = std::move(m_mapping);
+        }
+    }
+
+    void FileProvider::updateAccessPattern(const FileMapping &mapping, u64 offset, size_t size) {
+        // Scans like searching or hashing read the file front to back. Once that pattern is detected,
+        // tell the kernel so it can read ahead aggressively. Switch back as soon as reads start jumping around again
+        const bool sequential = m_lastReadEnd.exchange(offset + size) == offset;
+        if (sequential) {
+            m_randomReadCount = 0;
+            if (m_sequentialReadCount < SequentialReadThreshold)
+                m_sequentialReadCount += 1;
+        } else {
+            m_sequentialReadCount = 0;
+            if (m_randomReadCount < RandomReadThreshold)
+                m_randomReadCount += 1;
+        }
+
+        bool adviseSequential;
+        if (!m_sequentialAccessAdvised && m_sequentialReadCount >= SequentialReadThreshold)
+            adviseSequential = true;
+        else if (m_sequentialAccessAdvised && m_randomReadCount >= RandomReadThreshold)
+            adviseSequential = false;
+        else
+            return;
+
+        if (m_sequentialAccessAdvised.exchange(adviseSequential) == adviseSequential)
+            return;
+
+        #if defined(OS_MACOS) || defined(OS_LINUX) || defined(OS_FREEBSD)
+            ::madvise(const_cast<u8*>(mapping.data), mapping.size, adviseSequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+        #else
+            std::ignore = mapping;
+        #endif
+    }
 
 }
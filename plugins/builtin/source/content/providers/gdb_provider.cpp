@@ -1,6 +1,8 @@
 #include "content/providers/gdb_provider.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <deque>
 #include <thread>
 #include <chrono>
 
@@ -9,10 +11,12 @@
 
 #include <hex/helpers/fmt.hpp>
 #include <hex/helpers/crypto.hpp>
+#include <hex/helpers/utils.hpp>
 #include <hex/api/localization_manager.hpp>
 #include <hex/helpers/logger.hpp>
 
 #include <nlohmann/json.hpp>
+#include <wolv/utils/string.hpp>
 
 namespace hex::plugin::builtin {
 
@@ -21,10 +25,18 @@ namespace hex::plugin::builtin {
     namespace gdb {
 
         namespace {
-            u8 calculateChecksum(const std::string &data) {
+            constexpr static size_t MaxPacketSize    = 0x4'0000;
+            constexpr static size_t PipelineDepth    = 8;
+            constexpr static size_t ReceiveChunkSize = 0x1'0000;
+            constexpr static auto ResponseTimeout    = 2s;
+
+            // Data read ahead is only handed out for a short while so a running target can't keep serving outdated memory from it
+            constexpr static auto ReadaheadLifetime  = 250ms;
+
+            u8 calculateChecksum(std::string_view data) {
                 u64 checksum = 0;
                 for (const auto &c : data)
-                    checksum += c;
+                    checksum += static_cast<u8>(c);
                 return checksum & 0xFF;
             }
 
@@ -36,7 +48,7 @@ namespace hex::plugin::builtin {
                 if (packet.length() < 4 || packet[0] != '$')
                     return std::nullopt;
 
-                size_t hashPos = packet.find('#');
+                size_t hashPos = packet.rfind('#');
                 if (hashPos == std::string::npos || hashPos + 2 >= packet.size())
                     return std::nullopt;
 
@@ -54,134 +66,330 @@ namespace hex::plugin::builtin {
                 socket.writeString("+");
             }
 
-            char readCharacter(const wolv::net::SocketClient &socket) {
-                auto data = socket.readBytes(1);
-                return data.empty() ? '\0' : static_cast<char>(data[0]);
+            void sendNak(const wolv::net::SocketClient &socket) {
+                socket.writeString("-");
             }
 
-            std::string sendReceivePackage(const wolv::net::SocketClient &socket, const std::string &packet) {
-                socket.writeString(packet);
+            /**
+             * @brief Data received from the server that hasn't been processed yet
+             * @note Reading from the socket one character at a time is way too slow for large memory reads
+             */
+            struct ReceiveBuffer {
+                std::vector<u8> data;
+                size_t position = 0;
+            };
+
+            std::optional<char> readCharacter(const wolv::net::SocketClient &socket, ReceiveBuffer &buffer) {
+                if (buffer.position >= buffer.data.size()) {
+                    const auto start = std::chrono::steady_clock::now();
+                    std::chrono::microseconds delay = 50us;
+
+                    while (true) {
+                        buffer.data = socket.readBytes(ReceiveChunkSize);
+                        buffer.position = 0;
+
+                        if (!buffer.data.empty())
+                            break;
+
+                        if (!socket.isConnected() || std::chrono::steady_clock::now() - start > ResponseTimeout)
+                            return std::nullopt;
+
+                        // No data yet, wait a bit longer every time before trying again
+                        std::this_thread::sleep_for(delay);
+                        delay = std::min<std::chrono::microseconds>(delay * 2, 10ms);
+                    }
+                }
 
-                i32 retries = 20;
+                return static_cast<char>(buffer.data[buffer.position++]);
+            }
 
-                std::string buffer;
+            /**
+             * @brief Receives the next packet or NAK from the server, skipping over any ACKs
+             * @return The raw packet including its framing, "-" for a NAK or std::nullopt if the server didn't respond in time
+             */
+            std::optional<std::string> receivePacket(const wolv::net::SocketClient &socket, ReceiveBuffer &buffer) {
                 while (true) {
-                    char c = readCharacter(socket);
-                    if (c == '+') {
-                        // ACK response, continue reading
+                    auto c = readCharacter(socket, buffer);
+                    if (!c.has_value())
+                        return std::nullopt;
+
+                    if (*c == '-')
+                        return "-";
+                    else if (*c != '$')
                         continue;
-                    } else if (c == '$') {
-                        // Start of response packet
-                        buffer += c;
-
-                        // Read until the end of the packet
-                        while (true) {
-                            c = readCharacter(socket);
-                            buffer += c;
-                            if (c == '#')
-                                break;
-                        }
-
-                        // Read the checksum
-                        buffer += readCharacter(socket);
-                        buffer += readCharacter(socket);
+
+                    // Binary data has '#' escaped so the first one always marks the end of the packet
+                    std::string packet(1, '$');
+                    do {
+                        c = readCharacter(socket, buffer);
+                        if (!c.has_value())
+                            return std::nullopt;
+
+                        packet += *c;
+                    } while (*c != '#');
+
+                    // Read the checksum
+                    for (u32 i = 0; i < 2; i += 1) {
+                        c = readCharacter(socket, buffer);
+                        if (!c.has_value())
+                            return std::nullopt;
+
+                        packet += *c;
+                    }
+
+                    return packet;
+                }
+            }
+
+            std::optional<std::string> sendReceivePackage(const wolv::net::SocketClient &socket, const std::string &packet, bool ackMode = true) {
+                socket.writeString(packet);
+
+                ReceiveBuffer buffer;
+                i32 retries = 20;
+                while (retries > 0) {
+                    auto receivedPacket = receivePacket(socket, buffer);
+                    if (!receivedPacket.has_value())
                         break;
-                    } else if (c == '-') {
+
+                    if (*receivedPacket == "-") {
                         // NAK response, retry sending the packet
                         socket.writeString(packet);
                         retries -= 1;
-                    } else if (c == 0x00) {
-                        // No response, wait a bit and retry receiving data
-                        std::this_thread::sleep_for(10ms);
-                        retries -= 1;
+                        continue;
                     }
 
-                    if (retries <= 0) {
-                        log::error("No response from GDB server after multiple retries");
-                        return {};
+                    auto data = parsePacket(*receivedPacket);
+                    if (!ackMode)
+                        return data;
+
+                    if (data.has_value()) {
+                        sendAck(socket);
+                        return data;
                     }
+
+                    // Corrupted response, ask the server to send it again
+                    sendNak(socket);
+                    retries -= 1;
                 }
 
-                if (!buffer.empty())
-                    sendAck(socket);
+                log::error("No response from GDB server after multiple retries");
+                return std::nullopt;
+            }
+
+            /**
+             * @brief Expands run-length encoded data. "X*n" stands for X followed by n - 29 more copies of X
+             */
+            std::optional<std::string> expandRunLength(std::string_view data) {
+                std::string expanded;
+                expanded.reserve(data.size());
+
+                for (size_t i = 0; i < data.size(); i += 1) {
+                    if (data[i] != '*') {
+                        expanded.push_back(data[i]);
+                        continue;
+                    }
+
+                    if (expanded.empty() || i + 1 >= data.size())
+                        return std::nullopt;
 
-                return buffer;
+                    const int repeatCount = static_cast<u8>(data[i + 1]) - 29;
+                    if (repeatCount <= 0)
+                        return std::nullopt;
+
+                    expanded.append(repeatCount, expanded.back());
+                    i += 1;
+                }
+
+                return expanded;
+            }
+
+            std::optional<u8> decodeNibble(char c) {
+                if (c >= '0' && c <= '9')
+                    return c - '0';
+                else if (c >= 'a' && c <= 'f')
+                    return c - 'a' + 0x0A;
+                else if (c >= 'A' && c <= 'F')
+                    return c - 'A' + 0x0A;
+                else
+                    return std::nullopt;
             }
 
             std::vector<u8> decodeMemoryResponse(const std::string &response) {
-                std::string expanded;
-                size_t i = 0;
+                auto expanded = expandRunLength(response);
+                if (!expanded.has_value() || expanded->size() % 2 != 0)
+                    return {};
+
+                std::vector<u8> decoded;
+                decoded.reserve(expanded->size() / 2);
+                for (size_t i = 0; i < expanded->size(); i += 2) {
+                    const auto high = decodeNibble((*expanded)[i]);
+                    const auto low  = decodeNibble((*expanded)[i + 1]);
+                    if (!high.has_value() || !low.has_value())
+                        return {};
 
-                while (i < response.size()) {
-                    char c = response[i];
+                    decoded.push_back((*high << 4) | *low);
+                }
 
-                    if (i + 2 < response.size() && response[i + 1] == '*') {
-                        char repeatChar = response[i + 2];
-                        int repeatCount = static_cast<unsigned char>(repeatChar) - 29;
+                return decoded;
+            }
 
-                        if (repeatCount <= 0)
-                            return {};
+            std::vector<u8> decodeBinaryResponse(std::string_view response) {
+                auto expanded = expandRunLength(response);
+                if (!expanded.has_value())
+                    return {};
 
-                        expanded.append(repeatCount, c);
-                        i += 3;
+                // '#', '$', '*' and '}' are sent as '}' followed by the original byte XOR 0x20
+                std::vector<u8> decoded;
+                decoded.reserve(expanded->size());
+                for (size_t i = 0; i < expanded->size(); i += 1) {
+                    if ((*expanded)[i] == '}' && i + 1 < expanded->size()) {
+                        decoded.push_back(static_cast<u8>((*expanded)[i + 1]) ^ 0x20);
+                        i += 1;
                     } else {
-                        expanded.push_back(c);
-                        i++;
+                        decoded.push_back(static_cast<u8>((*expanded)[i]));
                     }
                 }
 
-                if (expanded.size() % 2 != 0)
-                    return {};
+                return decoded;
+            }
 
-                std::vector<u8> decoded;
-                for (size_t j = 0; j < expanded.size(); j += 2) {
-                    std::string byteStr = expanded.substr(j, 2);
+        }
+
+        ServerFeatures negotiateFeatures(const wolv::net::SocketClient &socket) {
+            ServerFeatures features;
+
+            auto response = sendReceivePackage(socket, createPacket("qSupported:binary-upload+"));
+            if (!response.has_value())
+                return features;
+
+            for (const auto &feature : wolv::util::splitString(*response, ";")) {
+                if (feature.starts_with("PacketSize=")) {
                     try {
-                        u8 byte = static_cast<u8>(std::stoul(byteStr, nullptr, 16));
-                        decoded.push_back(byte);
+                        features.packetSize = std::clamp<size_t>(std::stoull(feature.substr(11), nullptr, 16), 0x20, MaxPacketSize);
                     } catch (...) {
-                        return { };
+                        log::warn("GDB server reported invalid packet size '{}'", feature);
                     }
+                } else if (feature == "binary-upload+") {
+                    features.binaryUpload = true;
+                } else if (feature == "QStartNoAckMode+") {
+                    features.noAckMode = true;
                 }
-
-                return decoded;
             }
 
+            // Without ACKs, requests can be sent without waiting for the previous response first
+            if (features.noAckMode)
+                features.noAckMode = sendReceivePackage(socket, createPacket("QStartNoAckMode")) == "OK";
 
+            return features;
         }
 
-        std::vector<u8> readMemory(const wolv::net::SocketClient &socket, u64 address, size_t size) {
-            std::string packet = createPacket(fmt::format("m{:X},{:X}", address, size));
-
-            std::string receivedPacket = sendReceivePackage(socket, packet);
+        bool readMemory(const wolv::net::SocketClient &socket, const ServerFeatures &features, u64 address, void *buffer, size_t size) {
+            struct Piece {
+                u64 address;
+                u8 *buffer;
+                size_t size;
+            };
+
+            // Hex encoded responses need two characters per byte. Binary responses that don't fit into a packet
+            // because of escaped bytes are cut short by the server and the rest is requested again below
+            const size_t maxPieceSize = features.binaryUpload ? features.packetSize - 1 : features.packetSize / 2;
+
+            std::deque<Piece> pending;
+            for (size_t offset = 0; offset < size; offset += maxPieceSize)
+                pending.push_back({ address + offset, static_cast<u8 *>(buffer) + offset, std::min(maxPieceSize, size - offset) });
+
+            const auto createRequest = [&](const Piece &piece) {
+                return createPacket(fmt::format("{}{:X},{:X}", features.binaryUpload ? 'x' : 'm', piece.address, piece.size));
+            };
+
+            std::deque<Piece> inFlight;
+            ReceiveBuffer receiveBuffer;
+            bool success = true;
+
+            while (!pending.empty() || !inFlight.empty()) {
+                Piece piece;
+                std::optional<std::string> response;
+
+                if (features.noAckMode) {
+                    // Keep multiple requests in flight to not have to wait for a full round trip for every single packet
+                    std::string requests;
+                    while (!pending.empty() && inFlight.size() < PipelineDepth) {
+                        requests += createRequest(pending.front());
+                        inFlight.push_back(pending.front());
+                        pending.pop_front();
+                    }
+                    if (!requests.empty())
+                        socket.writeString(requests);
+
+                    piece = inFlight.front();
+                    inFlight.pop_front();
+
+                    // Responses arrive in the same order the requests were sent in
+                    auto receivedPacket = receivePacket(socket, receiveBuffer);
+                    if (receivedPacket.has_value())
+                        response = parsePacket(*receivedPacket);
+                } else {
+                    // Servers that expect ACKs discard everything they receive while waiting for one, so only one request can be sent at a time
+                    piece = pending.front();
+                    pending.pop_front();
+
+                    response = sendReceivePackage(socket, createRequest(piece));
+                }
 
-            auto receivedData = parsePacket(receivedPacket);
-            if (!receivedData.has_value())
-                return {};
+                if (!response.has_value()) {
+                    // Once a response went missing, there's no way to tell which of the remaining ones belongs to which request anymore
+                    log::error("Failed to read memory at 0x{:X} from GDB server", piece.address);
+                    std::memset(piece.buffer, 0x00, piece.size);
+                    for (const auto &remaining : pending)
+                        std::memset(remaining.buffer, 0x00, remaining.size);
+                    for (const auto &remaining : inFlight)
+                        std::memset(remaining.buffer, 0x00, remaining.size);
+
+                    // The replies to the requests still in flight would otherwise be picked up by the next request as its own.
+                    // If one of them doesn't arrive either, the connection is dead anyway
+                    for (; !inFlight.empty(); inFlight.pop_front()) {
+                        if (!receivePacket(socket, receiveBuffer).has_value())
+                            break;
+                    }
 
-            sendAck(socket);
+                    return false;
+                }
 
-            if (receivedData->size() == 3 && receivedData->starts_with("E"))
-                return {};
+                std::vector<u8> data;
+                if (features.binaryUpload && response->starts_with('b'))
+                    data = decodeBinaryResponse(std::string_view(*response).substr(1));
+                else if (!features.binaryUpload && !(response->size() == 3 && response->starts_with('E')))
+                    data = decodeMemoryResponse(*response);
+
+                const auto bytesRead = std::min(data.size(), piece.size);
+                std::memcpy(piece.buffer, data.data(), bytesRead);
+
+                if (bytesRead == 0) {
+                    // Memory isn't readable or the server didn't understand the request
+                    std::memset(piece.buffer, 0x00, piece.size);
+                    success = false;
+                } else if (bytesRead < piece.size) {
+                    pending.push_back({ piece.address + bytesRead, piece.buffer + bytesRead, piece.size - bytesRead });
+                }
+            }
 
-            auto data = decodeMemoryResponse(*receivedData);
-            data.resize(size);
-            return data;
+            return success;
         }
 
-        bool writeMemory(const wolv::net::SocketClient &socket, u64 address, const void *buffer, size_t size) {
-            std::vector<u8> bytes(size);
-            std::memcpy(bytes.data(), buffer, size);
-            std::string byteString = crypt::encode16(bytes);
+        bool writeMemory(const wolv::net::SocketClient &socket, const ServerFeatures &features, u64 address, const void *buffer, size_t size) {
+            // Leave some room for the command and address in front of the hex encoded data
+            const size_t maxPieceSize = (features.packetSize - 0x20) / 2;
 
-            std::string packet = createPacket(fmt::format("M{:X},{:X}:{}", address, size, byteString));
+            const auto bytes = static_cast<const u8 *>(buffer);
+            for (size_t offset = 0; offset < size; offset += maxPieceSize) {
+                const auto pieceSize = std::min(maxPieceSize, size - offset);
+                const auto byteString = crypt::encode16({ bytes + offset, bytes + offset + pieceSize });
 
-            std::string receivedPacket = sendReceivePackage(socket, packet);
-            auto receivedData = parsePacket(receivedPacket);
-            if (!receivedData.has_value() || *receivedData != "OK")
-                return false;
+                const auto packet = createPacket(fmt::format("M{:X},{:X}:{}", address + offset, pieceSize, byteString));
+                if (sendReceivePackage(socket, packet, !features.noAckMode) != "OK")
+                    return false;
+            }
 
-            sendAck(socket);
             return true;
         }
 
@@ -215,9 +423,34 @@ namespace hex::plugin::builtin {
         if (!m_socket.isConnected())
             return;
 
-        auto data = gdb::readMemory(m_socket, offset, size);
-        if (!data.empty())
-            std::memcpy(buffer, data.data(), data.size());
+        const bool sequential = offset == m_nextSequentialOffset;
+        m_nextSequentialOffset = offset + size;
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - m_readaheadTime > gdb::ReadaheadLifetime)
+            m_readaheadData.clear();
+
+        if (offset >= m_readaheadAddress && offset + size <= m_readaheadAddress + m_readaheadData.size()) {
+            std::memcpy(buffer, m_readaheadData.data() + (offset - m_readaheadAddress), size);
+            return;
+        }
+
+        // When blocks are being read one after another, fetch the following ones in the same go. With pipelining that's
+        // one full pipeline of requests, which takes barely longer than the round trip needed for the requested block alone
+        u64 readaheadSize = 0;
+        if (sequential && offset + size < m_size) {
+            const auto packetCount = m_features.noAckMode ? gdb::PipelineDepth : 1;
+            const auto packetDataSize = m_features.binaryUpload ? m_features.packetSize : m_features.packetSize / 2;
+            readaheadSize = std::min<u64>(packetCount * packetDataSize, m_size - (offset + size));
+        }
+
+        std::vector<u8> data(size + readaheadSize);
+        gdb::readMemory(m_socket, m_features, offset, data.data(), data.size());
+        std::memcpy(buffer, data.data(), size);
+
+        m_readaheadAddress = offset + size;
+        m_readaheadData.assign(data.begin() + size, data.end());
+        m_readaheadTime = now;
     }
 
     void GDBProvider::writeToSource(u64 offset, const void *buffer, size_t size) {
@@ -225,11 +458,19 @@ namespace hex::plugin::builtin {
         if (!m_socket.isConnected())
             return;
 
-        gdb::writeMemory(m_socket, offset, buffer, size);
+        m_readaheadData.clear();
+        gdb::writeMemory(m_socket, m_features, offset, buffer, size);
+    }
+
+    void GDBProvider::onCacheCleared() {
+        // Whatever got read ahead is just as outdated as the blocks that were dropped
+        std::scoped_lock lock(m_mutex);
+        m_readaheadData.clear();
+        m_nextSequentialOffset = 0;
     }
 
     void GDBProvider::save() {
-        Provider::save();
+        CachedProvider::save();
     }
 
     u64 GDBProvider::getSourceSize() const {
@@ -249,8 +490,11 @@ namespace hex::plugin::builtin {
     }
 
     std::vector<GDBProvider::Description> GDBProvider::getDataDescription() const {
+        const auto cacheStatistics = this->getCacheStatistics();
+
         return {
             {"hex.builtin.provider.gdb.server"_lang, fmt::format("{}:{}", m_ipAddress, m_port)},
+            {"hex.builtin.provider.cache_statistics"_lang, fmt::format("hex.builtin.provider.cache_statistics.value"_lang, cacheStatistics.hits, cacheStatistics.misses, cacheStatistics.evictions, hex::toByteString(cacheStatistics.bytesFetched))},
         };
     }
 
@@ -258,12 +502,14 @@ namespace hex::plugin::builtin {
         CachedProvider::open();
         std::scoped_lock lock(m_mutex);
 
-        CachedProvider::open();
         m_socket = wolv::net::SocketClient(wolv::net::SocketClient::Type::TCP, false);
         m_socket.connect(m_ipAddress, m_port);
 
-        gdb::sendReceivePackage(m_socket, gdb::createPacket("!"));
-        gdb::sendReceivePackage(m_socket, gdb::createPacket("Hg0"));
+        m_features = gdb::negotiateFeatures(m_socket);
+        log::info("Connected to GDB server with packet size 0x{:X}, binary reads {}, pipelining {}", m_features.packetSize, m_features.binaryUpload, m_features.noAckMode);
+
+        gdb::sendReceivePackage(m_socket, gdb::createPacket("!"), !m_features.noAckMode);
+        gdb::sendReceivePackage(m_socket, gdb::createPacket("Hg0"), !m_features.noAckMode);
 
         if (!m_socket.isConnected()) {
             return OpenResult::failure("hex.builtin.provider.gdb.server.error.not_connected"_lang);
@@ -273,12 +519,15 @@ namespace hex::plugin::builtin {
     }
 
     void GDBProvider::close() {
-        std::scoped_lock lock(m_mutex);
-
+        // Flushing the cache writes to the target and clearing it drops the data read ahead, both of which lock the mutex themselves
         CachedProvider::close();
+
+        std::scoped_lock lock(m_mutex);
         m_socket.disconnect();
 
-        CachedProvider::close();
+        m_features = { };
+        m_nextSequentialOffset = 0;
+        m_readaheadData.clear();
     }
 
     bool GDBProvider::isConnected() const {
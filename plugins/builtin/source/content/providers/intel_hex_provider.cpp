@@ -1,10 +1,16 @@
 #include "content/providers/intel_hex_provider.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <future>
+#include <optional>
+#include <ranges>
+#include <thread>
 
 #include <hex/api/imhex_api/hex_editor.hpp>
 #include <hex/api/localization_manager.hpp>
 #include <hex/helpers/fmt.hpp>
+#include <hex/helpers/literals.hpp>
 #include <hex/helpers/logger.hpp>
 #include <hex/helpers/scaling.hpp>
 #include <hex/helpers/utils.hpp>
@@ -18,6 +24,15 @@
 
 namespace hex::plugin::builtin {
 
+    using namespace hex::literals;
+
+    namespace {
+
+        // Files smaller than this are parsed on a single thread
+        constexpr static size_t MinParseChunkSize = 4_MiB;
+
+    }
+
     namespace intel_hex {
 
         u8 parseHexDigit(char c) {
@@ -31,27 +46,21 @@ namespace hex::plugin::builtin {
                 throw std::runtime_error("Failed to parse hex digit");
         }
 
-        wolv::util::Expected<std::map<u64, std::vector<u8>>, std::string> parseIntelHex(const std::string &string) {
-            std::map<u64, std::vector<u8>> result;
+        enum class RecordType: u8 {
+            Data                    = 0x00,
+            EndOfFile               = 0x01,
+            ExtendedSegmentAddress  = 0x02,
+            StartSegmentAddress     = 0x03,
+            ExtendedLinearAddress   = 0x04,
+            StartLinearAddress      = 0x05
+        };
+
+        IntelHexProvider::RecordChunk parseRecords(std::string_view string) {
+            IntelHexProvider::RecordChunk result;
 
             u8 checksum = 0x00;
             u64 offset = 0x00;
 
-            u8  byteCount = 0x00;
-            u32 segmentAddress = 0x0000'0000;
-            u32 extendedLinearAddress = 0x0000'0000;
-            u16 address = 0x0000;
-            std::vector<u8> data;
-
-            enum class RecordType: u8 {
-                Data                    = 0x00,
-                EndOfFile               = 0x01,
-                ExtendedSegmentAddress  = 0x02,
-                StartSegmentAddress     = 0x03,
-                ExtendedLinearAddress   = 0x04,
-                StartLinearAddress      = 0x05
-            } recordType;
-
             auto c = [&] {
                 while (offset < string.length() && std::isspace(string[offset]))
                     offset++;
@@ -76,43 +85,67 @@ namespace hex::plugin::builtin {
                 return value;
             };
 
-            bool endOfFile = false;
-            try {
-                while (offset < string.length()) {
-                    // Parse start code
-                    if (c() != ':')
-                        return { };
+            while (offset < string.length()) {
+                // Parse start code
+                if (c() != ':') {
+                    result.invalid = true;
+                    return result;
+                }
 
-                    checksum = 0x00;
+                checksum = 0x00;
 
-                    if (endOfFile)
-                        throw std::runtime_error("Unexpected end of file");
+                // Parse byte count
+                const u8 byteCount = parseValue(1);
 
-                    // Parse byte count
-                    byteCount = parseValue(1);
+                // Parse address
+                const u16 address = parseValue(2);
 
-                    // Parse address
-                    address = parseValue(2);
+                // Parse record type
+                const u8 recordType = parseValue(1);
 
-                    // Parse record type
-                    recordType = static_cast<RecordType>(parseValue(1));
+                const auto dataOffset = result.data.size();
+                for (u32 i = 0; i < byteCount; i++) {
+                    result.data.push_back(parseValue(1));
+                }
 
-                    data.clear();
-                    for (u32 i = 0; i < byteCount; i++) {
-                        data.push_back(parseValue(1));
-                    }
+                parseValue(1);
+                if (byteCount != 0 && checksum != 0x00)
+                    throw std::runtime_error("Checksum mismatch");
 
-                    parseValue(1);
-                    if (!data.empty() && checksum != 0x00)
-                        throw std::runtime_error("Checksum mismatch");
+                result.records.push_back({ .type=recordType, .address=address, .dataOffset=dataOffset, .dataSize=byteCount });
+
+                while (offset < string.length() && std::isspace(string[offset]))
+                    offset++;
+            }
+
+            return result;
+        }
+
+        wolv::util::Expected<std::vector<IntelHexProvider::DataBlock>, std::string> resolveAddresses(const std::vector<IntelHexProvider::RecordChunk> &chunks) {
+            std::vector<IntelHexProvider::DataBlock> result;
+
+            // Address records change the address of all data records following them, so this needs to be done in file order
+            u32 segmentAddress = 0x0000'0000;
+            u32 extendedLinearAddress = 0x0000'0000;
+            bool endOfFile = false;
+
+            for (const auto &chunk : chunks) {
+                // Files that contain anything else than records are treated as not containing any data
+                if (chunk.invalid)
+                    return std::vector<IntelHexProvider::DataBlock>{ };
+            }
+
+            for (const auto &chunk : chunks) {
+                for (const auto &record : chunk.records) {
+                    if (endOfFile)
+                        return wolv::util::Unexpected<std::string>("Unexpected end of file");
 
-                    while (offset < string.length() && std::isspace(string[offset]))
-                        offset++;
+                    const auto data = chunk.getData(record);
 
                     // Construct region
-                    switch (recordType) {
+                    switch (static_cast<RecordType>(record.type)) {
                         case RecordType::Data: {
-                            result[extendedLinearAddress | (segmentAddress + address)] = data;
+                            result.push_back({ .address=extendedLinearAddress | (segmentAddress + u32(record.address)), .data=data });
                             break;
                         }
                         case RecordType::EndOfFile: {
@@ -120,41 +153,35 @@ namespace hex::plugin::builtin {
                             break;
                         }
                         case RecordType::ExtendedSegmentAddress: {
-                            if (byteCount != 2)
-                                throw std::runtime_error("Unexpected byte count");
+                            if (data.size() != 2)
+                                return wolv::util::Unexpected<std::string>("Unexpected byte count");
 
                             segmentAddress = (data[0] << 8 | data[1]) * 16;
                             break;
                         }
                         case RecordType::StartSegmentAddress: {
-                            if (byteCount != 4)
-                                throw std::runtime_error("Unexpected byte count");
+                            if (data.size() != 4)
+                                return wolv::util::Unexpected<std::string>("Unexpected byte count");
 
                             // Can be safely ignored
                             break;
                         }
                         case RecordType::ExtendedLinearAddress: {
-                            if (byteCount != 2)
-                                throw std::runtime_error("Unexpected byte count");
+                            if (data.size() != 2)
+                                return wolv::util::Unexpected<std::string>("Unexpected byte count");
 
                             extendedLinearAddress = (data[0] << 8 | data[1]) << 16;
                             break;
                         }
                         case RecordType::StartLinearAddress: {
-                            if (byteCount != 4)
-                                throw std::runtime_error("Unexpected byte count");
+                            if (data.size() != 4)
+                                return wolv::util::Unexpected<std::string>("Unexpected byte count");
 
                             // Can be safely ignored
                             break;
                         }
                     }
-
-                    while (offset < string.length() && std::isspace(string[offset]))
-                        offset++;
                 }
-
-            } catch (const std::runtime_error &e) {
-                return wolv::util::Unexpected<std::string>(e.what());
             }
 
             return result;
@@ -162,32 +189,77 @@ namespace hex::plugin::builtin {
 
     }
 
-    void IntelHexProvider::setBaseAddress(u64 address) {
-        auto oldBase = this->getBaseAddress();
+    wolv::util::Expected<std::vector<IntelHexProvider::RecordChunk>, std::string> IntelHexProvider::parseChunks(std::string_view string, char startCode, const ChunkParser &parser) {
+        // Split the file up into roughly equally sized chunks. Chunks always start at the start code of a record,
+        // which can't appear anywhere else in a valid file
+        const auto chunkCount = std::clamp<size_t>(string.size() / MinParseChunkSize, 1, std::max<size_t>(std::thread::hardware_concurrency(), 1));
 
-        auto regions = m_data.overlapping({ .start=oldBase, .end=oldBase + this->getActualSize() });
+        std::vector<std::string_view> chunks;
+        size_t chunkStart = 0;
+        for (size_t i = 1; i < chunkCount; i += 1) {
+            const auto chunkEnd = string.find(startCode, std::max(chunkStart + 1, (string.size() / chunkCount) * i));
+            if (chunkEnd == std::string_view::npos)
+                break;
 
-        decltype(m_data) newIntervals;
-        for (auto &[interval, data] : regions) {
-            newIntervals.insert({ .start=interval.start - oldBase + address, .end=interval.end - oldBase + address }, *data);
+            chunks.push_back(string.substr(chunkStart, chunkEnd - chunkStart));
+            chunkStart = chunkEnd;
         }
-        m_data = newIntervals;
+        chunks.push_back(string.substr(chunkStart));
+
+        std::vector<std::future<RecordChunk>> futures;
+        for (const auto &chunk : chunks | std::views::drop(1))
+            futures.push_back(std::async(std::launch::async, parser, chunk));
+
+        std::vector<RecordChunk> result;
+        std::optional<std::string> error;
+
+        const auto collect = [&](auto &&function) {
+            try {
+                result.push_back(function());
+            } catch (const std::runtime_error &e) {
+                // Keep the error of the first chunk that failed, but still wait for all other chunks to finish
+                if (!error.has_value())
+                    error = e.what();
+            }
+        };
+
+        collect([&] { return parser(chunks.front()); });
+        for (auto &future : futures)
+            collect([&] { return future.get(); });
+
+        if (error.has_value())
+            return wolv::util::Unexpected<std::string>(*error);
 
-        Provider::setBaseAddress(address);
+        return result;
     }
 
     void IntelHexProvider::readRaw(u64 offset, void *buffer, size_t size) {
-        auto intervals = m_data.overlapping({ .start=offset, .end=(offset + size) - 1 });
-
         std::memset(buffer, 0x00, size);
+
         auto bytes = static_cast<u8*>(buffer);
-        for (const auto &[interval, data] : intervals) {
-            for (u32 i = std::max(interval.start, offset); i <= interval.end && (i - offset) < size; i++) {
-                bytes[i - offset] = (*data)[i - interval.start];
-            }
+        for (auto it = this->findExtent(offset); it != m_extents.end() && it->address < offset + size; ++it) {
+            const auto start = std::max(it->address, offset);
+            const auto end   = std::min(it->getEndAddress() + 1, offset + size);
+
+            std::memcpy(bytes + (start - offset), it->data.data() + (start - it->address), end - start);
         }
     }
 
+    std::optional<prv::Provider::ContiguousView> IntelHexProvider::tryGetContiguousViewRaw(u64 offset, size_t size) {
+        const auto it = this->findExtent(offset);
+        if (size == 0 || it == m_extents.end() || it->address > offset || offset + size - 1 > it->getEndAddress())
+            return std::nullopt;
+
+        return ContiguousView({ it->data.data() + (offset - it->address), size });
+    }
+
+    std::vector<IntelHexProvider::Extent>::const_iterator IntelHexProvider::findExtent(u64 address) const {
+        // Find the first extent that ends at or after the address
+        return std::ranges::partition_point(m_extents, [address](const Extent &extent) {
+            return extent.getEndAddress() < address;
+        });
+    }
+
     void IntelHexProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
         std::ignore = offset;
         std::ignore = buffer;
@@ -198,41 +270,33 @@ namespace hex::plugin::builtin {
         return m_dataSize;
     }
 
-    void IntelHexProvider::processMemoryRegions(wolv::util::Expected<std::map<u64, std::vector<u8>>, std::string> data) {
-        std::optional<u64> maxAddress;
-        bool firstAddress = true;
-        u64 regionStartAddr = 0;
-        u32 prevAddrEnd = 0;
-        u32 blockIdx = 0;
-        u64 blockSize = 0;
-
-        for (auto &[address, bytes] : data.value()) {
-            auto endAddress = (address + bytes.size()) - 1;
-            if (firstAddress) {
-                regionStartAddr = address;
-                firstAddress = false;
-            } else {
-                if (address > (prevAddrEnd + 1)) {
-                    m_memoryRegions.emplace_back(Region(regionStartAddr, blockSize), fmt::format("Block {}", blockIdx));
-                    regionStartAddr = address;
-                    blockSize = 0;
-                    blockIdx++;
-                }
+    void IntelHexProvider::processMemoryRegions(std::vector<DataBlock> blocks) {
+        std::ranges::stable_sort(blocks, {}, &DataBlock::address);
+
+        // Merge blocks that overlap or directly follow each other into a single extent
+        for (const auto &[address, data] : blocks) {
+            if (data.empty())
+                continue;
+
+            if (m_extents.empty() || address > m_extents.back().getEndAddress() + 1) {
+                m_extents.push_back({ .address=address, .data={ data.begin(), data.end() } });
+                continue;
             }
-            blockSize += bytes.size();
-            prevAddrEnd = endAddress;
 
-            m_data.emplace({ .start=address, .end=endAddress }, std::move(bytes));
-            if (endAddress > maxAddress)
-                maxAddress = endAddress;
+            auto &extent = m_extents.back();
+            const auto extentOffset = address - extent.address;
+            if (extentOffset + data.size() > extent.data.size())
+                extent.data.resize(extentOffset + data.size());
+
+            std::ranges::copy(data, extent.data.begin() + extentOffset);
         }
 
-        if (blockSize > 0) {
-            m_memoryRegions.emplace_back(Region(regionStartAddr, blockSize), fmt::format("Block {}", blockIdx));
+        for (const auto &extent : m_extents) {
+            m_memoryRegions.emplace_back(Region(extent.address, extent.data.size()), fmt::format("Block {}", m_memoryRegions.size()));
         }
 
-        if (maxAddress.has_value())
-            m_dataSize = *maxAddress + 1;
+        if (!m_extents.empty())
+            m_dataSize = m_extents.back().getEndAddress() + 1;
         else
             m_dataSize = 0x00;
 
@@ -255,11 +319,17 @@ namespace hex::plugin::builtin {
             return OpenResult::failure(fmt::format("hex.builtin.provider.file.error.open"_lang, path.string(), formatSystemError(errno)));
         }
 
-        auto data = intel_hex::parseIntelHex(file.readString());
-        if (!data.has_value()) {
-            return OpenResult::failure(data.error());
+        const auto string = file.readString();
+        const auto chunks = parseChunks(string, ':', intel_hex::parseRecords);
+        if (!chunks.has_value()) {
+            return OpenResult::failure(chunks.error());
         }
-        processMemoryRegions(data);
+
+        auto blocks = intel_hex::resolveAddresses(*chunks);
+        if (!blocks.has_value()) {
+            return OpenResult::failure(blocks.error());
+        }
+        processMemoryRegions(std::move(*blocks));
 
         this->lockFile(getPickedPath());
 
@@ -304,18 +374,13 @@ namespace hex::plugin::builtin {
     }
 
     std::pair<Region, bool> IntelHexProvider::getRegionValidity(u64 address) const {
-        auto intervals = m_data.overlapping({ .start=address, .end=address });
-        if (intervals.empty()) {
+        const auto baseAddress = this->getBaseAddress();
+        const auto it = address < baseAddress ? m_extents.end() : this->findExtent(address - baseAddress);
+        if (it == m_extents.end() || it->address > address - baseAddress) {
             return { Region(address, 1), false };
         }
 
-        decltype(m_data)::Interval closestInterval = { .start=0, .end=0 };
-        for (const auto &[interval, data] : intervals) {
-            if (interval.start <= closestInterval.end)
-                closestInterval = interval;
-        }
-
-        return { Region { .address=closestInterval.start, .size=(closestInterval.end - closestInterval.start) + 1}, Provider::getRegionValidity(address).second };
+        return { Region { .address=it->address + baseAddress, .size=it->data.size() }, Provider::getRegionValidity(address).second };
     }
 
     bool IntelHexProvider::memoryRegionFilter(const std::string& search, const MemoryRegion& memoryRegion) {
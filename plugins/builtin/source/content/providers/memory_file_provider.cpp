@@ -18,6 +18,7 @@ namespace hex::plugin::builtin {
 
     prv::Provider::OpenResult MemoryFileProvider::open() {
         if (m_data.empty()) {
+            m_viewedData.detach(m_data);
             m_data.resize(1);
         }
 
@@ -34,6 +35,14 @@ namespace hex::plugin::builtin {
         std::memcpy(buffer, &m_data.front() + offset, size);
     }
 
+    std::optional<prv::Provider::ContiguousView> MemoryFileProvider::tryGetContiguousViewRaw(u64 offset, size_t size) {
+        auto actualSize = this->getActualSize();
+        if (actualSize == 0 || (offset + size) > actualSize || size == 0)
+            return std::nullopt;
+
+        return m_viewedData.createView(m_data, offset, size);
+    }
+
     void MemoryFileProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
         if ((offset + size) > this->getActualSize() || buffer == nullptr || size == 0)
             return;
@@ -67,6 +76,7 @@ namespace hex::plugin::builtin {
     }
 
     void MemoryFileProvider::resizeRaw(u64 newSize) {
+        m_viewedData.detach(m_data);
         m_data.resize(newSize);
     }
 
@@ -95,6 +105,7 @@ namespace hex::plugin::builtin {
     void MemoryFileProvider::loadSettings(const nlohmann::json &settings) {
         Provider::loadSettings(settings);
 
+        m_viewedData.detach(m_data, false);
         m_data = settings["data"].get<std::vector<u8>>();
         m_name = settings["name"].get<std::string>();
         m_readOnly = settings["readOnly"].get<bool>();
@@ -24,14 +24,24 @@ namespace hex::plugin::builtin {
                 throw std::runtime_error("Failed to parse hex digit");
         }
 
-        wolv::util::Expected<std::map<u64, std::vector<u8>>, std::string> parseMotorolaSREC(const std::string &string) {
-            std::map<u64, std::vector<u8>> result;
+        enum class RecordType: u8 {
+            Header          = 0x00,
+            Data16          = 0x01,
+            Data24          = 0x02,
+            Data32          = 0x03,
+            Reserved        = 0x04,
+            Count16         = 0x05,
+            Count24         = 0x06,
+            StartAddress32  = 0x07,
+            StartAddress24  = 0x08,
+            StartAddress16  = 0x09,
+        };
+
+        IntelHexProvider::RecordChunk parseRecords(std::string_view string) {
+            IntelHexProvider::RecordChunk result;
 
             u64 offset = 0x00;
             u8 checksum = 0x00;
-            u8 byteCount = 0x00;
-            u32 address = 0x0000'0000;
-            std::vector<u8> data;
 
             auto c = [&] {
                 while (offset < string.length() && std::isspace(string[offset]))
@@ -56,94 +66,97 @@ namespace hex::plugin::builtin {
                 return value;
             };
 
-            try {
-                enum class RecordType: u8 {
-                    Header          = 0x00,
-                    Data16          = 0x01,
-                    Data24          = 0x02,
-                    Data32          = 0x03,
-                    Reserved        = 0x04,
-                    Count16         = 0x05,
-                    Count24         = 0x06,
-                    StartAddress32  = 0x07,
-                    StartAddress24  = 0x08,
-                    StartAddress16  = 0x09,
-                } recordType;
-                bool endOfFile = false;
-
-                while (offset < string.length()) {
-                    // Parse record start
-                    if (c() != 'S')
-                        return { };
+            while (offset < string.length()) {
+                // Parse record start
+                if (c() != 'S') {
+                    result.invalid = true;
+                    return result;
+                }
 
-                    if (endOfFile)
-                        throw std::runtime_error("Unexpected end of file");
-
-                    // Parse record type
-                    {
-                        char typeCharacter = c();
-                        if (typeCharacter < '0' || typeCharacter > '9')
-                            throw std::runtime_error("Invalid record type");
-                        recordType = static_cast<RecordType>(typeCharacter - '0');
-                    }
+                // Parse record type
+                RecordType recordType;
+                {
+                    char typeCharacter = c();
+                    if (typeCharacter < '0' || typeCharacter > '9')
+                        throw std::runtime_error("Invalid record type");
+                    recordType = static_cast<RecordType>(typeCharacter - '0');
+                }
 
-                    checksum = 0x00;
+                checksum = 0x00;
+
+                // Parse byte count
+                u8 byteCount = parseValue(1);
+
+                // Parse address
+                u32 address = 0x0000'0000;
+                switch (recordType) {
+                    case RecordType::Reserved:
+                        break;
+                    case RecordType::Header:
+                    case RecordType::Data16:
+                    case RecordType::Count16:
+                    case RecordType::StartAddress16:
+                        byteCount -= 2;
+                        address = parseValue(2);
+                        break;
+                    case RecordType::Data24:
+                    case RecordType::Count24:
+                    case RecordType::StartAddress24:
+                        byteCount -= 3;
+                        address = parseValue(3);
+                        break;
+                    case RecordType::Data32:
+                    case RecordType::StartAddress32:
+                        byteCount -= 4;
+                        address = parseValue(4);
+                        break;
+                }
 
-                    // Parse byte count
-                    byteCount = parseValue(1);
+                byteCount -= 1;
 
-                    // Parse address
-                    switch (recordType) {
-                        case RecordType::Reserved:
-                            break;
-                        case RecordType::Header:
-                        case RecordType::Data16:
-                        case RecordType::Count16:
-                        case RecordType::StartAddress16:
-                            byteCount -= 2;
-                            address = parseValue(2);
-                            break;
-                        case RecordType::Data24:
-                        case RecordType::Count24:
-                        case RecordType::StartAddress24:
-                            byteCount -= 3;
-                            address = parseValue(3);
-                            break;
-                        case RecordType::Data32:
-                        case RecordType::StartAddress32:
-                            byteCount -= 4;
-                            address = parseValue(4);
-                            break;
-                    }
+                // Parse data
+                const auto dataOffset = result.data.size();
+                for (u8 i = 0; i < byteCount; i++) {
+                    result.data.push_back(parseValue(1));
+                }
 
-                    byteCount -= 1;
+                // Parse checksum
+                {
+                    auto value = parseValue(1);
+                    if (((checksum - value) ^ 0xFF) != value)
+                        throw std::runtime_error("Invalid checksum");
+                }
+
+                result.records.push_back({ .type=u8(recordType), .address=address, .dataOffset=dataOffset, .dataSize=byteCount });
+
+                while (offset < string.length() && std::isspace(string[offset]))
+                    offset++;
+            }
 
-                    auto readData = [&byteCount, &parseValue] {
-                        std::vector<u8> bytes;
-                        bytes.resize(byteCount);
-                        for (u8 i = 0; i < byteCount; i++) {
-                            bytes[i] = parseValue(1);
-                        }
+            return result;
+        }
 
-                        return bytes;
-                    };
+        wolv::util::Expected<std::vector<IntelHexProvider::DataBlock>, std::string> collectDataBlocks(const std::vector<IntelHexProvider::RecordChunk> &chunks) {
+            std::vector<IntelHexProvider::DataBlock> result;
 
-                    // Parse data
-                    data = readData();
+            for (const auto &chunk : chunks) {
+                // Files that contain anything else than records are treated as not containing any data
+                if (chunk.invalid)
+                    return std::vector<IntelHexProvider::DataBlock>{ };
+            }
 
-                    // Parse checksum
-                    {
-                        auto value = parseValue(1);
-                        if (((checksum - value) ^ 0xFF) != value)
-                            throw std::runtime_error("Invalid checksum");
-                    }
+            bool endOfFile = false;
+            for (const auto &chunk : chunks) {
+                for (const auto &record : chunk.records) {
+                    if (endOfFile)
+                        return wolv::util::Unexpected<std::string>("Unexpected end of file");
 
                     // Construct region
-                    switch (recordType) {
+                    switch (static_cast<RecordType>(record.type)) {
                         case RecordType::Data16:
                         case RecordType::Data24:
                         case RecordType::Data32:
-                            result[address] = data;
+                            result.push_back({ .address=record.address, .data=chunk.getData(record) });
                             break;
                         case RecordType::Header:
                         case RecordType::Reserved:
@@ -156,12 +169,7 @@ namespace hex::plugin::builtin {
                             endOfFile = true;
                             break;
                     }
-
-                    while (offset < string.length() && std::isspace(string[offset]))
-                        offset++;
                 }
-            } catch (const std::runtime_error &e) {
-                return wolv::util::Unexpected<std::string>(e.what());
             }
 
             return result;
@@ -176,11 +184,17 @@ namespace hex::plugin::builtin {
             return OpenResult::failure(fmt::format("hex.builtin.provider.file.error.open"_lang, path.string(), formatSystemError(errno)));
         }
 
-        auto data = motorola_srec::parseMotorolaSREC(file.readString());
-        if (!data.has_value()) {
-            return OpenResult::failure(data.error());
+        const auto string = file.readString();
+        const auto chunks = parseChunks(string, 'S', motorola_srec::parseRecords);
+        if (!chunks.has_value()) {
+            return OpenResult::failure(chunks.error());
+        }
+
+        auto blocks = motorola_srec::collectDataBlocks(*chunks);
+        if (!blocks.has_value()) {
+            return OpenResult::failure(blocks.error());
         }
-        processMemoryRegions(data);
+        processMemoryRegions(std::move(*blocks));
 
         return {};
     }
@@ -1,6 +1,8 @@
 #if defined(OS_WINDOWS) || defined(OS_MACOS) || (defined(OS_LINUX) && !defined(OS_FREEBSD))
 
 #include <algorithm>
+#include <cstring>
+#include <functional>
 #include <content/providers/process_memory_provider.hpp>
 #include <hex/api/imhex_api/hex_editor.hpp>
 
@@ -38,6 +40,53 @@ namespace hex::plugin::builtin {
 
     using namespace wolv::literals;
 
+    namespace {
+
+        // Upper limit for the total size of a snapshot so it can't take up all memory of the system
+        constexpr static u64 MaxSnapshotSize = 4_GiB;
+
+        // Snapshots are read in chunks of this size so the task can report progress and be interrupted in between
+        constexpr static u64 SnapshotReadSize = 16_MiB;
+
+        // Only this many scan results are listed, the rest is only counted
+        constexpr static u64 MaxListedScanResults = 1000;
+
+        /**
+         * @brief Splits the range [address, address + size) into the parts covered by a sorted list of non-overlapping regions and the gaps in between them
+         * @param items Sorted list of items
+         * @param projection Function returning the region of an item
+         * @param onCovered Called with the item, address and size of each covered part
+         * @param onGap Called with the address and size of each part not covered by any item
+         */
+        void forEachPart(auto &items, auto projection, u64 address, u64 size, auto &&onCovered, auto &&onGap) {
+            const auto endAddress = address + size;
+
+            auto it = std::ranges::partition_point(items, [&](const auto &item) {
+                return std::invoke(projection, item).getEndAddress() < address;
+            });
+
+            while (address < endAddress) {
+                if (it == items.end() || std::invoke(projection, *it).getStartAddress() >= endAddress) {
+                    onGap(address, endAddress - address);
+                    break;
+                }
+
+                const Region &region = std::invoke(projection, *it);
+                if (region.getStartAddress() > address) {
+                    onGap(address, region.getStartAddress() - address);
+                    address = region.getStartAddress();
+                }
+
+                const auto partEnd = std::min<u64>(endAddress, region.getEndAddress() + 1);
+                onCovered(*it, address, partEnd - address);
+
+                address = partEnd;
+                ++it;
+            }
+        }
+
+    }
+
     PatternMatcherProcessName::PatternMatcherProcessName(prv::Provider* provider) : PatternMatcher(provider) {
         if (auto processMemoryProvider = dynamic_cast<ProcessMemoryProvider*>(provider); processMemoryProvider != nullptr) {
             m_processName = processMemoryProvider->getProcessName();
@@ -127,6 +176,20 @@ namespace hex::plugin::builtin {
     }
 
     void ProcessMemoryProvider::close() {
+        m_snapshotTask.interrupt();
+        m_scanTask.interrupt();
+        m_snapshotTask.wait();
+        m_scanTask.wait();
+
+        this->discardSnapshot();
+        m_scanner.reset();
+        m_scanResults.clear();
+
+        {
+            std::unique_lock lock(m_readableRegionsMutex);
+            m_readableRegions.clear();
+        }
+
         #if defined(OS_WINDOWS)
             CloseHandle(m_processHandle);
             m_processHandle = nullptr;
@@ -136,34 +199,112 @@ namespace hex::plugin::builtin {
     }
 
     void ProcessMemoryProvider::readRaw(u64 address, void *buffer, size_t size) {
+        const ReadRequest request = { .offset=address, .buffer=buffer, .size=size };
+        this->readRawBatch({ &request, 1 });
+    }
+
+    void ProcessMemoryProvider::readRawBatch(std::span<const ReadRequest> requests) {
+        std::shared_lock lock(m_snapshotMutex);
+        if (m_snapshot.empty()) {
+            lock.unlock();
+            this->readProcessMemory(requests);
+            return;
+        }
+
+        // Serve everything the snapshot covers from there and only go to the process for the rest
+        std::vector<ReadRequest> liveRequests;
+        for (const auto &request : requests) {
+            const auto out = static_cast<u8 *>(request.buffer);
+            forEachPart(m_snapshot, &SnapshotRegion::region, request.offset, request.size,
+                [&](const SnapshotRegion &snapshotRegion, u64 address, u64 size) {
+                    std::memcpy(out + (address - request.offset), snapshotRegion.data.data() + (address - snapshotRegion.region.getStartAddress()), size);
+                },
+                [&](u64 address, u64 size) {
+                    liveRequests.push_back({ .offset=address, .buffer=out + (address - request.offset), .size=size });
+                }
+            );
+        }
+        lock.unlock();
+
+        this->readProcessMemory(liveRequests);
+    }
+
+    void ProcessMemoryProvider::readProcessMemory(std::span<const ReadRequest> requests) {
         #if defined(OS_WINDOWS)
-            ReadProcessMemory(m_processHandle, reinterpret_cast<LPCVOID>(address), buffer, size, nullptr);
+            for (const auto &request : requests)
+                ReadProcessMemory(m_processHandle, reinterpret_cast<LPCVOID>(request.offset), request.buffer, request.size, nullptr);
         #elif defined(OS_MACOS)
             task_t t;
             task_for_pid(mach_task_self(), m_processId, &t);
 
-            vm_size_t dataSize = 0;
-            vm_read_overwrite(t,
-                 address,
-                 size,
-                 reinterpret_cast<vm_address_t>(buffer),
-                 &dataSize
-            );
-
+            for (const auto &request : requests) {
+                vm_size_t dataSize = 0;
+                vm_read_overwrite(t,
+                     request.offset,
+                     request.size,
+                     reinterpret_cast<vm_address_t>(request.buffer),
+                     &dataSize
+                );
+            }
         #elif defined(OS_LINUX)
-            const iovec local {
-                .iov_base = buffer,
-                .iov_len = size,
-            };
-            const iovec remote = {
-                .iov_base = reinterpret_cast<void*>(address),
-                .iov_len = size,
-            };
+            // Split the requests along the mapped regions of the process so unmapped pages
+            // never make the kernel abort a transfer. The gaps in between read as zeros
+            std::vector<ReadRequest> pieces;
+            {
+                std::shared_lock lock(m_readableRegionsMutex);
+                if (m_readableRegions.empty()) {
+                    pieces.assign(requests.begin(), requests.end());
+                } else {
+                    for (const auto &request : requests) {
+                        const auto out = static_cast<u8 *>(request.buffer);
+                        forEachPart(m_readableRegions, std::identity(), request.offset, request.size,
+                            [&](const Region &, u64 address, u64 size) {
+                                pieces.push_back({ .offset=address, .buffer=out + (address - request.offset), .size=size });
+                            },
+                            [&](u64 address, u64 size) {
+                                std::memset(out + (address - request.offset), 0x00, size);
+                            }
+                        );
+                    }
+                }
+            }
+
+            // The kernel doesn't accept more than this many buffers in a single call
+            constexpr static size_t MaxIoVectorCount = 1024;
+
+            std::vector<iovec> localVectors, remoteVectors;
+            size_t processed = 0;
+            while (processed < pieces.size()) {
+                const auto count = std::min(pieces.size() - processed, MaxIoVectorCount);
+
+                localVectors.clear();
+                remoteVectors.clear();
+                for (const auto &piece : std::span(pieces).subspan(processed, count)) {
+                    localVectors.push_back({ .iov_base = piece.buffer, .iov_len = piece.size });
+                    remoteVectors.push_back({ .iov_base = reinterpret_cast<void*>(piece.offset), .iov_len = piece.size });
+                }
+
+                const auto result = process_vm_readv(m_processId, localVectors.data(), count, remoteVectors.data(), count, 0);
+
+                // process_vm_readv stops at the first range that cannot be read.
+                // Skip over that range and continue with the ones behind it
+                size_t transferred = result < 0 ? 0 : size_t(result);
+                size_t completed = 0;
+                while (completed < count && transferred >= pieces[processed + completed].size) {
+                    transferred -= pieces[processed + completed].size;
+                    completed += 1;
+                }
 
-            auto read = process_vm_readv(m_processId, &local, 1, &remote, 1, 0);
-            std::ignore = read;
+                processed += completed;
+                if (completed < count) {
+                    const auto &failed = pieces[processed];
+                    std::memset(static_cast<u8 *>(failed.buffer) + transferred, 0x00, failed.size - transferred);
+                    processed += 1;
+                }
+            }
         #endif
     }
+
     void ProcessMemoryProvider::writeRaw(u64 address, const void *buffer, size_t size) {
         #if defined(OS_WINDOWS)
             WriteProcessMemory(m_processHandle, reinterpret_cast<LPVOID>(address), buffer, size, nullptr);
@@ -189,6 +330,93 @@ namespace hex::plugin::builtin {
             auto write = process_vm_writev(m_processId, &local, 1, &remote, 1, 0);
             std::ignore = write;
         #endif
+
+        // Keep the snapshot in sync so the written data shows up immediately
+        std::unique_lock lock(m_snapshotMutex);
+        const auto in = static_cast<const u8 *>(buffer);
+        forEachPart(m_snapshot, &SnapshotRegion::region, address, size,
+            [&](SnapshotRegion &snapshotRegion, u64 partAddress, u64 partSize) {
+                std::memcpy(snapshotRegion.data.data() + (partAddress - snapshotRegion.region.getStartAddress()), in + (partAddress - address), partSize);
+            },
+            [](u64, u64) { }
+        );
+    }
+
+    void ProcessMemoryProvider::takeSnapshot(std::vector<Region> regions) {
+        if (m_snapshotTask.isRunning())
+            return;
+
+        // Merge overlapping regions so every byte only gets copied once
+        std::ranges::sort(regions, {}, &Region::address);
+        std::vector<Region> mergedRegions;
+        for (const auto &region : regions) {
+            if (region.getSize() == 0)
+                continue;
+
+            if (!mergedRegions.empty() && mergedRegions.back().getEndAddress() >= region.getStartAddress())
+                mergedRegions.back().size = std::max(mergedRegions.back().getEndAddress(), region.getEndAddress()) - mergedRegions.back().getStartAddress() + 1;
+            else
+                mergedRegions.push_back(region);
+        }
+
+        // Leave out everything that cannot be read from the process anyway
+        std::vector<Region> snapshotRegions;
+        {
+            std::shared_lock lock(m_readableRegionsMutex);
+            if (m_readableRegions.empty()) {
+                snapshotRegions = std::move(mergedRegions);
+            } else {
+                for (const auto &region : mergedRegions) {
+                    forEachPart(m_readableRegions, std::identity(), region.getStartAddress(), region.getSize(),
+                        [&](const Region &, u64 address, u64 size) { snapshotRegions.push_back({ .address=address, .size=size }); },
+                        [](u64, u64) { }
+                    );
+                }
+            }
+        }
+
+        u64 totalSize = 0;
+        for (const auto &region : snapshotRegions)
+            totalSize += region.getSize();
+
+        if (totalSize > MaxSnapshotSize) {
+            ui::ToastError::open(fmt::format("hex.builtin.provider.process_memory.snapshot.error.too_large"_lang, hex::toByteString(totalSize)));
+            return;
+        }
+
+        m_snapshotTask = TaskManager::createTask("hex.builtin.provider.process_memory.snapshot.taking", ProgressValue::Size(totalSize), [this, snapshotRegions = std::move(snapshotRegions)](Task &task) {
+            std::vector<SnapshotRegion> snapshot;
+            snapshot.reserve(snapshotRegions.size());
+
+            u64 copied = 0;
+            for (const auto &region : snapshotRegions) {
+                auto &entry = snapshot.emplace_back(SnapshotRegion { .region=region, .data=std::vector<u8>(region.getSize()) });
+
+                for (u64 offset = 0; offset < region.getSize(); offset += SnapshotReadSize) {
+                    task.update(copied);
+
+                    const auto size = std::min<u64>(SnapshotReadSize, region.getSize() - offset);
+                    const ReadRequest request = { .offset=region.getStartAddress() + offset, .buffer=entry.data.data() + offset, .size=size };
+                    this->readProcessMemory({ &request, 1 });
+
+                    copied += size;
+                }
+            }
+
+            std::unique_lock lock(m_snapshotMutex);
+            m_snapshot = std::move(snapshot);
+        });
+    }
+
+    void ProcessMemoryProvider::discardSnapshot() {
+        std::unique_lock lock(m_snapshotMutex);
+        m_snapshot.clear();
+        m_snapshot.shrink_to_fit();
+    }
+
+    bool ProcessMemoryProvider::hasSnapshot() const {
+        std::shared_lock lock(m_snapshotMutex);
+        return !m_snapshot.empty();
     }
 
     std::pair<Region, bool> ProcessMemoryProvider::getRegionValidity(u64 address) const {
@@ -409,12 +637,8 @@ namespace hex::plugin::builtin {
         const auto &filtered = m_regionSearchWidget.draw(m_memoryRegions);
         ImGui::PopItemWidth();
 
-        #if defined(OS_WINDOWS)
-            auto availableY = 400_scaled;
-        #else
-            // Take up full height on Linux since there are no DLL injection controls
-            auto availableY = ImGui::GetContentRegionAvail().y;
-        #endif
+        // Leave room for the snapshot and value scanner controls below
+        auto availableY = 300_scaled;
 
         if (ImGui::BeginTable("##module_table", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_ScrollY, ImVec2(availableX, availableY))) {
             ImGui::TableSetupColumn("hex.ui.common.region"_lang);
@@ -445,6 +669,17 @@ namespace hex::plugin::builtin {
             ImGui::EndTable();
         }
 
+        {
+            std::vector<Region> listedRegions;
+            listedRegions.reserve(filtered.size());
+            for (const auto &memoryRegion : filtered)
+                listedRegions.push_back(memoryRegion->region);
+
+            this->drawSnapshotInterface(listedRegions);
+        }
+
+        this->drawScannerInterface();
+
         #if defined(OS_WINDOWS)
             ImGuiExt::Header("hex.builtin.provider.process_memory.utils"_lang);
 
@@ -474,9 +709,266 @@ namespace hex::plugin::builtin {
         #endif
     }
 
+    void ProcessMemoryProvider::drawSnapshotInterface(const std::vector<Region> &listedRegions) {
+        ImGuiExt::Header("hex.builtin.provider.process_memory.snapshot"_lang);
+
+        if (m_snapshotTask.isRunning()) {
+            ImGuiExt::TextSpinner("hex.builtin.provider.process_memory.snapshot.taking"_lang);
+        } else if (this->hasSnapshot()) {
+            {
+                std::shared_lock lock(m_snapshotMutex);
+
+                u64 snapshotSize = 0;
+                for (const auto &snapshotRegion : m_snapshot)
+                    snapshotSize += snapshotRegion.region.getSize();
+
+                ImGuiExt::TextFormatted("hex.builtin.provider.process_memory.snapshot.active"_lang, hex::toByteString(snapshotSize), m_snapshot.size());
+            }
+
+            if (ImGui::Button("hex.builtin.provider.process_memory.snapshot.discard"_lang))
+                this->discardSnapshot();
+        } else {
+            ImGui::TextUnformatted("hex.builtin.provider.process_memory.snapshot.none"_lang);
+
+            ImGui::BeginDisabled(listedRegions.empty());
+            if (ImGui::Button("hex.builtin.provider.process_memory.snapshot.take"_lang))
+                this->takeSnapshot(listedRegions);
+            ImGui::EndDisabled();
+            ImGui::SetItemTooltip("%s", "hex.builtin.provider.process_memory.snapshot.take.desc"_lang.get());
+        }
+    }
+
+    void ProcessMemoryProvider::drawScannerInterface() {
+        ImGuiExt::Header("hex.builtin.provider.process_memory.scanner"_lang);
+
+        const bool scanning = m_scanTask.isRunning();
+        const bool scanned  = m_scanner.hasScanned();
+
+        if (!scanning && m_scanResultsOutdated.exchange(false))
+            m_scanResults = m_scanner.getCandidates(MaxListedScanResults);
+
+        constexpr static std::array ValueTypes = {
+            "hex.ui.common.type.u8"_lang,
+            "hex.ui.common.type.u16"_lang,
+            "hex.ui.common.type.u32"_lang,
+            "hex.ui.common.type.u64"_lang,
+            "hex.ui.common.type.i8"_lang,
+            "hex.ui.common.type.i16"_lang,
+            "hex.ui.common.type.i32"_lang,
+            "hex.ui.common.type.i64"_lang,
+            "hex.ui.common.type.f32"_lang,
+            "hex.ui.common.type.f64"_lang
+        };
+
+        constexpr static std::array Conditions = {
+            "hex.builtin.provider.process_memory.scanner.condition.equal"_lang,
+            "hex.builtin.provider.process_memory.scanner.condition.changed"_lang,
+            "hex.builtin.provider.process_memory.scanner.condition.unchanged"_lang,
+            "hex.builtin.provider.process_memory.scanner.condition.increased"_lang,
+            "hex.builtin.provider.process_memory.scanner.condition.decreased"_lang
+        };
+
+        ImGui::BeginDisabled(scanning);
+        {
+            // The value type can only be changed for a new scan
+            ImGui::BeginDisabled(scanned);
+            if (ImGui::BeginCombo("hex.ui.common.type"_lang, ValueTypes[std::to_underlying(m_scanValueType)].get())) {
+                for (size_t i = 0; i < ValueTypes.size(); i += 1) {
+                    const auto type = static_cast<MemoryScanner::ValueType>(i);
+                    if (ImGui::Selectable(ValueTypes[i].get(), type == m_scanValueType))
+                        m_scanValueType = type;
+                }
+                ImGui::EndCombo();
+            }
+            ImGui::Checkbox("hex.builtin.provider.process_memory.scanner.aligned"_lang, &m_scanAligned);
+            ImGui::EndDisabled();
+
+            if (scanned) {
+                if (ImGui::BeginCombo("hex.builtin.provider.process_memory.scanner.condition"_lang, Conditions[std::to_underlying(m_scanCondition)].get())) {
+                    for (size_t i = 0; i < Conditions.size(); i += 1) {
+                        const auto condition = static_cast<MemoryScanner::Condition>(i);
+                        if (ImGui::Selectable(Conditions[i].get(), condition == m_scanCondition))
+                            m_scanCondition = condition;
+                    }
+                    ImGui::EndCombo();
+                }
+            }
+
+            const bool needsValue = !scanned || m_scanCondition == MemoryScanner::Condition::Equal;
+            ImGui::BeginDisabled(!needsValue);
+            ImGuiExt::InputTextIcon("hex.ui.common.value"_lang, ICON_VS_SYMBOL_NUMERIC, m_scanInput);
+            ImGui::EndDisabled();
+
+            const auto value = MemoryScanner::parseValue(scanned ? m_scanner.getValueType() : m_scanValueType, m_scanInput);
+            if (!scanned) {
+                ImGui::BeginDisabled(!value.has_value());
+                if (ImGui::Button("hex.builtin.provider.process_memory.scanner.first_scan"_lang))
+                    this->startScan(value, true);
+                ImGui::EndDisabled();
+
+                ImGui::SameLine();
+                if (ImGui::Button("hex.builtin.provider.process_memory.scanner.unknown_value"_lang))
+                    this->startScan(std::nullopt, true);
+                ImGui::SetItemTooltip("%s", "hex.builtin.provider.process_memory.scanner.unknown_value.desc"_lang.get());
+            } else {
+                ImGui::BeginDisabled(needsValue && !value.has_value());
+                if (ImGui::Button("hex.builtin.provider.process_memory.scanner.next_scan"_lang))
+                    this->startScan(value, false);
+                ImGui::EndDisabled();
+
+                ImGui::SameLine();
+                if (ImGui::Button("hex.builtin.provider.process_memory.scanner.reset"_lang)) {
+                    m_scanner.reset();
+                    m_scanResults.clear();
+                    m_scanCondition = MemoryScanner::Condition::Equal;
+                }
+            }
+        }
+        ImGui::EndDisabled();
+
+        if (scanning) {
+            ImGuiExt::TextSpinner("hex.builtin.provider.process_memory.scanner.scanning"_lang);
+            return;
+        }
+
+        if (!scanned)
+            return;
+
+        ImGuiExt::TextFormatted("hex.builtin.provider.process_memory.scanner.candidates"_lang, m_scanner.getCandidateCount());
+
+        const auto valueType = m_scanner.getValueType();
+        const auto valueSize = MemoryScanner::getValueSize(valueType);
+        if (ImGui::BeginTable("##scan_results", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_ScrollY, ImGui::GetContentRegionAvail())) {
+            ImGui::TableSetupColumn("hex.ui.common.address"_lang);
+            ImGui::TableSetupColumn("hex.builtin.provider.process_memory.scanner.previous"_lang);
+            ImGui::TableSetupColumn("hex.ui.common.value"_lang);
+            ImGui::TableSetupScrollFreeze(0, 1);
+
+            ImGui::TableHeadersRow();
+
+            ImGuiListClipper clipper;
+            clipper.Begin(m_scanResults.size(), ImGui::GetTextLineHeightWithSpacing());
+
+            while (clipper.Step()) {
+                for (auto i = clipper.DisplayStart; i < clipper.DisplayEnd; i += 1) {
+                    const auto &candidate = m_scanResults[i];
+
+                    ImGui::PushID(i);
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    if (ImGui::Selectable(fmt::format("0x{:016X}", candidate.address).c_str(), false, ImGuiSelectableFlags_SpanAllColumns))
+                        ImHexApi::HexEditor::setSelection(Region { .address=candidate.address, .size=valueSize });
+
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(MemoryScanner::formatValue(valueType, candidate.value).c_str());
+
+                    ImGui::TableNextColumn();
+                    MemoryScanner::Value currentValue = { };
+                    const ReadRequest request = { .offset=candidate.address, .buffer=currentValue.data(), .size=valueSize };
+                    this->readProcessMemory({ &request, 1 });
+                    ImGui::TextUnformatted(MemoryScanner::formatValue(valueType, currentValue).c_str());
+
+                    ImGui::PopID();
+                }
+            }
+
+            ImGui::EndTable();
+        }
+    }
+
+    std::vector<Region> ProcessMemoryProvider::getScanRegions() const {
+        {
+            std::shared_lock lock(m_readableRegionsMutex);
+            if (!m_readableRegions.empty())
+                return m_readableRegions;
+        }
+
+        // Without information about which regions are readable, fall back to all known regions. These can overlap each other
+        std::vector<Region> regions;
+        for (const auto &memoryRegion : m_memoryRegions) {
+            const auto &region = memoryRegion.region;
+            if (region.getSize() == 0)
+                continue;
+
+            if (!regions.empty() && regions.back().getEndAddress() >= region.getStartAddress())
+                regions.back().size = std::max(regions.back().getEndAddress(), region.getEndAddress()) - regions.back().getStartAddress() + 1;
+            else
+                regions.push_back(region);
+        }
+
+        return regions;
+    }
+
+    class ProcessMemoryProvider::LiveMemoryView : public prv::Provider {
+    public:
+        explicit LiveMemoryView(ProcessMemoryProvider *provider) : m_provider(provider) { }
+
+        [[nodiscard]] bool isAvailable() const override { return m_provider->isAvailable(); }
+        [[nodiscard]] bool isReadable() const override { return true; }
+        [[nodiscard]] bool isWritable() const override { return false; }
+        [[nodiscard]] bool isResizable() const override { return false; }
+        [[nodiscard]] bool isSavable() const override { return false; }
+
+        [[nodiscard]] OpenResult open() override { return {}; }
+        void close() override { }
+
+        void readRaw(u64 address, void *buffer, size_t size) override {
+            const ReadRequest request = { .offset=address, .buffer=buffer, .size=size };
+            m_provider->readProcessMemory({ &request, 1 });
+        }
+        void readRawBatch(std::span<const ReadRequest> requests) override { m_provider->readProcessMemory(requests); }
+        void writeRaw(u64, const void *, size_t) override { }
+        [[nodiscard]] u64 getActualSize() const override { return m_provider->getActualSize(); }
+
+        [[nodiscard]] std::string getName() const override { return m_provider->getName(); }
+        [[nodiscard]] UnlocalizedString getTypeName() const override { return m_provider->getTypeName(); }
+        [[nodiscard]] const char *getIcon() const override { return m_provider->getIcon(); }
+
+    private:
+        ProcessMemoryProvider *m_provider;
+    };
+
+    void ProcessMemoryProvider::startScan(std::optional<MemoryScanner::Value> value, bool firstScan) {
+        if (m_scanTask.isRunning())
+            return;
+
+        if (firstScan) {
+            auto regions = this->getScanRegions();
+
+            // A scan for an unknown value keeps a copy of all scanned memory around
+            if (!value.has_value()) {
+                u64 totalSize = 0;
+                for (const auto &region : regions)
+                    totalSize += region.getSize();
+
+                if (totalSize > MaxSnapshotSize) {
+                    ui::ToastError::open(fmt::format("hex.builtin.provider.process_memory.scanner.error.too_large"_lang, hex::toByteString(totalSize)));
+                    return;
+                }
+            }
+
+            m_scanTask = TaskManager::createTask("hex.builtin.provider.process_memory.scanner.scanning", ProgressValue::Count(0), [this, regions = std::move(regions), value, type = m_scanValueType, aligned = m_scanAligned](Task &task) {
+                LiveMemoryView liveMemory(this);
+                m_scanner.firstScan(task, &liveMemory, regions, type, aligned, value);
+                m_scanResultsOutdated = true;
+            });
+        } else {
+            m_scanTask = TaskManager::createTask("hex.builtin.provider.process_memory.scanner.scanning", ProgressValue::Count(0), [this, value = value.value_or(MemoryScanner::Value { }), condition = m_scanCondition](Task &task) {
+                LiveMemoryView liveMemory(this);
+                m_scanner.nextScan(task, &liveMemory, condition, value);
+                m_scanResultsOutdated = true;
+            });
+        }
+    }
+
     void ProcessMemoryProvider::reloadProcessModules() {
         m_memoryRegions.clear();
 
+        {
+            std::unique_lock lock(m_readableRegionsMutex);
+            m_readableRegions.clear();
+        }
+
         #if defined(OS_WINDOWS)
             DWORD numModules = 0;
             std::vector<HMODULE> modules;
@@ -555,6 +1047,7 @@ namespace hex::plugin::builtin {
                 data.append(chunk);
             }
 
+            std::vector<Region> readableRegions;
             for (const auto &line : wolv::util::splitString(data, "\n")) {
                 const auto &split = wolv::util::splitString(line, " ");
                 if (split.size() < 5)
@@ -563,12 +1056,23 @@ namespace hex::plugin::builtin {
                 const u64 start = std::stoull(split[0].substr(0, split[0].find('-')), nullptr, 16);
                 const u64 end   = std::stoull(split[0].substr(split[0].find('-') + 1), nullptr, 16);
 
+                // The maps file is sorted by address already, so directly adjacent readable mappings can simply be joined
+                if (split[1].starts_with('r') && end > start) {
+                    if (!readableRegions.empty() && readableRegions.back().getEndAddress() + 1 >= start)
+                        readableRegions.back().size = std::max(readableRegions.back().getEndAddress() + 1, end) - readableRegions.back().getStartAddress();
+                    else
+                        readableRegions.push_back({ .address=start, .size=end - start });
+                }
+
                 std::string name;
                 if (split.size() > 5)
                     name = wolv::util::trim(wolv::util::combineStrings(std::vector(split.begin() + 5, split.end()), " "));
 
                 m_memoryRegions.insert({ { .address=start, .size=end - start }, name });
             }
+
+            std::unique_lock lock(m_readableRegionsMutex);
+            m_readableRegions = std::move(readableRegions);
         #endif
     }
 
@@ -1,67 +1,91 @@
 #include <imgui.h>
 #include <content/providers/udp_provider.hpp>
+#include <hex/api/events/events_gui.hpp>
 #include <hex/helpers/utils.hpp>
 #include <hex/ui/imgui_imhex_extensions.h>
 
 #include <fmt/chrono.h>
+#include <wolv/literals.hpp>
+
+#include <algorithm>
+#include <cstring>
 
 namespace hex::plugin::builtin {
 
+    using namespace wolv::literals;
+
+    namespace {
+
+        // Enough to hold a couple of hundred maximum size datagrams until the UI thread gets to them
+        constexpr static size_t HandoffBufferSize = 16_MiB;
+
+    }
+
     prv::Provider::OpenResult UDPProvider::open() {
+        m_handoff  = std::make_unique<MessageHandoff>(HandoffBufferSize);
+        m_messages = std::make_unique<MessageRing>(m_maxBufferSize, m_maxMessageCount);
+
         m_udpServer = UDPServer(m_port, [this](std::span<const u8> data) {
             this->receive(data);
         });
         m_udpServer.start();
 
+        // Keep moving received messages into the store even while nothing is reading from the provider
+        EventFrameBegin::subscribe(this, [this] {
+            std::scoped_lock lock(m_mutex);
+            this->processReceivedMessages();
+        });
+
         return {};
     }
 
     void UDPProvider::close() {
+        EventFrameBegin::unsubscribe(this);
         m_udpServer.stop();
     }
 
     void UDPProvider::receive(std::span<const u8> data) {
-        std::scoped_lock lock(m_mutex);
-
-        m_messages.emplace_back(
-            std::vector(data.begin(), data.end()),
-            std::chrono::system_clock::now()
-        );
+        m_handoff->push(data, std::chrono::system_clock::now());
 
         this->markDataDirty();
     }
 
+    void UDPProvider::processReceivedMessages() const {
+        if (m_handoff == nullptr || m_messages == nullptr)
+            return;
+
+        m_handoff->popAll([this](std::span<const u8> data, std::chrono::system_clock::time_point timestamp) {
+            m_messages->push(data, timestamp);
+        });
+    }
+
     u64 UDPProvider::getActualSize() const {
         std::scoped_lock lock(m_mutex);
+        this->processReceivedMessages();
 
-        if (m_messages.empty())
+        if (m_messages == nullptr)
             return 0;
 
-        if (m_selectedMessage >= m_messages.size())
+        const auto message = m_messages->find(m_selectedMessage);
+        if (message == nullptr)
             return 0;
 
-        return m_messages[m_selectedMessage].data.size();
+        return message->size;
     }
 
     void UDPProvider::readRaw(u64 offset, void* buffer, size_t size) {
         std::scoped_lock lock(m_mutex);
+        this->processReceivedMessages();
 
-        if (m_selectedMessage >= m_messages.size())
+        if (m_messages == nullptr)
             return;
 
-        const auto &message = m_messages[m_selectedMessage];
-
-        if (offset >= message.data.size())
+        const auto message = m_messages->find(m_selectedMessage);
+        if (message == nullptr || offset >= message->size)
             return;
 
-        if (offset + size > message.data.size()) {
-            if (offset >= message.data.size())
-                size = offset - message.data.size();
-            else
-                return;
-        }
-
-        std::memcpy(buffer, &message.data[offset], size);
+        const auto data = m_messages->getData(*message);
+        std::memcpy(buffer, data.data() + offset, std::min<u64>(size, data.size() - offset));
     }
 
     void UDPProvider::writeRaw(u64, const void*, size_t) {
@@ -70,27 +94,34 @@ namespace hex::plugin::builtin {
 
     void UDPProvider::drawSidebarInterface() {
         std::scoped_lock lock(m_mutex);
+        this->processReceivedMessages();
+
+        if (m_messages == nullptr)
+            return;
+
+        if (const auto droppedCount = m_handoff->getDroppedCount(); droppedCount > 0)
+            ImGuiExt::TextFormatted("hex.builtin.provider.udp.dropped"_lang, droppedCount);
 
         if (ImGui::BeginTable("##Messages", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg, ImGui::GetContentRegionAvail())) {
             ImGui::TableSetupColumn("hex.builtin.provider.udp.timestamp"_lang, ImGuiTableColumnFlags_WidthFixed, 32 * ImGui::CalcTextSize(" ").x);
             ImGui::TableSetupColumn("hex.ui.common.size"_lang, ImGuiTableColumnFlags_WidthStretch);
             ImGui::TableHeadersRow();
             ImGuiListClipper clipper;
-            clipper.Begin(m_messages.size());
+            clipper.Begin(m_messages->getCount());
             while (clipper.Step())
                 for (u64 i = clipper.DisplayStart; i != u64(clipper.DisplayEnd); i += 1) {
-                    ImGui::PushID(i + 1);
-                    const auto &message = m_messages[i];
+                    const auto &message = m_messages->at(i);
+                    ImGui::PushID(message.id + 1);
 
                     ImGui::TableNextRow();
                     ImGui::TableNextColumn();
                     ImGuiExt::TextFormatted("{}", message.timestamp);
                     ImGui::SameLine();
-                    if (ImGui::Selectable("##selectable", i == m_selectedMessage, ImGuiSelectableFlags_SpanAllColumns))
-                        m_selectedMessage = i;
+                    if (ImGui::Selectable("##selectable", message.id == m_selectedMessage, ImGuiSelectableFlags_SpanAllColumns))
+                        m_selectedMessage = message.id;
 
                     ImGui::TableNextColumn();
-                    ImGuiExt::TextFormatted("{}", hex::toByteString(message.data.size()));
+                    ImGuiExt::TextFormatted("{}", hex::toByteString(message.size));
 
                     ImGui::PopID();
                 }
@@ -107,6 +138,11 @@ namespace hex::plugin::builtin {
         else if (m_port > 0xFFFF)
             m_port = 0xFFFF;
 
+        ImGui::InputScalar("hex.builtin.provider.udp.max_messages"_lang, ImGuiDataType_U64, &m_maxMessageCount);
+        ImGuiExt::SliderBytes("hex.builtin.provider.udp.max_buffer_size"_lang, &m_maxBufferSize, 1_MiB, 1_GiB, 1_MiB);
+
+        m_maxMessageCount = std::max<u64>(m_maxMessageCount, 1);
+
         return m_port != 0;
     }
 
@@ -114,11 +150,15 @@ namespace hex::plugin::builtin {
     void UDPProvider::loadSettings(const nlohmann::json &settings) {
         Provider::loadSettings(settings);
 
-        m_port      = settings.at("port").get<int>();
+        m_port            = settings.at("port").get<int>();
+        m_maxMessageCount = std::max<u64>(settings.value("maxMessageCount", m_maxMessageCount), 1);
+        m_maxBufferSize   = std::max<u64>(settings.value("maxBufferSize", m_maxBufferSize), 1_MiB);
     }
 
     nlohmann::json UDPProvider::storeSettings(nlohmann::json settings) const {
-        settings["port"] = m_port;
+        settings["port"]            = m_port;
+        settings["maxMessageCount"] = m_maxMessageCount;
+        settings["maxBufferSize"]   = m_maxBufferSize;
 
         return Provider::storeSettings(settings);
     }
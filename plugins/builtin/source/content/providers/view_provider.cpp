@@ -91,6 +91,13 @@ namespace hex::plugin::builtin {
         m_provider->read(offset, buffer, size, overlays);
     }
 
+    void ViewProvider::readBatch(std::span<const ReadRequest> requests, bool overlays) {
+        if (m_provider == nullptr)
+            return;
+
+        m_provider->readBatch(requests, overlays);
+    }
+
     void ViewProvider::write(u64 offset, const void *buffer, size_t size) {
         if (m_provider == nullptr)
             return;
@@ -105,6 +112,27 @@ namespace hex::plugin::builtin {
         m_provider->readRaw(offset, buffer, size);
     }
 
+    void ViewProvider::readRawBatch(std::span<const ReadRequest> requests) {
+        if (m_provider == nullptr)
+            return;
+
+        m_provider->readRawBatch(requests);
+    }
+
+    std::optional<prv::Provider::ContiguousView> ViewProvider::tryGetContiguousView(const Region &region) {
+        if (m_provider == nullptr)
+            return std::nullopt;
+
+        return m_provider->tryGetContiguousView(region);
+    }
+
+    std::optional<prv::Provider::ContiguousView> ViewProvider::tryGetContiguousViewRaw(u64 offset, size_t size) {
+        if (m_provider == nullptr)
+            return std::nullopt;
+
+        return m_provider->tryGetContiguousViewRaw(offset, size);
+    }
+
     void ViewProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
         if (m_provider == nullptr)
             return;
@@ -13,6 +13,7 @@
 #include <hex/api/plugin_manager.hpp>
 
 #include <hex/ui/view.hpp>
+#include <hex/providers/undo_redo/stack.hpp>
 
 #include <hex/helpers/debugging.hpp>
 #include <hex/helpers/http_requests.hpp>
@@ -760,6 +761,15 @@ for (const auto &path : m_paths) {
             ContentRegistry::Settings::add<Widgets::Checkbox>("hex.builtin.setting.general", "", "hex.builtin.setting.general.save_recent_providers", true);
             ContentRegistry::Settings::add<Widgets::SliderDataSize>("hex.builtin.setting.general", "", "hex.builtin.setting.general.max_mem_file_size", 512_MiB, 0_bytes, 32_GiB, 1_MiB)
                 .setTooltip("hex.builtin.setting.general.max_mem_file_size.desc");
+            ContentRegistry::Settings::add<Widgets::SliderDataSize>("hex.builtin.setting.general", "", "hex.builtin.setting.general.max_undo_memory", 256_MiB, 1_MiB, 32_GiB, 1_MiB)
+                .setTooltip("hex.builtin.setting.general.max_undo_memory.desc");
+            ContentRegistry::Settings::onChange("hex.builtin.setting.general", "hex.builtin.setting.general.max_undo_memory", [](const ContentRegistry::Settings::SettingsValue &value) {
+                prv::undo::Stack::setMemoryLimit(value.get<u64>(256_MiB));
+            });
+            ContentRegistry::Settings::add<Widgets::SliderDataSize>("hex.builtin.setting.general", "", "hex.builtin.setting.general.disk_request_size", 1_MiB, 64_KiB, 64_MiB, 64_KiB)
+                .setTooltip("hex.builtin.setting.general.disk_request_size.desc");
+            ContentRegistry::Settings::add<Widgets::SliderInteger>("hex.builtin.setting.general", "", "hex.builtin.setting.general.disk_queue_depth", 8, 1, 64)
+                .setTooltip("hex.builtin.setting.general.disk_queue_depth.desc");
             ContentRegistry::Settings::add<Widgets::SliderInteger>("hex.builtin.setting.general", "hex.builtin.setting.general.patterns", "hex.builtin.setting.general.pattern_data_max_filter_items", 128, 32, 1024);
 
             ContentRegistry::Settings::add<Widgets::Checkbox>("hex.builtin.setting.general", "", "hex.builtin.setting.general.data_inspector_exact_size_only", false);
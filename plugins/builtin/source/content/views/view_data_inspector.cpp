@@ -104,7 +104,10 @@ namespace hex::plugin::builtin {
         if (m_selectedRegion.getProvider() == nullptr)
             return;
 
-        // Decode bytes using registered inspectors
+        // Collect all registered inspectors that apply to the selection. They all decode data starting at the same address,
+        // so the data is read only once, as much as the largest of them needs, and every inspector gets a prefix of it
+        std::vector<std::pair<const ContentRegistry::DataInspector::impl::Entry*, size_t>> entrySizes;
+        size_t readSize = 0;
         for (const auto &entry : ContentRegistry::DataInspector::impl::getEntries()) {
             if (m_validBytes < entry.requiredSize)
                 continue;
@@ -123,19 +126,27 @@ namespace hex::plugin::builtin {
             }
 
             // Try to read as many bytes as requested and possible
-            std::vector<u8> buffer(m_validBytes > entry.maxSize ? entry.maxSize : m_validBytes);
-            m_selectedRegion.getProvider()->read(m_selectedRegion.getStartAddress(), buffer.data(), buffer.size());
+            const size_t entrySize = m_validBytes > entry.maxSize ? entry.maxSize : m_validBytes;
+            entrySizes.emplace_back(&entry, entrySize);
+            readSize = std::max(readSize, entrySize);
+        }
 
-            preprocessBytes(buffer);
+        std::vector<u8> data(readSize);
+        m_selectedRegion.getProvider()->read(m_selectedRegion.getStartAddress(), data.data(), data.size());
+        preprocessBytes(data);
+
+        // Decode bytes using registered inspectors
+        for (const auto &[entry, entrySize] : entrySizes) {
+            const std::vector<u8> buffer(data.begin(), data.begin() + entrySize);
 
             // Insert processed data into the inspector list
             m_workData.emplace_back(
-                entry.unlocalizedName,
-                entry.generatorFunction(buffer, m_endian, m_numberDisplayStyle),
-                entry.editingFunction,
+                entry->unlocalizedName,
+                entry->generatorFunction(buffer, m_endian, m_numberDisplayStyle),
+                entry->editingFunction,
                 false,
-                entry.requiredSize,
-                entry.unlocalizedName
+                entry->requiredSize,
+                entry->unlocalizedName
             );
         }
 
@@ -16,17 +16,26 @@
 #include <imgui_internal.h>
 
 #include <array>
+#include <atomic>
+#include <future>
 #include <string>
+#include <thread>
 #include <utility>
 #include <barrier>
 
 #include <boost/regex.hpp>
 
 #include <content/helpers/constants.hpp>
+#include <content/helpers/string_extractor.hpp>
 #include <toasts/toast_notification.hpp>
 
+#include <wolv/literals.hpp>
+
 namespace hex::plugin::builtin {
 
+    using namespace wolv::literals;
+    using namespace std::chrono_literals;
+
     ViewFind::ViewFind() : View::Window("hex.builtin.view.find.name", ICON_VS_SEARCH) {
         const static auto HighlightColor = [] { return (ImGuiExt::GetCustomColorU32(ImGuiCustomCol_FindHighlight) & 0x00FFFFFF) | 0x70000000; };
 
@@ -206,7 +215,102 @@ namespace hex::plugin::builtin {
         return fmt::format("{}", value);
     }
 
-    std::vector<hex::ContentRegistry::DataFormatter::impl::FindOccurrence> ViewFind::searchStrings(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::Strings &settings) {
+    static bool isValidAsciiCharacter(const auto &settings, u8 byte) {
+        return
+            (settings.lowerCaseLetters    && std::islower(byte))  ||
+            (settings.upperCaseLetters    && std::isupper(byte))  ||
+            (settings.numbers             && std::isdigit(byte))  ||
+            (settings.spaces              && std::isspace(byte) && byte != '\r' && byte != '\n')  ||
+            (settings.underscores         && byte == '_')             ||
+            (settings.symbols             && std::ispunct(byte) && !std::isspace(byte))  ||
+            (settings.lineFeeds           && (byte == '\r' || byte == '\n'));
+    }
+
+    /**
+     * @brief Extends a partition by the maximum size of an occurrence so occurrences starting in the partition but ending in the next one are found too.
+     * Occurrences starting in the extension belong to the next partition and get dropped again
+     */
+    static auto searchWithOverlap(Region searchRegion, u64 maxOccurrenceSize, auto search) {
+        return [=](Task &task, Region partition) {
+            const auto endAddress = std::min(partition.getEndAddress() + maxOccurrenceSize, searchRegion.getEndAddress());
+
+            auto results = search(task, Region { .address=partition.getStartAddress(), .size=endAddress - partition.getStartAddress() + 1 });
+            std::erase_if(results, [&](const auto &occurrence) { return occurrence.region.getStartAddress() > partition.getEndAddress(); });
+
+            return results;
+        };
+    }
+
+    std::vector<ViewFind::Occurrence> ViewFind::searchPartitioned(Task &task, Region searchRegion, u64 alignment, const PartitionSearch &searchPartition) {
+        constexpr static u64 MinPartitionSize = 1_MiB;
+        constexpr static u64 PartitionsPerWorker = 4;
+
+        const u64 threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+        const auto partitionSize = hex::alignTo<u64>(std::max<u64>(searchRegion.getSize() / (threadCount * PartitionsPerWorker), MinPartitionSize), std::max<u64>(alignment, 1));
+        const auto partitionCount = (searchRegion.getSize() + partitionSize - 1) / partitionSize;
+        if (threadCount == 1 || partitionCount <= 1)
+            return searchPartition(task, searchRegion);
+
+        // Every partition gets its own task so interrupting the search can be forwarded to all of them
+        std::vector<Task> partitionTasks(partitionCount);
+        std::vector<std::vector<Occurrence>> partitionResults(partitionCount);
+
+        std::atomic<u64> nextPartition = 0;
+        std::atomic<u64> searchedSize = 0;
+        std::atomic<bool> interrupted = false;
+        const auto worker = [&] {
+            while (!interrupted) {
+                const auto index = nextPartition.fetch_add(1);
+                if (index >= partitionCount)
+                    break;
+
+                const auto address = searchRegion.getStartAddress() + index * partitionSize;
+                const Region partition = { .address=address, .size=std::min<u64>(partitionSize, searchRegion.getEndAddress() - address + 1) };
+
+                partitionResults[index] = searchPartition(partitionTasks[index], partition);
+                searchedSize += partition.getSize();
+            }
+        };
+
+        std::vector<std::future<void>> workers;
+        const auto workerCount = std::min<u64>(threadCount, partitionCount);
+        workers.reserve(workerCount);
+        for (u64 i = 0; i < workerCount; i += 1)
+            workers.push_back(std::async(std::launch::async, worker));
+
+        // The search task must not be left through an exception while the workers are still running
+        std::exception_ptr interruption;
+        for (auto &future : workers) {
+            while (future.wait_for(50ms) == std::future_status::timeout) {
+                if (interrupted)
+                    continue;
+
+                try {
+                    task.update(searchedSize);
+                } catch (...) {
+                    interruption = std::current_exception();
+                    interrupted = true;
+
+                    for (auto &partitionTask : partitionTasks)
+                        partitionTask.interrupt();
+                }
+            }
+        }
+
+        for (auto &future : workers)
+            future.get();
+
+        if (interruption != nullptr)
+            std::rethrow_exception(interruption);
+
+        std::vector<Occurrence> results;
+        for (auto &occurrences : partitionResults)
+            std::ranges::move(occurrences, std::back_inserter(results));
+
+        return results;
+    }
+
+    std::vector<hex::ContentRegistry::DataFormatter::impl::FindOccurrence> ViewFind::searchStrings(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::Strings &settings, const OccurrenceFilter &filter) {
         using enum SearchSettings::StringType;
 
         std::vector<Occurrence> results;
@@ -215,25 +319,80 @@ namespace hex::plugin::builtin {
             auto newSettings = settings;
 
             newSettings.type = ASCII;
-            auto asciiResults = searchStrings(task, provider, searchRegion, newSettings);
+            auto asciiResults = searchStrings(task, provider, searchRegion, newSettings, filter);
             std::ranges::copy(asciiResults, std::back_inserter(results));
 
             if (settings.type == ASCII_UTF16BE) {
                 newSettings.type = UTF16BE;
-                auto utf16Results = searchStrings(task, provider, searchRegion, newSettings);
+                auto utf16Results = searchStrings(task, provider, searchRegion, newSettings, filter);
                 std::ranges::copy(utf16Results, std::back_inserter(results));
             } else if (settings.type == ASCII_UTF16LE) {
                 newSettings.type = UTF16LE;
-                auto utf16Results = searchStrings(task, provider, searchRegion, newSettings);
+                auto utf16Results = searchStrings(task, provider, searchRegion, newSettings, filter);
                 std::ranges::copy(utf16Results, std::back_inserter(results));
             }
 
             return results;
         }
 
-        auto reader = prv::ProviderReader(provider);
-        reader.seek(searchRegion.getStartAddress());
-        reader.setEndAddress(searchRegion.getEndAddress());
+        // Bytes that end a string no matter where it started or which byte of a character is expected next
+        const auto isStringBoundary = [&](u8 byte) {
+            switch (settings.type) {
+                case UTF16LE:
+                case UTF16BE:
+                    return byte != 0x00 && !isValidAsciiCharacter(settings, byte);
+                case UTF8:
+                    return (byte <= 0x7F && !isValidAsciiCharacter(settings, byte)) || byte >= 0xF8;
+                default:
+                    return !isValidAsciiCharacter(settings, byte);
+            }
+        };
+
+        const auto findStringBoundary = [&](u64 startAddress, u64 endAddress) -> std::optional<u64> {
+            auto reader = prv::ProviderReader(provider);
+            reader.seek(startAddress);
+            reader.setEndAddress(endAddress);
+
+            for (auto it = reader.begin(); it < reader.end(); it += 1) {
+                if (isStringBoundary(*it))
+                    return it.getAddress();
+            }
+
+            return std::nullopt;
+        };
+
+        // Strings don't have a maximum length, so partitions can't just overlap. Instead, every partition starts right after
+        // the first string boundary in it and continues up to and including the first string boundary in the next partition
+        return searchPartitioned(task, searchRegion, 1, [&](Task &partitionTask, Region partition) -> std::vector<Occurrence> {
+            auto startAddress = partition.getStartAddress();
+            if (startAddress != searchRegion.getStartAddress()) {
+                const auto boundary = findStringBoundary(startAddress, partition.getEndAddress());
+                if (!boundary.has_value() || *boundary == searchRegion.getEndAddress())
+                    return { };
+
+                startAddress = *boundary + 1;
+            }
+
+            auto endAddress = searchRegion.getEndAddress();
+            if (partition.getEndAddress() != endAddress)
+                endAddress = findStringBoundary(partition.getEndAddress() + 1, endAddress).value_or(endAddress);
+
+            auto occurrences = scanStrings(partitionTask, provider, Region { .address=startAddress, .size=endAddress - startAddress + 1 }, settings);
+            if (filter) {
+                std::erase_if(occurrences, [&](const Occurrence &occurrence) {
+                    partitionTask.update();
+                    return !filter(occurrence);
+                });
+            }
+
+            return occurrences;
+        });
+    }
+
+    std::vector<hex::ContentRegistry::DataFormatter::impl::FindOccurrence> ViewFind::scanStrings(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::Strings &settings) {
+        using enum SearchSettings::StringType;
+
+        std::vector<Occurrence> results;
 
         const auto [decodeType, endian] = [&]() -> std::pair<Occurrence::DecodeType, std::endian> {
             if (settings.type == ASCII)
@@ -248,104 +407,28 @@ namespace hex::plugin::builtin {
                 return { Occurrence::DecodeType::Binary, std::endian::native };
         }();
 
-        const auto validAscii = [&](u8 byte) {
-            return
-                (settings.lowerCaseLetters    && std::islower(byte))  ||
-                (settings.upperCaseLetters    && std::isupper(byte))  ||
-                (settings.numbers             && std::isdigit(byte))  ||
-                (settings.spaces              && std::isspace(byte) && byte != '\r' && byte != '\n')  ||
-                (settings.underscores         && byte == '_')             ||
-                (settings.symbols             && std::ispunct(byte) && !std::isspace(byte))  ||
-                (settings.lineFeeds           && (byte == '\r' || byte == '\n'));
-        };
-
-        i64 countedCharacters = 0;
-        u64 startAddress = reader.begin().getAddress();
-        u64 endAddress = reader.end().getAddress();
-
-        u64 progress = 0;
-        i8 remainingCharacters = 0;
-        for (const u8 byte : reader) {
-            bool validChar = false;
-
-            if (settings.type == ASCII) {
-                validChar = validAscii(byte);
-            } else if (settings.type == UTF16LE) {
-                // Check if second byte of UTF-16 encoded string is 0x00
-                if (countedCharacters % 2 == 1)
-                    validChar = byte == 0x00;
-                else
-                    validChar = validAscii(byte);
-            } else if (settings.type == UTF16BE) {
-                // Check if first byte of UTF-16 encoded string is 0x00
-                if (countedCharacters % 2 == 0)
-                    validChar = byte == 0x00;
-                else
-                    validChar = validAscii(byte);
-            } else if (settings.type == UTF8) {
-                if (remainingCharacters > 0) {
-                    // Expect continuation byte
-                    if ((byte & 0b1100'0000) == 0b1000'0000) {
-                        validChar = true;
-                        remainingCharacters -= 1;
-                    } else {
-                        validChar = false; // broken sequence
-                        remainingCharacters = 0;
-                    }
-                } else {
-                    // New character
-                    if (byte <= 0x7F) {
-                        // ASCII
-                        validChar = validAscii(byte);
-                        remainingCharacters = 0;
-                    } else if ((byte & 0b1110'0000) == 0b1100'0000) {
-                        // 2-byte start (U+80..U+7FF)
-                        validChar = (byte >= 0xC2); // exclude overlongs (0xC0, 0xC1)
-                        remainingCharacters = 1;
-                    } else if ((byte & 0b1111'0000) == 0b1110'0000) {
-                        // 3-byte start (U+800..U+FFFF)
-                        validChar = byte != 0xE0 && byte != 0xED;
-                        // E0 must be followed by >= 0xA0, ED must be <= 0x9F (avoid surrogates)
-                        remainingCharacters = 2;
-                    } else if ((byte & 0b1111'1000) == 0b1111'0000) {
-                        // 4-byte start (U+10000..U+10FFFF)
-                        validChar = (byte <= 0xF4); // reject > U+10FFFF
-                        remainingCharacters = 3;
-                    } else {
-                        validChar = false;
-                        remainingCharacters = 0;
-                    }
-                }
+        const auto encoding = [&] {
+            switch (settings.type) {
+                case UTF8:      return StringExtractor::Encoding::UTF8;
+                case UTF16LE:   return StringExtractor::Encoding::UTF16LE;
+                case UTF16BE:   return StringExtractor::Encoding::UTF16BE;
+                default:        return StringExtractor::Encoding::ASCII;
             }
+        }();
 
-            task.update(progress);
-
-            if (validChar)
-                countedCharacters++;
-            if (!validChar || startAddress + countedCharacters == endAddress) {
-                if (countedCharacters >= settings.minLength) {
-                    if (!settings.nullTermination || byte == 0x00) {
-                        results.push_back(Occurrence { Region { .address=startAddress, .size=size_t(countedCharacters) }, endian, decodeType, false, {} });
-                    }
-                }
-
-                startAddress += countedCharacters + 1;
-                countedCharacters = 0;
-                progress = startAddress - searchRegion.getStartAddress();
+        std::array<bool, 0x80> validCharacters = { };
+        for (u8 byte = 0x00; byte < 0x80; byte += 1)
+            validCharacters[byte] = isValidAsciiCharacter(settings, byte);
 
-            }
-        }
+        const StringExtractor extractor(encoding, validCharacters, u64(std::max(settings.minLength, 1)), settings.nullTermination);
+        extractor.extract(task, provider, searchRegion, [&](Region string) {
+            results.push_back(Occurrence { string, endian, decodeType, false, {} });
+        });
 
         return results;
     }
 
     std::vector<hex::ContentRegistry::DataFormatter::impl::FindOccurrence> ViewFind::searchSequence(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::Sequence &settings) {
-        std::vector<Occurrence> results;
-
-        auto reader = prv::ProviderReader(provider);
-        reader.seek(searchRegion.getStartAddress());
-        reader.setEndAddress(searchRegion.getEndAddress());
-
         auto input = hex::decodeByteString(settings.sequence);
         if (input.empty())
             return { };
@@ -384,44 +467,23 @@ namespace hex::plugin::builtin {
             }
         }
 
-        auto occurrence = reader.begin();
-        u64 progress = 0;
-
-        auto searchPredicate = [&]() -> bool(*)(u8, u8) {
-            if (!settings.ignoreCase)
-                return [](u8 left, u8 right) -> bool {
-                    return left == right;
-                };
-            else
-                return [](u8 left, u8 right) -> bool {
-                    if (std::isupper(left))
-                        left = std::tolower(left);
-                    if (std::isupper(right))
-                        right = std::tolower(right);
-
-                    return left == right;
-                };
-        }();
-
+        const ByteSequenceSearcher searcher(bytes, settings.ignoreCase);
 
-        while (true) {
-            task.update(progress);
-
-            occurrence = hex::searchInterruptable(reader.begin(), reader.end(), bytes.begin(), bytes.end(), searchPredicate, task);
-            if (occurrence == reader.end())
-                break;
-
-            auto address = occurrence.getAddress();
-            reader.seek(address + 1);
-            results.push_back(Occurrence{ Region { .address=address, .size=bytes.size() }, endian, decodeType, false, {} });
-            progress = address - searchRegion.getStartAddress();
-        }
+        return searchPartitioned(task, searchRegion, 1, searchWithOverlap(searchRegion, bytes.size(), [&](Task &partitionTask, Region partition) {
+            std::vector<Occurrence> results;
+            searcher.findAll(partitionTask, provider, partition, [&](u64 address) {
+                results.push_back(Occurrence{ Region { .address=address, .size=bytes.size() }, endian, decodeType, false, {} });
+            });
 
-        return results;
+            return results;
+        }));
     }
 
     std::vector<hex::ContentRegistry::DataFormatter::impl::FindOccurrence> ViewFind::searchRegex(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::Regex &settings) {
-        auto stringOccurrences = searchStrings(task, provider, searchRegion, SearchSettings::Strings {
+        const boost::regex regex(settings.pattern);
+
+        // Strings get matched against the regex right in the partition they were found in
+        return searchStrings(task, provider, searchRegion, SearchSettings::Strings {
             .minLength          = settings.minLength,
             .nullTermination    = settings.nullTermination,
             .type               = settings.type,
@@ -432,79 +494,32 @@ namespace hex::plugin::builtin {
             .symbols            = true,
             .spaces             = true,
             .lineFeeds          = true
-        });
-
-        std::vector<Occurrence> result;
-        boost::regex regex(settings.pattern);
-        for (const auto &occurrence : stringOccurrences) {
+        }, [&](const Occurrence &occurrence) {
             std::string string(occurrence.region.getSize(), '\x00');
             provider->read(occurrence.region.getStartAddress(), string.data(), occurrence.region.getSize());
 
-            task.update();
-
-            if (settings.fullMatch) {
-                if (boost::regex_match(string, regex))
-                    result.push_back(occurrence);
-            } else {
-                if (boost::regex_search(string, regex))
-                    result.push_back(occurrence);
-            }
-        }
-
-        return result;
+            if (settings.fullMatch)
+                return boost::regex_match(string, regex);
+            else
+                return boost::regex_search(string, regex);
+        });
     }
 
     std::vector<hex::ContentRegistry::DataFormatter::impl::FindOccurrence> ViewFind::searchBinaryPattern(Task &task, prv::Provider *provider, hex::Region searchRegion, const SearchSettings::BinaryPattern &settings) {
-        std::vector<Occurrence> results;
-
-        auto reader = prv::ProviderReader(provider);
-        reader.seek(searchRegion.getStartAddress());
-        reader.setEndAddress(searchRegion.getEndAddress());
+        const BinaryPatternSearcher searcher(settings.pattern);
+        const auto alignment = std::max<u64>(settings.alignment, 1);
 
-        const size_t patternSize = settings.pattern.getSize();
-
-        if (settings.alignment == 1) {
-            u32 matchedBytes = 0;
-            for (auto it = reader.begin(); it < reader.end(); it += 1) {
-                auto byte = *it;
-
-                task.update(it.getAddress());
-                if (settings.pattern.matchesByte(byte, matchedBytes)) {
-                    matchedBytes++;
-                    if (matchedBytes == settings.pattern.getSize()) {
-                        auto occurrenceAddress = it.getAddress() - (patternSize - 1);
-
-                        results.push_back(Occurrence { Region { .address=occurrenceAddress, .size=patternSize }, std::endian::native, Occurrence::DecodeType::Binary, false, {} });
-                        it.setAddress(occurrenceAddress);
-                        matchedBytes = 0;
-                    }
-                } else {
-                    if (matchedBytes > 0)
-                        it -= matchedBytes;
-                    matchedBytes = 0;
-                }
-            }
-        } else {
-            std::vector<u8> data(patternSize);
-            for (u64 address = searchRegion.getStartAddress(); address < searchRegion.getEndAddress(); address += settings.alignment) {
-                reader.read(address, data.data(), data.size());
-
-                task.update(address);
-
-                bool match = true;
-                for (u32 i = 0; i < patternSize; i++) {
-                    if (!settings.pattern.matchesByte(data[i], i)) {
-                        match = false;
-                        break;
-                    }
-                }
+        return searchPartitioned(task, searchRegion, alignment, searchWithOverlap(searchRegion, searcher.getSize(), [&](Task &partitionTask, Region partition) {
+            std::vector<Occurrence> results;
+            searcher.findAll(partitionTask, provider, partition, [&](u64 address) {
+                if ((address - searchRegion.getStartAddress()) % alignment != 0)
+                    return;
 
-                if (match)
-                    results.push_back(Occurrence { Region { .address=address, .size=patternSize }, std::endian::native, Occurrence::DecodeType::Binary, false, {} });
-            }
-        }
+                results.push_back(Occurrence { Region { .address=address, .size=searcher.getSize() }, std::endian::native, Occurrence::DecodeType::Binary, false, {} });
+            });
 
-        return results;
+            return results;
+        }));
     }
 
     template<typename T> T convert_signed_integer( T value, size_t size ) {
@@ -519,12 +534,6 @@ namespace hex::plugin::builtin {
     }
 
     std::vector<hex::ContentRegistry::DataFormatter::impl::FindOccurrence> ViewFind::searchValue(Task &task, prv::Provider *provider, Region searchRegion, const SearchSettings::Value &settings) {
-        std::vector<Occurrence> results;
-
-        auto reader = prv::ProviderReader(provider);
-        reader.seek(searchRegion.getStartAddress());
-        reader.setEndAddress(searchRegion.getEndAddress());
-
         auto inputMin = settings.inputMin;
         auto inputMax = settings.inputMax;
 
@@ -541,59 +550,65 @@ namespace hex::plugin::builtin {
 
         const auto advance = settings.aligned ? size : 1;
 
-        for (u64 address = searchRegion.getStartAddress(); address < searchRegion.getEndAddress(); address += advance) {
-            task.update(address);
-
-            auto result = std::visit([&]<typename T>(T) {
-                using DecayedType = std::remove_cvref_t<std::decay_t<T>>;
-
-                auto minValue = std::get<DecayedType>(min);
-                auto maxValue = std::get<DecayedType>(max);
-
-                DecayedType value = 0;
-                reader.read(address, reinterpret_cast<u8*>(&value), size);
-                value = hex::changeEndianness(value, size, settings.endian);
-                if constexpr (std::signed_integral<DecayedType>)
-                    value = convert_signed_integer<DecayedType>(value, size);
-
-                return value >= minValue && value <= maxValue;
-            }, min);
-
-            if (result) {
-                Occurrence::DecodeType decodeType = [&]{
-                    switch (settings.type) {
-                        using enum SearchSettings::Value::Type;
-                        using enum Occurrence::DecodeType;
-
-                        case U8:
-                        case U16:
-                        case U32:
-                        case U64:
-                            return Unsigned;
-                        case I8:
-                        case I16:
-                        case I32:
-                        case I64:
-                            return Signed;
-                        case F32:
-                            return Float;
-                        case F64:
-                            return Double;
-                        default:
-                            return Binary;
-                    }
-                }();
+        return searchPartitioned(task, searchRegion, advance, searchWithOverlap(searchRegion, size, [&](Task &partitionTask, Region partition) {
+            std::vector<Occurrence> results;
+
+            auto reader = prv::ProviderReader(provider);
+            reader.seek(partition.getStartAddress());
+            reader.setEndAddress(partition.getEndAddress());
+
+            for (u64 address = partition.getStartAddress(); address < partition.getEndAddress(); address += advance) {
+                partitionTask.update(address);
+
+                auto result = std::visit([&]<typename T>(T) {
+                    using DecayedType = std::remove_cvref_t<std::decay_t<T>>;
+
+                    auto minValue = std::get<DecayedType>(min);
+                    auto maxValue = std::get<DecayedType>(max);
+
+                    DecayedType value = 0;
+                    reader.read(address, reinterpret_cast<u8*>(&value), size);
+                    value = hex::changeEndianness(value, size, settings.endian);
+                    if constexpr (std::signed_integral<DecayedType>)
+                        value = convert_signed_integer<DecayedType>(value, size);
+
+                    return value >= minValue && value <= maxValue;
+                }, min);
+
+                if (result) {
+                    Occurrence::DecodeType decodeType = [&]{
+                        switch (settings.type) {
+                            using enum SearchSettings::Value::Type;
+                            using enum Occurrence::DecodeType;
+
+                            case U8:
+                            case U16:
+                            case U32:
+                            case U64:
+                                return Unsigned;
+                            case I8:
+                            case I16:
+                            case I32:
+                            case I64:
+                                return Signed;
+                            case F32:
+                                return Float;
+                            case F64:
+                                return Double;
+                            default:
+                                return Binary;
+                        }
+                    }();
 
-                results.push_back(Occurrence { Region { .address=address, .size=size }, settings.endian, decodeType, false, {} });
+                    results.push_back(Occurrence { Region { .address=address, .size=size }, settings.endian, decodeType, false, {} });
+                }
             }
-        }
 
-        return results;
+            return results;
+        }));
     }
 
     std::vector<ViewFind::Occurrence> ViewFind::searchConstants(Task &task, prv::Provider* provider, Region searchRegion, const SearchSettings::Constants &settings) {
-        std::vector<Occurrence> results;
-
         std::vector<ConstantGroup> constantGroups;
         for (const auto &path : paths::Constants.read()) {
             for (const auto &entry : std::fs::directory_iterator(path)) {
@@ -605,79 +620,33 @@ namespace hex::plugin::builtin {
             }
         }
 
-        auto reader = prv::ProviderReader(provider);
-        reader.seek(searchRegion.getStartAddress());
-        reader.setEndAddress(searchRegion.getEndAddress());
+        const ConstantMatcher matcher(constantGroups);
+        if (matcher.getMaxSize() == 0)
+            return { };
 
-        u64 constantCount = 0;
-        for (const auto &group : constantGroups) {
-            constantCount += group.getConstants().size();
-        }
-        task.setMaxValue(constantCount * searchRegion.getSize());
-
-        u64 progress = 0;
-        for (const auto &group : constantGroups) {
-            for (const auto &constant : group.getConstants()) {
-                const auto &pattern = constant.value;
-                const size_t patternSize = pattern.getSize();
-                if (settings.alignment == 1) {
-                    u32 matchedBytes = 0;
-                    for (auto it = reader.begin(); it < reader.end(); it += 1) {
-                        auto byte = *it;
-
-                        task.update(progress + it.getAddress());
-                        if (pattern.matchesByte(byte, matchedBytes)) {
-                            matchedBytes++;
-                            if (matchedBytes == pattern.getSize()) {
-                                auto occurrenceAddress = it.getAddress() - (patternSize - 1);
-
-                                results.push_back(Occurrence {
-                                    Region { .address=occurrenceAddress, .size=patternSize },
-                                    std::endian::native,
-                                    Occurrence::DecodeType::ASCII,
-                                    false,
-                                    fmt::format("[{}] {}", group.getName(), constant.name)
-                                });
-                                it.setAddress(occurrenceAddress);
-                                matchedBytes = 0;
-                            }
-                        } else {
-                            if (matchedBytes > 0)
-                                it -= matchedBytes;
-                            matchedBytes = 0;
-                        }
-                    }
-                } else {
-                    std::vector<u8> data(patternSize);
-                    for (u64 address = searchRegion.getStartAddress(); address < searchRegion.getEndAddress(); address += settings.alignment) {
-                        reader.read(address, data.data(), data.size());
-
-                        task.update(address);
-
-                        bool match = true;
-                        for (u32 i = 0; i < patternSize; i++) {
-                            if (!pattern.matchesByte(data[i], i)) {
-                                match = false;
-                                break;
-                            }
-                        }
+        const auto alignment = std::max<u64>(settings.alignment, 1);
+        auto occurrences = searchPartitioned(task, searchRegion, alignment, searchWithOverlap(searchRegion, matcher.getMaxSize(), [&](Task &partitionTask, Region partition) {
+            std::vector<Occurrence> results;
+            matcher.findAll(partitionTask, provider, partition, [&](u64 address, const ConstantGroup &group, const Constant &constant) {
+                if ((address - searchRegion.getStartAddress()) % alignment != 0)
+                    return;
+
+                results.push_back(Occurrence {
+                    Region { .address=address, .size=constant.value.getSize() },
+                    std::endian::native,
+                    Occurrence::DecodeType::ASCII,
+                    false,
+                    fmt::format("[{}] {}", group.getName(), constant.name)
+                });
+            });
 
-                        if (match)
-                            results.push_back(Occurrence {
-                                Region { .address=address, .size=patternSize },
-                                std::endian::native,
-                                Occurrence::DecodeType::ASCII,
-                                false,
-                                fmt::format("[] {}", group.getName(), constant.name)
-                            });
-                    }
-                }
+            return results;
+        }));
 
-                progress += searchRegion.getSize();
-            }
-        }
+        // The matcher doesn't report occurrences in address order, bring them back into it
+        std::ranges::stable_sort(occurrences, {}, [](const Occurrence &occurrence) { return occurrence.region.getStartAddress(); });
 
-        return results;
+        return occurrences;
     }
 
     void ViewFind::runSearch() {
@@ -9,7 +9,9 @@
 #include <content/providers/undo_operations/operation_insert.hpp>
 #include <content/providers/undo_operations/operation_remove.hpp>
 
+#include <algorithm>
 #include <ranges>
+#include <shared_mutex>
 #include <string>
 
 using namespace std::literals::string_literals;
@@ -21,11 +23,13 @@ namespace hex::plugin::builtin {
         MovePerProviderData::subscribe(this, [this](prv::Provider *from, prv::Provider *to) {
              m_savedOperations.get(from) = 0;
              m_savedOperations.get(to)   = 0;
+
+             std::unique_lock lock(m_modifiedRegionsMutex);
+             m_trackedState.get(from).valid = false;
+             m_trackedState.get(to).valid   = false;
         });
 
         ImHexApi::HexEditor::addForegroundHighlightingProvider([this](u64 offset, const u8* buffer, size_t, bool) -> std::optional<color_t> {
-            std::lock_guard lock(prv::undo::Stack::getMutex());
-
             std::ignore = buffer;
 
             if (!ImHexApi::Provider::isValid())
@@ -37,7 +41,9 @@ namespace hex::plugin::builtin {
 
             offset -= provider->getBaseAddress();
 
-            if (m_modifiedAddresses->contains(offset))
+            // Only the view's own copy of the modified regions is accessed here, so drawing never has to wait for the undo stack
+            std::shared_lock lock(m_modifiedRegionsMutex);
+            if (m_modifiedRegions->contains(offset))
                 return ImGuiExt::GetCustomColorU32(ImGuiCustomCol_Patches);
 
             return std::nullopt;
@@ -45,7 +51,7 @@ namespace hex::plugin::builtin {
 
         EventProviderSaved::subscribe([this](prv::Provider *provider) {
             m_savedOperations.get(provider) = provider->getUndoStack().getAppliedOperations().size();
-            m_modifiedAddresses.get(provider).clear();
+            this->rebuildModifiedRegions(provider);
             EventHighlightingChanged::post();
         });
 
@@ -71,36 +77,7 @@ namespace hex::plugin::builtin {
         });
 
         EventDataChanged::subscribe(this, [this](prv::Provider *provider) {
-            std::lock_guard lock(prv::undo::Stack::getMutex());
-
-            const auto &undoStack = provider->getUndoStack();
-            const auto stackSize = undoStack.getAppliedOperations().size();
-            const auto savedStackSize = m_savedOperations.get(provider);
-
-            m_modifiedAddresses.get(provider).clear();
-            if (stackSize == savedStackSize) {
-                // Do nothing
-            } else if (stackSize > savedStackSize) {
-                for (const auto &operation : undoStack.getAppliedOperations() | std::views::drop(savedStackSize)) {
-                    if (!operation->shouldHighlight())
-                        continue;
-
-                    auto region = operation->getRegion();
-                    for (u64 addr = region.getStartAddress(); addr <= region.getEndAddress(); addr++) {
-                        m_modifiedAddresses.get(provider).insert(addr);
-                    }
-                }
-            } else {
-                for (const auto &operation : undoStack.getUndoneOperations() | std::views::reverse | std::views::take(savedStackSize - stackSize)) {
-                    if (!operation->shouldHighlight())
-                        continue;
-
-                    auto region = operation->getRegion();
-                    for (u64 addr = region.getStartAddress(); addr <= region.getEndAddress(); addr++) {
-                        m_modifiedAddresses.get(provider).insert(addr);
-                    }
-                }
-            }
+            this->updateModifiedRegions(provider);
         });
     }
 
@@ -113,6 +90,224 @@ namespace hex::plugin::builtin {
     }
 
 
+    void ViewPatches::updateModifiedRegions(prv::Provider *provider) {
+        const auto &undoStack = provider->getUndoStack();
+        std::lock_guard stackLock(undoStack.getMutex());
+
+        const auto &appliedOperations = undoStack.getAppliedOperations();
+        const auto &undoneOperations  = undoStack.getUndoneOperations();
+        const auto appliedCount = appliedOperations.size();
+        const auto undoneCount  = undoneOperations.size();
+        const auto lastApplied  = appliedOperations.empty() ? nullptr : appliedOperations.back().get();
+        const auto lastUndone   = undoneOperations.empty()  ? nullptr : undoneOperations.back().get();
+        const auto savedCount   = m_savedOperations.get(provider);
+
+        std::unique_lock regionsLock(m_modifiedRegionsMutex);
+        auto &tracked = m_trackedState.get(provider);
+        auto &regions = m_modifiedRegions.get(provider);
+
+        if (!tracked.valid) {
+            regionsLock.unlock();
+            this->rebuildModifiedRegions(provider);
+            return;
+        }
+
+        const auto pushOperation = [&](const prv::undo::Operation *operation) {
+            if (!operation->shouldHighlight())
+                return;
+
+            tracked.operations.push_back({ operation, operation->getRegion() });
+            regions.add(tracked.operations.back().region);
+        };
+        const auto popOperation = [&](const prv::undo::Operation *operation) {
+            if (tracked.operations.empty() || tracked.operations.back().operation != operation)
+                return;
+
+            regions.remove(tracked.operations.back().region);
+            tracked.operations.pop_back();
+        };
+
+        // The highlighted operations are the ones between the saved state and the current one. Above the saved state those are the
+        // operations applied since saving. Below it they're the ones that got undone, which sit at the end of the list of undone operations
+        const bool wasAboveSaved = tracked.appliedCount >= savedCount;
+        if (appliedCount == tracked.appliedCount + 1 && undoneCount + 1 == tracked.undoneCount && lastApplied == tracked.lastUndone) {
+            // Redo
+            if (wasAboveSaved)
+                pushOperation(lastApplied);
+            else
+                popOperation(lastApplied);
+        } else if (appliedCount == tracked.appliedCount + 1 && undoneCount == 0 && lastApplied != tracked.lastUndone) {
+            // New operation, this drops all undone operations
+            if (wasAboveSaved) {
+                pushOperation(lastApplied);
+            } else {
+                for (const auto &operation : tracked.operations)
+                    regions.remove(operation.region);
+                tracked.operations.clear();
+            }
+        } else if (appliedCount + 1 == tracked.appliedCount && undoneCount == tracked.undoneCount + 1 && lastUndone == tracked.lastApplied) {
+            // Undo
+            if (appliedCount >= savedCount)
+                popOperation(lastUndone);
+            else
+                pushOperation(lastUndone);
+        } else if (appliedCount == tracked.appliedCount && undoneCount == tracked.undoneCount && lastApplied == tracked.lastApplied && lastUndone == tracked.lastUndone) {
+            // Either nothing changed on the stack or an operation got merged into the last one, which may have grown its region
+            if (appliedCount > savedCount && !tracked.operations.empty() && tracked.operations.back().operation == lastApplied) {
+                auto &operation = tracked.operations.back();
+                const auto region = lastApplied->getRegion();
+                if (region != operation.region) {
+                    regions.add(region);
+                    regions.remove(operation.region);
+                    operation.region = region;
+                }
+            }
+        } else {
+            // Multiple operations changed at once, for example when they got grouped together
+            regionsLock.unlock();
+            this->rebuildModifiedRegions(provider);
+            return;
+        }
+
+        tracked.appliedCount = appliedCount;
+        tracked.undoneCount  = undoneCount;
+        tracked.lastApplied  = lastApplied;
+        tracked.lastUndone   = lastUndone;
+    }
+
+    void ViewPatches::rebuildModifiedRegions(prv::Provider *provider) {
+        const auto &undoStack = provider->getUndoStack();
+        std::lock_guard stackLock(undoStack.getMutex());
+
+        const auto &appliedOperations = undoStack.getAppliedOperations();
+        const auto &undoneOperations = undoStack.getUndoneOperations();
+        const auto stackSize = appliedOperations.size();
+        const auto savedStackSize = m_savedOperations.get(provider);
+
+        std::unique_lock regionsLock(m_modifiedRegionsMutex);
+        auto &tracked = m_trackedState.get(provider);
+        auto &regions = m_modifiedRegions.get(provider);
+
+        tracked = { };
+        regions.clear();
+
+        // Collect all operations between the last saved state and the current one, starting at the saved state
+        const auto addOperation = [&](const std::unique_ptr<prv::undo::Operation> &operation) {
+            if (!operation->shouldHighlight())
+                return;
+
+            tracked.operations.push_back({ operation.get(), operation->getRegion() });
+            regions.add(tracked.operations.back().region);
+        };
+
+        if (stackSize > savedStackSize) {
+            for (const auto &operation : appliedOperations | std::views::drop(savedStackSize))
+                addOperation(operation);
+        } else if (stackSize < savedStackSize) {
+            const auto count = std::min<size_t>(savedStackSize - stackSize, undoneOperations.size());
+            for (const auto &operation : undoneOperations | std::views::drop(undoneOperations.size() - count))
+                addOperation(operation);
+        }
+
+        tracked.appliedCount = stackSize;
+        tracked.undoneCount  = undoneOperations.size();
+        tracked.lastApplied  = appliedOperations.empty() ? nullptr : appliedOperations.back().get();
+        tracked.lastUndone   = undoneOperations.empty()  ? nullptr : undoneOperations.back().get();
+        tracked.valid        = true;
+    }
+
+    void ViewPatches::ModifiedRegions::add(const Region &region) {
+        if (region.getSize() == 0)
+            return;
+
+        const auto startAddress = region.getStartAddress();
+        const auto endAddress   = region.getEndAddress() + 1;
+
+        this->splitAt(startAddress);
+        this->splitAt(endAddress);
+
+        // Fill in the gaps between existing segments and increment the count of the ones that are already there
+        auto address = startAddress;
+        auto it = m_segments.lower_bound(startAddress);
+        while (address < endAddress) {
+            if (it == m_segments.end() || it->first > address) {
+                const auto gapEnd = it == m_segments.end() ? endAddress : std::min(it->first, endAddress);
+                it = m_segments.emplace_hint(it, address, Segment { gapEnd, 1 });
+            } else {
+                it->second.count += 1;
+            }
+
+            address = it->second.endAddress;
+            ++it;
+        }
+
+        this->mergeAround(startAddress, endAddress);
+    }
+
+    void ViewPatches::ModifiedRegions::remove(const Region &region) {
+        if (region.getSize() == 0)
+            return;
+
+        const auto startAddress = region.getStartAddress();
+        const auto endAddress   = region.getEndAddress() + 1;
+
+        this->splitAt(startAddress);
+        this->splitAt(endAddress);
+
+        for (auto it = m_segments.lower_bound(startAddress); it != m_segments.end() && it->first < endAddress;) {
+            it->second.count -= 1;
+            if (it->second.count == 0)
+                it = m_segments.erase(it);
+            else
+                ++it;
+        }
+
+        this->mergeAround(startAddress, endAddress);
+    }
+
+    bool ViewPatches::ModifiedRegions::contains(u64 address) const {
+        auto it = m_segments.upper_bound(address);
+        if (it == m_segments.begin())
+            return false;
+
+        --it;
+        return address < it->second.endAddress;
+    }
+
+    void ViewPatches::ModifiedRegions::splitAt(u64 address) {
+        auto it = m_segments.upper_bound(address);
+        if (it == m_segments.begin())
+            return;
+
+        --it;
+        if (it->first == address || it->second.endAddress <= address)
+            return;
+
+        const auto segment = it->second;
+        it->second.endAddress = address;
+        m_segments.emplace_hint(std::next(it), address, Segment { segment.endAddress, segment.count });
+    }
+
+    void ViewPatches::ModifiedRegions::mergeAround(u64 startAddress, u64 endAddress) {
+        // Join touching segments with the same count again so the number of segments stays small
+        auto it = m_segments.lower_bound(startAddress);
+        if (it != m_segments.begin())
+            --it;
+
+        while (it != m_segments.end() && it->first <= endAddress) {
+            auto next = std::next(it);
+            if (next == m_segments.end())
+                break;
+
+            if (it->second.endAddress == next->first && it->second.count == next->second.count) {
+                it->second.endAddress = next->second.endAddress;
+                m_segments.erase(next);
+            } else {
+                it = next;
+            }
+        }
+    }
+
     void ViewPatches::drawContent() {
         auto provider = ImHexApi::Provider::get();
 
@@ -126,9 +321,9 @@ namespace hex::plugin::builtin {
 
                 ImGui::TableHeadersRow();
 
-                std::lock_guard lock(prv::undo::Stack::getMutex());
-
                 const auto &undoRedoStack = provider->getUndoStack();
+                std::lock_guard lock(undoRedoStack.getMutex());
+
                 const auto &undoneOps = undoRedoStack.getUndoneOperations();
                 const auto &appliedOps = undoRedoStack.getAppliedOperations();
 
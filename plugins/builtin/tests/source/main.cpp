@@ -7,12 +7,334 @@
 #include <hex/api/project_manager.hpp>
 #include <hex/helpers/tar.hpp>
 #include <content/legacy_project_importer.hpp>
+#include <content/memory_scanner.hpp>
+#include <content/helpers/constants.hpp>
+#include <content/helpers/message_ring.hpp>
+#include <content/helpers/string_extractor.hpp>
+#include <content/providers/gdb_provider.hpp>
+#include <hex/helpers/crypto.hpp>
+#include <hex/helpers/logger.hpp>
+#include <hex/helpers/utils.hpp>
 
 #include <nlohmann/json.hpp>
 #include <wolv/io/file.hpp>
+#include <wolv/literals.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <random>
+#include <span>
+#include <jthread.hpp>
+
+#if defined(OS_WINDOWS)
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
 
 using namespace hex;
 using namespace hex::plugin::builtin;
+using namespace wolv::literals;
+
+namespace {
+
+    // Minimal GDB server serving memory reads and writes from a buffer. It truncates binary responses
+    // that don't fit into a packet the same way gdbserver does
+    class MockGDBServer {
+    public:
+        constexpr static size_t PacketSize = 0x1000;
+
+        MockGDBServer(std::vector<u8> memory, bool modern) : m_memory(std::move(memory)), m_modern(modern) {
+            #if defined(OS_WINDOWS)
+                WSADATA wsaData;
+                ::WSAStartup(MAKEWORD(2, 2), &wsaData);
+            #endif
+
+            // Let the OS pick a free port so tests running in parallel don't get in each other's way
+            sockaddr_in address = {};
+            address.sin_family      = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port        = 0;
+
+            socklen_t addressSize = sizeof(address);
+            m_socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+            if (::bind(m_socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(m_socket, 1) != 0 ||
+                ::getsockname(m_socket, reinterpret_cast<sockaddr *>(&address), &addressSize) != 0) {
+                log::error("Failed to start mock GDB server");
+                return;
+            }
+
+            m_port = ntohs(address.sin_port);
+            m_thread = std::jthread([this](const std::stop_token &stopToken) {
+                while (!stopToken.stop_requested()) {
+                    if (!waitForData(m_socket))
+                        continue;
+
+                    const auto client = ::accept(m_socket, nullptr, nullptr);
+                    this->serve(client, stopToken);
+                    closeSocket(client);
+                }
+            });
+        }
+
+        ~MockGDBServer() {
+            if (m_thread.joinable()) {
+                m_thread.request_stop();
+                m_thread.join();
+            }
+
+            closeSocket(m_socket);
+
+            #if defined(OS_WINDOWS)
+                ::WSACleanup();
+            #endif
+        }
+
+        [[nodiscard]] u16 getPort() const { return m_port; }
+        [[nodiscard]] const std::vector<u8> &getMemory() const { return m_memory; }
+
+    private:
+        #if defined(OS_WINDOWS)
+            using SocketHandle = SOCKET;
+        #else
+            using SocketHandle = int;
+        #endif
+
+        static bool waitForData(SocketHandle socket) {
+            // Wake up regularly to check if the server is supposed to stop
+            pollfd request = { .fd = socket, .events = POLLIN, .revents = 0 };
+            #if defined(OS_WINDOWS)
+                return ::WSAPoll(&request, 1, 50) > 0;
+            #else
+                return ::poll(&request, 1, 50) > 0;
+            #endif
+        }
+
+        static void closeSocket(SocketHandle socket) {
+            #if defined(OS_WINDOWS)
+                ::closesocket(socket);
+            #else
+                ::close(socket);
+            #endif
+        }
+
+        void serve(SocketHandle client, const std::stop_token &stopToken) {
+            #if defined(MSG_NOSIGNAL)
+                constexpr static int SendFlags = MSG_NOSIGNAL;
+            #else
+                constexpr static int SendFlags = 0;
+            #endif
+
+            std::array<char, 0x1'0000> data = {};
+            while (!stopToken.stop_requested()) {
+                if (!waitForData(client))
+                    continue;
+
+                const auto received = ::recv(client, data.data(), int(data.size()), 0);
+                if (received <= 0)
+                    break;
+
+                const auto response = this->receive({ data.data(), size_t(received) });
+                for (size_t sent = 0; sent < response.size();) {
+                    const auto result = ::send(client, response.data() + sent, int(response.size() - sent), SendFlags);
+                    if (result <= 0)
+                        return;
+
+                    sent += size_t(result);
+                }
+            }
+        }
+
+        static std::string createPacket(const std::string &data) {
+            u8 checksum = 0;
+            for (const auto c : data)
+                checksum += static_cast<u8>(c);
+
+            return fmt::format("${}#{:02x}", data, checksum);
+        }
+
+        std::string receive(std::string_view data) {
+            m_buffer.append(data);
+
+            std::string response;
+            while (true) {
+                const auto start = m_buffer.find('$');
+                const auto end = m_buffer.find('#', start);
+                if (start == std::string::npos || end == std::string::npos || end + 2 >= m_buffer.size())
+                    break;
+
+                const auto command = m_buffer.substr(start + 1, end - start - 1);
+                m_buffer.erase(0, end + 3);
+
+                if (!m_noAckMode)
+                    response += '+';
+                response += createPacket(this->execute(command));
+            }
+
+            return response;
+        }
+
+        std::string execute(const std::string &command) {
+            if (command.starts_with("qSupported"))
+                return m_modern ? fmt::format("PacketSize={:x};QStartNoAckMode+;binary-upload+", PacketSize) : fmt::format("PacketSize={:x}", PacketSize);
+            if (command == "QStartNoAckMode") {
+                m_noAckMode = true;
+                return "OK";
+            }
+            if (command == "!" || command == "Hg0")
+                return "OK";
+
+            if (command.empty() || !std::string_view("mxM").contains(command[0]))
+                return "";
+
+            const auto separator = command.find(',');
+            const auto address = std::stoull(command.substr(1, separator - 1), nullptr, 16);
+            auto size = std::stoull(command.substr(separator + 1), nullptr, 16);
+            if (address >= m_memory.size())
+                return "E01";
+            size = std::min<u64>(size, m_memory.size() - address);
+
+            if (command[0] == 'M') {
+                const auto bytes = crypt::decode16(command.substr(command.find(':') + 1));
+                std::ranges::copy(bytes, m_memory.begin() + address);
+                return "OK";
+            }
+
+            std::string result = command[0] == 'x' ? "b" : "";
+            for (u64 i = 0; i < size; i += 1) {
+                const u8 byte = m_memory[address + i];
+                if (command[0] == 'm') {
+                    result += fmt::format("{:02x}", byte);
+                } else if (std::string_view("#$}*").contains(char(byte))) {
+                    if (result.size() + 2 > PacketSize)
+                        break;
+                    result += '}';
+                    result += char(byte ^ 0x20);
+                } else {
+                    if (result.size() + 1 > PacketSize)
+                        break;
+                    result += char(byte);
+                }
+            }
+
+            return result;
+        }
+
+    private:
+        std::vector<u8> m_memory;
+        bool m_modern;
+        bool m_noAckMode = false;
+        std::string m_buffer;
+
+        SocketHandle m_socket;
+        u16 m_port = 0;
+        std::jthread m_thread;
+    };
+
+    // Straightforward byte by byte string search the vectorized StringExtractor has to produce the same results as
+    std::vector<Region> findStringsPerByte(std::span<const u8> data, StringExtractor::Encoding encoding, const std::array<bool, 0x80> &validCharacters, u64 minLength, bool nullTermination) {
+        using enum StringExtractor::Encoding;
+
+        const auto isValid = [&](u8 byte) { return byte < 0x80 && validCharacters[byte]; };
+
+        std::vector<Region> strings;
+        u64 start = 0, length = 0;
+        u8 remainingContinuationBytes = 0;
+        for (u64 address = 0; address < data.size(); address += 1) {
+            const u8 byte = data[address];
+
+            bool continues = false;
+            switch (encoding) {
+                case UTF16LE:
+                    continues = length % 2 == 1 ? byte == 0x00 : isValid(byte);
+                    break;
+                case UTF16BE:
+                    continues = length % 2 == 0 ? byte == 0x00 : isValid(byte);
+                    break;
+                case UTF8:
+                    if (remainingContinuationBytes > 0) {
+                        continues = (byte & 0xC0) == 0x80;
+                        remainingContinuationBytes = continues ? remainingContinuationBytes - 1 : 0;
+                    } else if (byte <= 0x7F) {
+                        continues = isValid(byte);
+                    } else if ((byte & 0xE0) == 0xC0) {
+                        continues = byte >= 0xC2;
+                        remainingContinuationBytes = 1;
+                    } else if ((byte & 0xF0) == 0xE0) {
+                        continues = byte != 0xE0 && byte != 0xED;
+                        remainingContinuationBytes = 2;
+                    } else if ((byte & 0xF8) == 0xF0) {
+                        continues = byte <= 0xF4;
+                        remainingContinuationBytes = 3;
+                    }
+                    break;
+                default:
+                    continues = isValid(byte);
+                    break;
+            }
+
+            if (continues)
+                length += 1;
+
+            // A string that runs up to the end of the data ends with its own last byte
+            if (!continues || start + length == data.size()) {
+                if (length >= std::max<u64>(minLength, 1) && (!nullTermination || byte == 0x00))
+                    strings.push_back({ start, length });
+
+                start += length + 1;
+                length = 0;
+            }
+        }
+
+        return strings;
+    }
+
+    // Character by character Base64 decoder the block wise and vectorized decoding of the Base64 provider has to match.
+    // Everything that's not part of the alphabet is skipped, decoding stops at the first padding character
+    std::vector<u8> decodeBase64PerCharacter(std::span<const u8> encoded) {
+        constexpr static std::string_view Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        std::vector<u8> result;
+        u32 value = 0, bits = 0;
+        for (const u8 character : encoded) {
+            if (character == '=')
+                break;
+
+            const auto position = Alphabet.find(char(character));
+            if (position == std::string_view::npos)
+                continue;
+
+            value = (value << 6) | u32(position);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                result.push_back(u8(value >> bits));
+            }
+        }
+
+        return result;
+    }
+
+    std::string encodeBase64Lines(std::span<const u8> data, size_t lineLength, std::string_view lineBreak) {
+        const auto encoded = crypt::encode64(std::vector<u8>(data.begin(), data.end()));
+
+        std::string result;
+        for (size_t i = 0; i < encoded.size(); i += 1) {
+            if (lineLength != 0 && i != 0 && i % lineLength == 0)
+                result += lineBreak;
+            result += char(encoded[i]);
+        }
+
+        return result;
+    }
+
+}
 
 TEST_SEQUENCE("Providers/ReadWrite") {
     INIT_PLUGIN("Built-in");
@@ -50,6 +372,456 @@ TEST_SEQUENCE("Providers/InvalidResize") {
     TEST_SUCCESS();
 };
 
+TEST_SEQUENCE("Providers/GDBMock") {
+    INIT_PLUGIN("Built-in");
+
+    // Use every possible byte value so escaping in binary responses is covered as well
+    std::vector<u8> memory(4_MiB);
+    for (size_t i = 0; i < memory.size(); i += 1)
+        memory[i] = u8(i * 7 + i / 251);
+
+    for (const bool modern : { true, false }) {
+        MockGDBServer server(memory, modern);
+        TEST_ASSERT(server.getPort() != 0);
+
+        auto provider = ImHexApi::Provider::createProvider("hex.builtin.provider.gdb", true);
+        provider->loadSettings({
+            { "ip", "127.0.0.1" },
+            { "port", server.getPort() },
+            { "size", memory.size() },
+            { "baseAddress", 0 },
+            { "currPage", 0 }
+        });
+        TEST_ASSERT(provider->open().isSuccess());
+
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<u8> data(memory.size());
+        for (size_t offset = 0; offset < data.size(); offset += 64_KiB)
+            provider->read(offset, data.data() + offset, 64_KiB);
+        const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        TEST_ASSERT(data == memory, "modern: {}", modern);
+        log::info("Read {} from {} mock GDB server in {:.3f}s ({:.2f} MiB/s)", hex::toByteString(data.size()), modern ? "modern" : "legacy", duration, (data.size() / 1_MiB) / duration);
+
+        // Unaligned read spanning multiple packets
+        std::vector<u8> part(0x2345);
+        provider->read(0x12345, part.data(), part.size());
+        TEST_ASSERT(std::ranges::equal(part, std::span(memory).subspan(0x12345, part.size())));
+
+        const std::array<u8, 4> value = { '$', '#', '}', '*' };
+        provider->write(0x2000, value.data(), value.size());
+        TEST_ASSERT(std::ranges::equal(value, std::span(server.getMemory()).subspan(0x2000, value.size())));
+
+        ImHexApi::Provider::remove(provider.get(), true);
+    }
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("Providers/UDPMessageRing") {
+    INIT_PLUGIN("Built-in");
+
+    const auto makeMessage = [](u32 index) {
+        std::vector<u8> data(1 + (index * 37) % 3000);
+        std::ranges::fill(data, u8(index));
+        return data;
+    };
+
+    // Push more data through the handoff queue than fits into it at once while the consumer keeps draining it
+    constexpr static u32 MessageCount = 20'000;
+    MessageHandoff handoff(64_KiB);
+    MessageRing ring(256_KiB, 1000);
+
+    std::jthread producer([&] {
+        for (u32 i = 0; i < MessageCount; i += 1) {
+            const auto message = makeMessage(i);
+            while (!handoff.push(message, std::chrono::system_clock::time_point(std::chrono::system_clock::duration(i))))
+                std::this_thread::yield();
+        }
+    });
+
+    u32 received = 0;
+    bool inOrder = true;
+    while (received < MessageCount) {
+        handoff.popAll([&](std::span<const u8> data, std::chrono::system_clock::time_point timestamp) {
+            inOrder = inOrder && std::ranges::equal(data, makeMessage(received)) && timestamp.time_since_epoch().count() == received;
+            ring.push(data, timestamp);
+            received += 1;
+        });
+    }
+    producer.join();
+
+    TEST_ASSERT(inOrder);
+
+    // Only the most recent messages that fit into the arena are kept
+    TEST_ASSERT(ring.getCount() > 0 && ring.getCount() <= 1000, "{}", ring.getCount());
+    TEST_ASSERT(ring.at(ring.getCount() - 1).id == MessageCount - 1);
+    TEST_ASSERT(ring.find(0) == nullptr);
+
+    u64 totalSize = 0;
+    for (size_t i = 0; i < ring.getCount(); i += 1) {
+        const auto &message = ring.at(i);
+        TEST_ASSERT(ring.find(message.id) == &message);
+        TEST_ASSERT(std::ranges::equal(ring.getData(message), makeMessage(message.id)), "{}", message.id);
+        totalSize += message.size;
+    }
+    TEST_ASSERT(totalSize <= 256_KiB);
+
+    // The count limit applies as well
+    MessageRing smallRing(256_KiB, 3);
+    for (u32 i = 0; i < 10; i += 1)
+        smallRing.push(makeMessage(i), { });
+    TEST_ASSERT(smallRing.getCount() == 3 && smallRing.at(0).id == 7);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("Providers/Base64") {
+    INIT_PLUGIN("Built-in");
+
+    const auto root = std::filesystem::current_path() / "base64_provider_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+
+    std::mt19937_64 random(1337);
+    for (u32 iteration = 0; iteration < 40; iteration += 1) {
+        // Sizes cover every amount of padding as well as data that spans many blocks of the provider
+        std::vector<u8> data(iteration < 6 ? iteration : random() % (iteration % 4 == 0 ? 64_KiB : 8_KiB));
+        for (auto &byte : data)
+            byte = u8(random());
+
+        const auto lineLength = std::array<size_t, 4>{ 0, 64, 76, 1 + random() % 100 }[iteration % 4];
+        const auto lineBreak  = iteration % 3 == 0 ? "\r\n" : "\n";
+        const auto encoded    = encodeBase64Lines(data, lineLength, lineBreak);
+
+        const auto path = root / fmt::format("{}.b64", iteration);
+        wolv::io::File(path, wolv::io::File::Mode::Create).writeString(encoded);
+
+        auto provider = ImHexApi::Provider::createProvider("hex.builtin.provider.base64", true);
+        provider->loadSettings({
+            { "path", path.string() },
+            { "baseAddress", 0 },
+            { "currPage", 0 }
+        });
+        TEST_ASSERT(provider->open().isSuccess(), "iteration: {}", iteration);
+
+        const auto expected = decodeBase64PerCharacter({ reinterpret_cast<const u8*>(encoded.data()), encoded.size() });
+        TEST_ASSERT(expected == data);
+        TEST_ASSERT(provider->getActualSize() == expected.size(), "iteration: {}, size: {}", iteration, provider->getActualSize());
+
+        std::vector<u8> decoded(expected.size());
+        provider->read(0, decoded.data(), decoded.size());
+        TEST_ASSERT(decoded == expected, "iteration: {}, line length: {}", iteration, lineLength);
+
+        if (!data.empty()) {
+            // Reads starting in the middle of a block and crossing into the next ones
+            const auto start = random() % data.size();
+            std::vector<u8> part(1 + random() % (data.size() - start));
+            provider->read(start, part.data(), part.size());
+            TEST_ASSERT(std::ranges::equal(part, std::span(expected).subspan(start, part.size())), "iteration: {}, start: {:#x}", iteration, start);
+
+            // Writes get re-encoded into the existing characters, the line breaks have to stay where they are
+            auto modified = expected;
+            for (u32 write = 0; write < 4; write += 1) {
+                const auto offset = random() % data.size();
+                std::vector<u8> bytes(1 + random() % std::min<u64>(data.size() - offset, 5000));
+                for (auto &byte : bytes)
+                    byte = u8(random());
+
+                provider->write(offset, bytes.data(), bytes.size());
+                std::ranges::copy(bytes, modified.begin() + offset);
+            }
+
+            provider->read(0, decoded.data(), decoded.size());
+            TEST_ASSERT(decoded == modified, "iteration: {}", iteration);
+
+            provider->save();
+            const auto saved = wolv::io::File(path, wolv::io::File::Mode::Read).readString();
+            TEST_ASSERT(saved == encodeBase64Lines(modified, lineLength, lineBreak), "iteration: {}", iteration);
+        }
+
+        ImHexApi::Provider::remove(provider.get(), true);
+    }
+
+    std::filesystem::remove_all(root);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("MemoryScanner/Narrowing") {
+    INIT_PLUGIN("Built-in");
+
+    auto &provider = *ImHexApi::Provider::createProvider("hex.builtin.provider.mem_file", true);
+
+    std::vector<u32> data(0x4000);
+    for (u32 i = 0; i < data.size(); i += 1)
+        data[i] = i % 100;
+    provider.resize(data.size() * sizeof(u32));
+    provider.write(0, data.data(), data.size() * sizeof(u32));
+
+    Task task("hex.test.task", ProgressValue::None(), false, false, [](Task &) {});
+    const std::array regions = { Region { .address=0, .size=provider.getActualSize() } };
+
+    MemoryScanner scanner;
+    scanner.firstScan(task, &provider, regions, MemoryScanner::ValueType::U32, true, std::nullopt);
+    TEST_ASSERT(scanner.getCandidateCount() == data.size(), "{}", scanner.getCandidateCount());
+
+    // Bump every 1000th value, the first one ends up being 5
+    for (u32 i = 0; i < data.size(); i += 1000) {
+        const u32 value = data[i] + 5 + i / 1000;
+        provider.write(i * sizeof(u32), &value, sizeof(value));
+    }
+
+    scanner.nextScan(task, &provider, MemoryScanner::Condition::Increased, { });
+    TEST_ASSERT(scanner.getCandidateCount() == 17, "{}", scanner.getCandidateCount());
+
+    scanner.nextScan(task, &provider, MemoryScanner::Condition::Unchanged, { });
+    TEST_ASSERT(scanner.getCandidateCount() == 17, "{}", scanner.getCandidateCount());
+
+    const auto value = MemoryScanner::parseValue(MemoryScanner::ValueType::U32, "5");
+    TEST_ASSERT(value.has_value());
+    scanner.nextScan(task, &provider, MemoryScanner::Condition::Equal, *value);
+    const auto candidates = scanner.getCandidates(10);
+    TEST_ASSERT(candidates.size() == 1 && candidates.front().address == 0);
+
+    scanner.firstScan(task, &provider, regions, MemoryScanner::ValueType::U32, true, MemoryScanner::parseValue(MemoryScanner::ValueType::U32, "42"));
+    TEST_ASSERT(scanner.getCandidateCount() == 164, "{}", scanner.getCandidateCount());
+
+    TEST_ASSERT(!MemoryScanner::parseValue(MemoryScanner::ValueType::U8, "256").has_value());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("StringExtractor/Encodings") {
+    INIT_PLUGIN("Built-in");
+
+    auto &provider = *ImHexApi::Provider::createProvider("hex.builtin.provider.mem_file", true);
+
+    const std::string ascii = "Hello ImHex";
+    const std::array<u8, 12> utf16 = { 'I', 0x00, 'm', 0x00, 'H', 0x00, 'e', 0x00, 'x', 0x00, '!', 0x00 };
+    const std::array<u8, 7> utf8 = { 'G', 'r', 0xC3, 0xBC, 0xC3, 0x9F, 'e' };
+
+    // The second ASCII string crosses the boundary between the first two chunks the data is processed in
+    std::vector<u8> data(1_MiB + 0x1000, 0xFF);
+    std::ranges::copy(ascii, data.begin() + 0x100);
+    std::ranges::copy(utf16, data.begin() + 0x200);
+    std::ranges::copy(utf8, data.begin() + 0x300);
+    std::ranges::copy(ascii, data.begin() + 1_MiB - 5);
+
+    provider.resize(data.size());
+    provider.write(0, data.data(), data.size());
+
+    Task task("hex.test.task", ProgressValue::None(), false, false, [](Task &) {});
+
+    std::array<bool, 0x80> validCharacters = { };
+    for (u8 character = 0x20; character < 0x7F; character += 1)
+        validCharacters[character] = true;
+
+    const auto extract = [&](StringExtractor::Encoding encoding) {
+        std::vector<Region> strings;
+        StringExtractor(encoding, validCharacters, 5, false).extract(task, &provider, { .address=0, .size=data.size() }, [&](Region string) {
+            strings.push_back(string);
+        });
+
+        return strings;
+    };
+
+    const std::vector<Region> asciiStrings = { { 0x100, ascii.size() }, { 1_MiB - 5, ascii.size() } };
+    const std::vector<Region> utf8Strings  = { { 0x100, ascii.size() }, { 0x300, utf8.size() }, { 1_MiB - 5, ascii.size() } };
+    const std::vector<Region> utf16LEStrings = { { 0x200, utf16.size() } };
+
+    // Read as big endian, the little endian string is shifted by one byte and picks up the null byte right after it
+    const std::vector<Region> utf16BEStrings = { { 0x201, utf16.size() - 1 } };
+
+    TEST_ASSERT(extract(StringExtractor::Encoding::ASCII) == asciiStrings);
+    TEST_ASSERT(extract(StringExtractor::Encoding::UTF8) == utf8Strings);
+    TEST_ASSERT(extract(StringExtractor::Encoding::UTF16LE) == utf16LEStrings);
+    TEST_ASSERT(extract(StringExtractor::Encoding::UTF16BE) == utf16BEStrings);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("StringExtractor/RandomizedComparison") {
+    INIT_PLUGIN("Built-in");
+
+    auto &provider = *ImHexApi::Provider::createProvider("hex.builtin.provider.mem_file", true);
+    Task task("hex.test.task", ProgressValue::None(), false, false, [](Task &) {});
+
+    // Mostly bytes that are interesting to the different encodings so strings of all lengths show up, including broken UTF-8 sequences
+    constexpr static std::array<u8, 21> Alphabet = { 'a', 'Z', '0', ' ', '\n', '_', '!', 0x00, 0xC3, 0xA9, 0xE2, 0x82, 0xAC, 0xF0, 0x9F, 0x80, 0xC0, 0xED, 0xFF, 0x7F, 0x01 };
+
+    std::mt19937_64 random(1337);
+    for (u32 iteration = 0; iteration < 400; iteration += 1) {
+        // Some of the data spans multiple chunks to cover strings continuing from one chunk into the next
+        std::vector<u8> data(iteration % 100 == 0 ? 1_MiB + 1 + random() % 0x10000 : 1 + random() % 0x1000);
+        const auto distribution = random() % 3;
+        for (auto &byte : data) {
+            switch (distribution) {
+                case 0:  byte = u8(random()); break;
+                case 1:  byte = Alphabet[random() % Alphabet.size()]; break;
+                default: byte = random() % 3 != 0 ? Alphabet[random() % 7] : Alphabet[random() % Alphabet.size()]; break;
+            }
+        }
+
+        std::array<bool, 0x80> validCharacters = { };
+        const bool printableOnly = random() % 2 == 0;
+        for (u32 character = 0x01; character < 0x80; character += 1)
+            validCharacters[character] = printableOnly ? (character >= 0x20 && character < 0x7F) : random() % 4 != 0;
+
+        const auto encoding = StringExtractor::Encoding(random() % 4);
+        const u64 minLength = 1 + random() % (random() % 2 == 0 ? 6 : 40);
+        const bool nullTermination = random() % 4 == 0;
+
+        provider.resize(data.size());
+        provider.write(0, data.data(), data.size());
+
+        const auto start = random() % data.size();
+        const auto size  = 1 + random() % (data.size() - start);
+
+        std::vector<Region> strings;
+        StringExtractor(encoding, validCharacters, minLength, nullTermination).extract(task, &provider, { .address=start, .size=size }, [&](Region string) {
+            strings.push_back(string);
+        });
+
+        auto expected = findStringsPerByte(std::span(data).subspan(start, size), encoding, validCharacters, minLength, nullTermination);
+        for (auto &string : expected)
+            string.address += start;
+
+        TEST_ASSERT(strings == expected, "iteration: {}, encoding: {}, size: {}", iteration, u32(encoding), size);
+    }
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("Constants/Matcher") {
+    INIT_PLUGIN("Built-in");
+
+    const auto root = std::filesystem::current_path() / "constants_matcher_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+
+    const auto writeGroup = [&](const std::string &name, const std::vector<std::string> &values) {
+        nlohmann::json content = { { "name", name }, { "values", nlohmann::json::array() } };
+        for (const auto &value : values)
+            content["values"].push_back({ { "name", value }, { "value", value } });
+
+        const auto path = root / (name + ".json");
+        wolv::io::File(path, wolv::io::File::Mode::Create).writeString(content.dump());
+        return path;
+    };
+
+    std::vector<ConstantGroup> groups;
+    // Anchors that are prefixes, suffixes and parts of each other need the failure and output links to be found
+    groups.emplace_back(writeGroup("Overlapping", { "41 42 43 44", "42 43", "43 44 45", "41 42", "44" }));
+    // Only the longest fully specified run is used as the anchor, everything around it gets checked separately
+    groups.emplace_back(writeGroup("Wildcards", { "DE AD ?? EF BE AD", "1? 34 56 ?? 78", "?? 42 43 ??", "CA FE B? BE" }));
+    // Constants without any fully specified byte have to be checked at every position
+    groups.emplace_back(writeGroup("Unanchored", { "?? ?F", "A? 0? ?5" }));
+    groups.emplace_back(writeGroup("Duplicates", { "41 42 43 44" }));
+    std::filesystem::remove_all(root);
+
+    const ConstantMatcher matcher(groups);
+    TEST_ASSERT(matcher.getMaxSize() == 6);
+
+    // Plant the constants all over the data, including right around the boundaries of the chunks the data is read in
+    std::mt19937_64 random(1337);
+    std::vector<u8> data(3_MiB + 123);
+    for (auto &byte : data)
+        byte = u8(random());
+
+    const std::array<std::vector<u8>, 5> planted = {{
+        { 0x41, 0x42, 0x43, 0x44, 0x45 },
+        { 0xDE, 0xAD, 0x00, 0xEF, 0xBE, 0xAD },
+        { 0x1F, 0x34, 0x56, 0x00, 0x78 },
+        { 0x00, 0x42, 0x43, 0x00 },
+        { 0xCA, 0xFE, 0xB7, 0xBE }
+    }};
+
+    std::vector<u64> positions = { 0, data.size() - 6 };
+    for (const u64 boundary : std::array<u64, 5>{ 1_MiB, 2_MiB, 1_MiB + 5, 2_MiB + 10, 3_MiB + 15 }) {
+        for (u64 position = boundary - 6; position <= boundary; position += 1)
+            positions.push_back(position);
+    }
+    for (u32 i = 0; i < 2000; i += 1)
+        positions.push_back(random() % (data.size() - 6));
+
+    for (const auto position : positions) {
+        const auto &bytes = planted[random() % planted.size()];
+        std::ranges::copy(bytes, data.begin() + position);
+    }
+
+    // Constants right at the start and the end of the data. The first one is contained in two groups and has to be reported twice
+    std::ranges::copy(planted[0], data.begin());
+    std::ranges::copy(planted[1], data.end() - planted[1].size());
+
+    using Match = std::pair<u64, const Constant*>;
+    std::vector<Match> expected;
+    for (const auto &group : groups) {
+        for (const auto &constant : group.getConstants()) {
+            const auto &patterns = constant.value.getPatterns();
+            for (u64 address = 0; address + patterns.size() <= data.size(); address += 1) {
+                bool matches = true;
+                for (size_t i = 0; i < patterns.size() && matches; i += 1)
+                    matches = (data[address + i] & patterns[i].mask) == patterns[i].value;
+
+                if (matches)
+                    expected.emplace_back(address, &constant);
+            }
+        }
+    }
+    std::ranges::sort(expected);
+
+    std::vector<Match> found;
+    const auto collect = [&](u64 address, const ConstantGroup &, const Constant &constant) { found.emplace_back(address, &constant); };
+
+    matcher.find(data, collect);
+    std::ranges::sort(found);
+    TEST_ASSERT(found == expected, "found {} of {} constants in memory", found.size(), expected.size());
+
+    auto &provider = *ImHexApi::Provider::createProvider("hex.builtin.provider.mem_file", true);
+    provider.resize(data.size());
+    provider.write(0, data.data(), data.size());
+    Task task("hex.test.task", ProgressValue::None(), false, false, [](Task &) {});
+
+    found.clear();
+    matcher.findAll(task, &provider, { .address=0, .size=data.size() }, collect);
+    std::ranges::sort(found);
+    TEST_ASSERT(found == expected, "found {} of {} constants in the provider", found.size(), expected.size());
+
+    // Search partitions the way the find view does, extended by the largest constant and only keeping what starts inside of them
+    for (const u64 partitionSize : std::array<u64, 3>{ 1_MiB, 1_MiB + 5, 0x12345 }) {
+        found.clear();
+        for (u64 address = 0; address < data.size(); address += partitionSize) {
+            const auto partitionEnd = std::min<u64>(address + partitionSize, data.size());
+            const auto searchEnd = std::min<u64>(partitionEnd + matcher.getMaxSize(), data.size());
+
+            matcher.findAll(task, &provider, { .address=address, .size=searchEnd - address }, [&](u64 match, const ConstantGroup &, const Constant &constant) {
+                if (match < partitionEnd)
+                    found.emplace_back(match, &constant);
+            });
+        }
+
+        std::ranges::sort(found);
+        TEST_ASSERT(found == expected, "partition size {:#x}: found {} of {} constants", partitionSize, found.size(), expected.size());
+    }
+
+    // Constants that don't fit into the searched region entirely must not be reported
+    const hex::Region region = { .address=1_MiB - 3, .size=0x100 };
+    found.clear();
+    matcher.findAll(task, &provider, region, collect);
+    std::ranges::sort(found);
+
+    std::vector<Match> expectedInRegion;
+    std::ranges::copy_if(expected, std::back_inserter(expectedInRegion), [&](const Match &match) {
+        return match.first >= region.getStartAddress() && match.first + match.second->value.getSize() - 1 <= region.getEndAddress();
+    });
+    TEST_ASSERT(found == expectedInRegion);
+
+    ImHexApi::Provider::remove(&provider, true);
+
+    TEST_SUCCESS();
+};
+
 TEST_SEQUENCE("Project/ParseLegacy") {
     const auto projectPath = std::filesystem::current_path() / "legacy_project_test.hexproj";
     std::filesystem::remove(projectPath);
@@ -148,6 +148,7 @@ namespace hex::plugin::remote {
     private:
         LIBSSH2_SFTP_HANDLE* m_handle = nullptr;
         bool m_atEOF = false;
+        u64 m_size = 0;
     };
 
     class RemoteFileSSH : public SSHClient::RemoteFile {
@@ -171,7 +172,7 @@ namespace hex::plugin::remote {
         void close() override;
 
     private:
-        std::vector<u8> executeCommand(const std::string &command, std::span<const u8> writeData = {}) const;
+        std::vector<u8> executeCommand(const std::string &command, std::span<const u8> writeData = {}, size_t expectedSize = 0) const;
 
     private:
         LIBSSH2_SESSION *m_handle = nullptr;
@@ -7,6 +7,9 @@
 #include <hex/providers/matchers/magic.hpp>
 #include <hex/providers/matchers/provider_type.hpp>
 
+#include <mutex>
+#include <vector>
+
 namespace hex::plugin::remote {
 
     class SSHProvider : public prv::CachedProvider,
@@ -49,6 +52,9 @@ namespace hex::plugin::remote {
         };
 
     private:
+        constexpr static size_t MinReadaheadSize = 64 * 1024;
+        constexpr static size_t MaxReadaheadSize = 4 * 1024 * 1024;
+
         SSHClient m_sftpClient;
         std::unique_ptr<SSHClient::RemoteFile> m_remoteFile;
 
@@ -62,7 +68,17 @@ namespace hex::plugin::remote {
 
         bool m_selectedFile = false;
         bool m_accessFileOverSSH = false;
+        bool m_bufferWrites = false;
         std::fs::path m_remoteFilePath = { "/", std::fs::path::format::generic_format };
+
+        // The SSH session can only be used by one thread at a time
+        mutable std::mutex m_mutex;
+
+        // Data following the last block that was read sequentially, fetched together with that block
+        u64 m_nextSequentialOffset = 0;
+        size_t m_readaheadSize = 0;
+        u64 m_readaheadAddress = 0;
+        std::vector<u8> m_readaheadData;
     };
 
 }
\ No newline at end of file
@@ -3,7 +3,9 @@
 #include <hex/helpers/logger.hpp>
 #include <wolv/utils/string.hpp>
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <charconv>
 
 #if defined(OS_WINDOWS)
@@ -12,6 +14,38 @@
 
 namespace hex::plugin::remote {
 
+    namespace {
+
+        constexpr static u64 MaxBlockSize      = 1024 * 1024;
+        constexpr static u64 MinReadBlockSize  = 4 * 1024;
+        constexpr static u64 MinWriteBlockSize = 4 * 1024;
+
+        /**
+         * @brief Picks the block size for dd to read the given range with
+         * @note Reading a few bytes more than requested is a lot cheaper than having dd issue tiny reads,
+         *       so the block size only gets smaller than the requested size to not transfer too much extra data
+         */
+        u64 getReadBlockSize(u64 offset, u64 size) {
+            auto blockSize = std::min(std::bit_floor(size), MaxBlockSize);
+            while (blockSize > MinReadBlockSize && offset % blockSize != 0)
+                blockSize /= 2;
+
+            return blockSize;
+        }
+
+        /**
+         * @brief Picks the largest block size for dd to write at the given offset with
+         * @note Blocks need to line up with the offset exactly since dd can only seek in multiples of the block size
+         */
+        u64 getWriteBlockSize(u64 offset) {
+            if (offset == 0)
+                return MaxBlockSize;
+
+            return std::min(offset & (~offset + 1), MaxBlockSize);
+        }
+
+    }
+
     void SSHClient::init() {
         libssh2_init(0);
     }
@@ -248,7 +282,10 @@ namespace hex::plugin::remote {
         return fmt::format("{} ({})", std::string(errorString, static_cast<size_t>(length)), libssh2_session_last_errno(session));
     }
 
-    RemoteFileSFTP::RemoteFileSFTP(LIBSSH2_SFTP_HANDLE* handle, SSHClient::OpenMode mode) : RemoteFile(mode), m_handle(handle) {}
+    RemoteFileSFTP::RemoteFileSFTP(LIBSSH2_SFTP_HANDLE* handle, SSHClient::OpenMode mode) : RemoteFile(mode), m_handle(handle) {
+        // Querying the size needs a full round trip to the server, so don't do it again for every read
+        m_size = this->size();
+    }
 
     RemoteFileSFTP::~RemoteFileSFTP() {
         if (m_handle) {
@@ -258,34 +295,55 @@ namespace hex::plugin::remote {
     }
 
     size_t RemoteFileSFTP::read(std::span<u8> buffer) {
-        auto dataSize = this->size();
-        auto offset = this->tell();
+        const auto offset = this->tell();
 
-        if (offset > dataSize || buffer.empty())
+        if (offset >= m_size) {
+            m_atEOF = true;
             return 0;
+        }
 
-        ssize_t n = libssh2_sftp_read(m_handle, reinterpret_cast<char*>(buffer.data()), std::min<u64>(buffer.size_bytes(), dataSize - offset));
-        if (n < 0)
-            return 0;
-        if (n == 0)
-            m_atEOF = true;
+        buffer = buffer.first(std::min<u64>(buffer.size(), m_size - offset));
+
+        // libssh2 splits large reads into multiple SFTP read requests and sends all of them before waiting for the first response.
+        // It returns as soon as the first response came in though, so keep reading until the whole buffer is filled
+        size_t bytesRead = 0;
+        while (bytesRead < buffer.size()) {
+            ssize_t n = libssh2_sftp_read(m_handle, reinterpret_cast<char*>(buffer.data() + bytesRead), buffer.size() - bytesRead);
+            if (n < 0)
+                break;
+            if (n == 0) {
+                m_atEOF = true;
+                break;
+            }
+
+            bytesRead += static_cast<size_t>(n);
+        }
 
-        return static_cast<size_t>(n);
+        return bytesRead;
     }
 
     size_t RemoteFileSFTP::write(std::span<const u8> buffer) {
-        if (buffer.empty())
-            return 0;
+        const auto offset = this->tell();
 
-        ssize_t n = libssh2_sftp_write(m_handle, reinterpret_cast<const char*>(buffer.data()), buffer.size_bytes());
-        if (n < 0)
-            return 0;
+        size_t bytesWritten = 0;
+        while (bytesWritten < buffer.size()) {
+            ssize_t n = libssh2_sftp_write(m_handle, reinterpret_cast<const char*>(buffer.data() + bytesWritten), buffer.size() - bytesWritten);
+            if (n <= 0)
+                break;
+
+            bytesWritten += static_cast<size_t>(n);
+        }
 
-        return static_cast<size_t>(n);
+        m_size = std::max<u64>(m_size, offset + bytesWritten);
+
+        return bytesWritten;
     }
 
     void RemoteFileSFTP::seek(uint64_t offset) {
-        libssh2_sftp_seek64(m_handle, offset);
+        // Seeking drops all read requests libssh2 already sent ahead, so only do it if the position actually changes
+        if (offset != this->tell())
+            libssh2_sftp_seek64(m_handle, offset);
+
         m_atEOF = false;
     }
 
@@ -317,8 +375,10 @@ namespace hex::plugin::remote {
 
     RemoteFileSSH::RemoteFileSSH(LIBSSH2_SESSION *handle, std::string path, SSHClient::OpenMode mode)
         : RemoteFile(mode), m_handle(handle) {
-        m_readCommand  = fmt::format("dd if=\"{0}\" skip={{0}} count={{1}} bs=1", path);
-        m_writeCommand = fmt::format("dd of=\"{0}\" seek={{0}} count={{1}} bs=1 conv=notrunc", path);
+        // Writes don't specify a count but instead end when all data has been sent. With only obs specified, dd collects
+        // its input into full output blocks, even if it arrives in short pieces
+        m_readCommand  = fmt::format("dd if=\"{0}\" bs={{2}} skip={{0}} count={{1}}", path);
+        m_writeCommand = fmt::format("dd of=\"{0}\" obs={{1}} seek={{0}} conv=notrunc", path);
         m_sizeCommand  = fmt::format("(fdisk -l \"{0}\" | head -n 1 | cut -d',' -f2 | cut -d' ' -f2) || (stat -c%s \"{0}\")", path);
     }
 
@@ -334,10 +394,21 @@ namespace hex::plugin::remote {
         if (buffer.empty())
             return 0;
 
-        auto result = executeCommand(fmt::format(fmt::runtime(m_readCommand), offset, buffer.size()));
+        const auto blockSize = getReadBlockSize(offset, buffer.size());
+        const auto firstBlock = offset / blockSize;
+        const auto blockCount = (offset + buffer.size() + blockSize - 1) / blockSize - firstBlock;
 
-        auto size = std::min(result.size(), buffer.size());
-        std::memcpy(buffer.data(), result.data(), size);
+        auto result = executeCommand(fmt::format(fmt::runtime(m_readCommand), firstBlock, blockCount, blockSize), {}, blockCount * blockSize);
+
+        // Skip the part of the first block that lies before the requested offset
+        const auto leadingSize = offset - firstBlock * blockSize;
+        if (result.size() <= leadingSize) {
+            m_atEOF = true;
+            return 0;
+        }
+
+        auto size = std::min<size_t>(result.size() - leadingSize, buffer.size());
+        std::memcpy(buffer.data(), result.data() + leadingSize, size);
 
         return size;
     }
@@ -349,10 +420,21 @@ namespace hex::plugin::remote {
             return 0;
 
         // Send data via STDIN to dd command remotely
-        auto bytesWritten = executeCommand(
-            fmt::format(fmt::runtime(m_writeCommand), offset, buffer.size()),
-            buffer
-        );
+        const auto writeBlocks = [this](u64 offset, std::span<const u8> data) {
+            const auto blockSize = getWriteBlockSize(offset);
+            std::ignore = executeCommand(
+                fmt::format(fmt::runtime(m_writeCommand), offset / blockSize, blockSize),
+                data
+            );
+        };
+
+        // The block size has to divide the offset, so a write starting at an odd offset could only use single byte blocks.
+        // Write everything up to the next aligned offset on its own so the rest of the data can be written with large blocks
+        const auto headSize = std::min<u64>((MinWriteBlockSize - offset % MinWriteBlockSize) % MinWriteBlockSize, buffer.size());
+        if (headSize > 0)
+            writeBlocks(offset, buffer.first(headSize));
+        if (headSize < buffer.size())
+            writeBlocks(offset + headSize, buffer.subspan(headSize));
 
         return buffer.size();
     }
@@ -388,7 +470,7 @@ namespace hex::plugin::remote {
         m_handle = nullptr;
     }
 
-    std::vector<u8> RemoteFileSSH::executeCommand(const std::string &command, std::span<const u8> writeData) const {
+    std::vector<u8> RemoteFileSSH::executeCommand(const std::string &command, std::span<const u8> writeData, size_t expectedSize) const {
         std::lock_guard lock(m_mutex);
 
         LIBSSH2_CHANNEL* channel = libssh2_channel_open_session(m_handle);
@@ -405,12 +487,21 @@ namespace hex::plugin::remote {
             return {};
         }
 
-        if (!writeData.empty()) {
-            libssh2_channel_write(channel, reinterpret_cast<const char*>(writeData.data()), writeData.size());
+        while (!writeData.empty()) {
+            const auto rc = libssh2_channel_write(channel, reinterpret_cast<const char*>(writeData.data()), writeData.size());
+            if (rc > 0)
+                writeData = writeData.subspan(rc);
+            else if (rc != LIBSSH2_ERROR_EAGAIN)
+                break;
         }
 
+        // Let the command know that there's no more input coming
+        libssh2_channel_send_eof(channel);
+
         std::vector<u8> result;
-        std::array<char, 1024> buffer;
+        result.reserve(expectedSize);
+
+        std::vector<char> buffer(64 * 1024);
         while (true) {
             const auto rc = libssh2_channel_read(channel, buffer.data(), buffer.size());
             if (rc > 0) {
@@ -422,8 +513,6 @@ namespace hex::plugin::remote {
             }
         }
 
-        libssh2_channel_send_eof(channel);
-
         return result;
     }
 
@@ -9,10 +9,14 @@
 #include <nlohmann/json.hpp>
 #include <toasts/toast_notification.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 namespace hex::plugin::remote {
 
     prv::Provider::OpenResult SSHProvider::open() {
         CachedProvider::open();
+        this->setWritePolicy(m_bufferWrites ? WritePolicy::WriteBack : WritePolicy::WriteThrough);
 
         if (!m_sftpClient.isConnected()) {
             try {
@@ -45,31 +49,71 @@ namespace hex::plugin::remote {
     }
 
     void SSHProvider::close() {
+        // Write out any pending changes while the remote file is still open
+        CachedProvider::close();
+
         if (m_remoteFile != nullptr)
             m_remoteFile->close();
 
-        m_sftpClient.disconnect();
+        m_nextSequentialOffset = 0;
+        m_readaheadSize = 0;
+        m_readaheadData.clear();
 
-        CachedProvider::close();
+        m_sftpClient.disconnect();
     }
 
     void SSHProvider::save() {
         if (m_sftpClient.isConnected() && m_remoteFile->isOpen()) {
+            CachedProvider::save();
             m_remoteFile->flush();
         }
     }
 
     void SSHProvider::readFromSource(u64 offset, void* buffer, size_t size) {
+        std::scoped_lock lock(m_mutex);
+
+        const bool sequential = offset == m_nextSequentialOffset;
+        m_nextSequentialOffset = offset + size;
+
+        if (offset >= m_readaheadAddress && offset + size <= m_readaheadAddress + m_readaheadData.size()) {
+            std::memcpy(buffer, m_readaheadData.data() + (offset - m_readaheadAddress), size);
+            return;
+        }
+
+        // Every request needs a full round trip to the server, so fetch more and more of the following data
+        // together with the requested block for as long as the file is being read sequentially
+        if (sequential)
+            m_readaheadSize = std::clamp<size_t>(m_readaheadSize * 2, MinReadaheadSize, MaxReadaheadSize);
+        else
+            m_readaheadSize = 0;
+
+        std::vector<u8> data(size + m_readaheadSize);
         m_remoteFile->seek(offset);
-        std::ignore = m_remoteFile->read({ static_cast<u8*>(buffer), size });
+        const auto bytesRead = m_remoteFile->read(data);
+
+        std::memcpy(buffer, data.data(), std::min(bytesRead, size));
+        if (bytesRead < size)
+            std::memset(static_cast<u8*>(buffer) + bytesRead, 0x00, size - bytesRead);
+
+        m_readaheadAddress = offset + size;
+        if (bytesRead > size)
+            m_readaheadData.assign(data.begin() + size, data.begin() + bytesRead);
+        else
+            m_readaheadData.clear();
     }
 
     void SSHProvider::writeToSource(u64 offset, const void* buffer, size_t size) {
+        std::scoped_lock lock(m_mutex);
+
+        m_readaheadData.clear();
+
         m_remoteFile->seek(offset);
         std::ignore = m_remoteFile->write({ static_cast<const u8*>(buffer), size });
     }
 
     u64 SSHProvider::getSourceSize() const {
+        std::scoped_lock lock(m_mutex);
+
         auto size = m_remoteFile->size();
         if (size == 0)
             return std::numeric_limits<u32>::max();
@@ -161,6 +205,7 @@ namespace hex::plugin::remote {
 
             ImGui::NewLine();
             ImGui::Checkbox("hex.plugin.remote.ssh_provider.ssh_access"_lang, &m_accessFileOverSSH);
+            ImGui::Checkbox("hex.plugin.remote.ssh_provider.buffer_writes"_lang, &m_bufferWrites);
         }
 
         return m_selectedFile;
@@ -180,6 +225,7 @@ namespace hex::plugin::remote {
 
         settings["remoteFilePath"] = wolv::util::toUTF8String(m_remoteFilePath);
         settings["accessFileOverSSH"] = m_accessFileOverSSH;
+        settings["bufferWrites"] = m_bufferWrites;
 
         return Provider::storeSettings(settings);
     }
@@ -200,6 +246,7 @@ namespace hex::plugin::remote {
 
         m_remoteFilePath = settings.value("remoteFilePath", "");
         m_accessFileOverSSH = settings.value("accessFileOverSSH", false);
+        m_bufferWrites = settings.value("bufferWrites", false);
     }
 
 }
@@ -352,16 +352,31 @@ namespace hex::ui {
         }
         drawList->ChannelsSetCurrent(0);
 
-        std::vector<u8> rowData(bytesPerRow);
         std::vector<ImColor> rowColors;
         const auto drawStart = std::max<ImS64>(0, scrollPos - grabPos);
-        for (ImS64 y = drawStart; y < std::min<ImS64>(drawStart + rowCount, m_provider->getSize() / bytesPerRow); y += 1) {
+        const auto drawEnd = std::min<ImS64>(drawStart + rowCount, m_provider->getSize() / bytesPerRow);
+
+        // Fetch the data of all visible rows at once instead of issuing one read per row
+        std::vector<u8> minimapData(std::max<ImS64>(0, drawEnd - drawStart) * bytesPerRow);
+        {
+            std::vector<prv::Provider::ReadRequest> requests;
+            for (ImS64 y = drawStart; y < drawEnd; y += 1) {
+                requests.push_back({
+                    .offset = y * bytesPerRow + m_provider->getBaseAddress() + m_provider->getCurrentPageAddress(),
+                    .buffer = minimapData.data() + (y - drawStart) * bytesPerRow,
+                    .size   = size_t(bytesPerRow)
+                });
+            }
+            m_provider->readBatch(requests);
+        }
+
+        for (ImS64 y = drawStart; y < drawEnd; y += 1) {
             const auto rowStart = bb.Min + ImVec2(0, (y - drawStart) * rowHeight);
             const auto rowEnd = rowStart + ImVec2(bb.GetSize().x, rowHeight);
             const auto rowSize = rowEnd - rowStart;
 
             const auto address = y * bytesPerRow + m_provider->getBaseAddress() + m_provider->getCurrentPageAddress();
-            m_provider->read(address, rowData.data(), rowData.size());
+            const auto rowData = std::span<const u8>(minimapData).subspan((y - drawStart) * bytesPerRow, bytesPerRow);
 
             m_miniMapVisualizer->callback(address, rowData, rowColors);
 
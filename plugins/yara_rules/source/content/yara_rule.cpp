@@ -151,6 +151,7 @@ namespace hex::plugin::yara {
             prv::Provider *provider;
             Region region;
             std::vector<u8> buffer;
+            std::optional<prv::Provider::ContiguousView> view;
             YR_MEMORY_BLOCK currBlock = {};
         };
 
@@ -162,13 +163,19 @@ namespace hex::plugin::yara {
         context.currBlock.fetch_data = [](YR_MEMORY_BLOCK *block) -> const u8 * {
             auto &context = *static_cast<ScanContext *>(block->context);
 
-            context.buffer.resize(context.currBlock.size);
-
-            if (context.buffer.empty())
+            if (context.currBlock.size == 0)
                 return nullptr;
 
             block->size = context.currBlock.size;
-            context.provider->read(context.provider->getBaseAddress() + context.currBlock.base, context.buffer.data(), context.buffer.size());
+
+            // Scan data that's already in memory in place instead of copying every block into a buffer first
+            const auto address = context.provider->getBaseAddress() + context.currBlock.base;
+            context.view = context.provider->tryGetContiguousView(Region { .address=address, .size=context.currBlock.size });
+            if (context.view.has_value())
+                return context.view->data();
+
+            context.buffer.resize(context.currBlock.size);
+            context.provider->read(address, context.buffer.data(), context.buffer.size());
 
             return context.buffer.data();
         };
@@ -185,6 +192,7 @@ namespace hex::plugin::yara {
             context.currBlock.base = context.region.address;
             context.currBlock.size = 0;
             context.buffer.clear();
+            context.view.reset();
             iterator->last_error = ERROR_SUCCESS;
 
             return iterator->next(iterator);
@@ -0,0 +1,163 @@
+#include <hex/test/tests.hpp>
+#include <hex/providers/cached_provider.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    class TestCachedProvider : public hex::prv::CachedProvider {
+    public:
+        TestCachedProvider(size_t blockSize, size_t budget, size_t associativity) : CachedProvider(blockSize, budget, associativity) {
+            m_data.resize(0x400);
+            for (size_t i = 0; i < m_data.size(); i += 1)
+                m_data[i] = u8(i * 7);
+        }
+
+        [[nodiscard]] bool isAvailable() const override { return true; }
+        [[nodiscard]] bool isReadable() const override { return true; }
+        [[nodiscard]] bool isWritable() const override { return true; }
+        [[nodiscard]] bool isResizable() const override { return false; }
+        [[nodiscard]] bool isSavable() const override { return false; }
+
+        [[nodiscard]] std::string getName() const override { return ""; }
+        [[nodiscard]] const char* getIcon() const override { return ""; }
+        [[nodiscard]] hex::UnlocalizedString getTypeName() const override { return "hex.test.provider.cached"; }
+
+        [[nodiscard]] const std::vector<u8>& getData() const { return m_data; }
+        [[nodiscard]] u32 getSourceWriteCount() const { return m_sourceWrites; }
+        [[nodiscard]] u32 getCacheClearCount() const { return m_cacheClears; }
+
+        // Modifies the source behind the cache's back, like a live target changing its memory
+        void changeSource(u64 offset, u8 value) { m_data[offset] = value; }
+
+    protected:
+        void readFromSource(u64 offset, void *buffer, size_t size) override {
+            std::memset(buffer, 0x00, size);
+            if (offset < m_data.size())
+                std::memcpy(buffer, m_data.data() + offset, std::min<size_t>(size, m_data.size() - offset));
+        }
+
+        void writeToSource(u64 offset, const void *buffer, size_t size) override {
+            std::memcpy(m_data.data() + offset, buffer, size);
+            m_sourceWrites += 1;
+        }
+
+        [[nodiscard]] u64 getSourceSize() const override { return m_data.size(); }
+        void onCacheCleared() override { m_cacheClears += 1; }
+
+    private:
+        std::vector<u8> m_data;
+        u32 m_sourceWrites = 0;
+        u32 m_cacheClears = 0;
+    };
+
+}
+
+TEST_SEQUENCE("CachedProvider_LRU") {
+    // A single set with four ways
+    TestCachedProvider provider(0x10, 0x40, 4);
+    u8 byte = 0x00;
+
+    for (u64 block = 0; block < 4; block += 1)
+        provider.readRaw(block * 0x10, &byte, 1);
+    provider.readRaw(0x00, &byte, 1);
+
+    auto statistics = provider.getCacheStatistics();
+    TEST_ASSERT(statistics.hits == 1);
+    TEST_ASSERT(statistics.misses == 4);
+    TEST_ASSERT(statistics.evictions == 0);
+    TEST_ASSERT(statistics.bytesFetched == 0x40);
+
+    // Block 1 is now the least recently used one and gets replaced, block 0 has to survive
+    provider.readRaw(0x40, &byte, 1);
+    provider.readRaw(0x00, &byte, 1);
+    statistics = provider.getCacheStatistics();
+    TEST_ASSERT(statistics.hits == 2);
+    TEST_ASSERT(statistics.evictions == 1);
+
+    provider.readRaw(0x10, &byte, 1);
+    statistics = provider.getCacheStatistics();
+    TEST_ASSERT(statistics.misses == 6);
+    TEST_ASSERT(statistics.evictions == 2);
+
+    provider.resetCacheStatistics();
+    TEST_ASSERT(provider.getCacheStatistics().hits == 0);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("CachedProvider_ReadWrite") {
+    TestCachedProvider provider(0x10, 0x100, 2);
+
+    u8 buffer[0x30] = { };
+    provider.readRaw(0x05, buffer, sizeof(buffer));
+    for (size_t i = 0; i < sizeof(buffer); i += 1)
+        TEST_ASSERT(buffer[i] == u8((0x05 + i) * 7), "at index {}", i);
+
+    const u8 data[] = { 0x11, 0x22, 0x33 };
+    provider.writeRaw(0x0E, data, sizeof(data));
+    TEST_ASSERT(provider.getData()[0x0E] == 0x11);
+    TEST_ASSERT(provider.getData()[0x10] == 0x33);
+
+    provider.readRaw(0x0D, buffer, 5);
+    TEST_ASSERT(buffer[0] == u8(0x0D * 7));
+    TEST_ASSERT(buffer[1] == 0x11 && buffer[2] == 0x22 && buffer[3] == 0x33);
+    TEST_ASSERT(buffer[4] == u8(0x11 * 7));
+
+    // Dropping the cached blocks has to be passed on to the subclass and makes changes of the source visible
+    provider.changeSource(0x05, 0x99);
+    const auto clearCount = provider.getCacheClearCount();
+    provider.setCacheBudget(0x100);
+    TEST_ASSERT(provider.getCacheClearCount() == clearCount + 1);
+    provider.readRaw(0x05, buffer, 1);
+    TEST_ASSERT(buffer[0] == 0x99);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("CachedProvider_WriteBack") {
+    TestCachedProvider provider(0x10, 0x100, 2);
+    provider.setWritePolicy(hex::prv::CachedProvider::WritePolicy::WriteBack);
+
+    std::vector<u8> data(0x28);
+    for (size_t i = 0; i < data.size(); i += 1)
+        data[i] = u8(0xA0 + i);
+
+    // Split the write up so it touches three blocks in multiple chunks
+    provider.writeRaw(0x08, data.data(), 0x10);
+    provider.writeRaw(0x18, data.data() + 0x10, 0x18);
+    TEST_ASSERT(provider.getSourceWriteCount() == 0);
+    TEST_ASSERT(provider.getData()[0x08] == u8(0x08 * 7));
+
+    u8 buffer[0x28] = { };
+    provider.readRaw(0x08, buffer, sizeof(buffer));
+    TEST_ASSERT(std::equal(data.begin(), data.end(), buffer));
+
+    // All adjacent modifications need to be written back in a single write
+    provider.flushCache();
+    TEST_ASSERT(provider.getSourceWriteCount() == 1);
+    TEST_ASSERT(std::equal(data.begin(), data.end(), provider.getData().begin() + 0x08));
+    TEST_ASSERT(provider.getData()[0x07] == u8(0x07 * 7));
+    TEST_ASSERT(provider.getData()[0x30] == u8(0x30 * 7));
+
+    provider.flushCache();
+    TEST_ASSERT(provider.getSourceWriteCount() == 1);
+
+    // Bytes in between two modifications of the same block have to be left alone, the source may have changed them in the meantime
+    provider.writeRaw(0x42, data.data(), 2);
+    provider.writeRaw(0x4C, data.data() + 2, 2);
+    provider.changeSource(0x46, 0x55);
+    provider.flushCache();
+    TEST_ASSERT(provider.getSourceWriteCount() == 3);
+    TEST_ASSERT(provider.getData()[0x43] == data[1] && provider.getData()[0x4C] == data[2]);
+    TEST_ASSERT(provider.getData()[0x46] == 0x55);
+
+    provider.setWritePolicy(hex::prv::CachedProvider::WritePolicy::WriteThrough);
+    provider.writeRaw(0x80, data.data(), 1);
+    TEST_ASSERT(provider.getSourceWriteCount() == 4);
+    TEST_ASSERT(provider.getData()[0x80] == data[0]);
+
+    TEST_SUCCESS();
+};
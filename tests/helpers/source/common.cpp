@@ -1,9 +1,14 @@
 #include <algorithm>
 #include <hex/test/tests.hpp>
 #include <hex/test/test_provider.hpp>
+#include <hex/providers/memory_provider.hpp>
+#include <hex/providers/concatenated_provider.hpp>
 
 #include <hex/helpers/crypto.hpp>
 
+#include <array>
+#include <memory>
+#include <tuple>
 #include <vector>
 
 TEST_SEQUENCE("TestSucceeding") {
@@ -77,3 +82,138 @@ TEST_SEQUENCE("TestProvider_write") {
 
     TEST_SUCCESS();
 };
+
+TEST_SEQUENCE("TestProvider_readBatch") {
+    std::vector<u8> data { 0xde, 0xad, 0xbe, 0xef, 0x42, 0x2a, 0x00, 0xff };
+    hex::test::TestProvider provider(&data);
+    hex::prv::Provider *provider2 = &provider;
+
+    u8 first[2] = { 22, 22 }, second[3] = { 22, 22, 22 }, outOfBounds[2] = { 22, 22 };
+    const std::array<hex::prv::Provider::ReadRequest, 3> requests = {{
+        { .offset = 6, .buffer = first,       .size = sizeof(first) },
+        { .offset = 1, .buffer = second,      .size = sizeof(second) },
+        { .offset = 7, .buffer = outOfBounds, .size = sizeof(outOfBounds) },
+    }};
+    provider2->readBatch(requests);
+
+    TEST_ASSERT(first[0] == 0x00);
+    TEST_ASSERT(first[1] == 0xff);
+    TEST_ASSERT(second[0] == 0xad);
+    TEST_ASSERT(second[1] == 0xbe);
+    TEST_ASSERT(second[2] == 0xef);
+    TEST_ASSERT(outOfBounds[0] == 22 && outOfBounds[1] == 22);    // should be unchanged
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("TestProvider_overlays") {
+    std::vector<u8> data(8, 0x00);
+    hex::test::TestProvider provider(&data);
+    hex::prv::Provider *provider2 = &provider;
+
+    auto first = provider.newOverlay();
+    first->setAddress(2);
+    first->setData({ 0x11, 0x11, 0x11, 0x11 });
+
+    auto second = provider.newOverlay();
+    second->setAddress(4);
+    second->setData({ 0x22, 0x22, 0x22, 0x22, 0x22, 0x22 });
+
+    std::array<u8, 12> buffer = { };
+    provider2->read(0, buffer.data(), buffer.size());
+    TEST_ASSERT((buffer == std::array<u8, 12>{ 0x00, 0x00, 0x11, 0x11, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x00, 0x00 }));
+
+    // Overlays created later take precedence, moving one updates what reads return
+    first->setAddress(5);
+    buffer.fill(0x00);
+    provider2->read(0, buffer.data(), buffer.size());
+    TEST_ASSERT((buffer == std::array<u8, 12>{ 0x00, 0x00, 0x00, 0x00, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x00, 0x00 }));
+
+    auto [region, valid] = provider2->getRegionValidity(9);
+    TEST_ASSERT(valid && region.getStartAddress() == 9 && region.getEndAddress() == 9);
+    std::tie(region, valid) = provider2->getRegionValidity(10);
+    TEST_ASSERT(!valid && region == hex::Region::Invalid());
+
+    provider.deleteOverlay(second);
+    buffer.fill(0x00);
+    provider2->read(0, buffer.data(), buffer.size());
+    TEST_ASSERT((buffer == std::array<u8, 12>{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x11, 0x11, 0x11, 0x11, 0x00, 0x00, 0x00 }));
+
+    provider.deleteOverlay(first);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("TestProvider_contiguousView") {
+    std::vector<u8> data { 0xde, 0xad, 0xbe, 0xef, 0x42, 0x2a, 0x00, 0xff };
+    hex::prv::MemoryProvider provider(data);
+    hex::test::TestProvider copyingProvider(&data);
+
+    auto view = provider.tryGetContiguousView({ .address = 2, .size = 4 });
+    TEST_ASSERT(view.has_value());
+    TEST_ASSERT(view->size() == 4);
+    TEST_ASSERT(std::equal(view->getData().begin(), view->getData().end(), data.begin() + 2));
+
+    TEST_ASSERT(!provider.tryGetContiguousView({ .address = 6, .size = 4 }).has_value());     // out of bounds
+    TEST_ASSERT(!copyingProvider.tryGetContiguousView({ .address = 2, .size = 4 }).has_value()); // data not in memory
+
+    auto overlay = provider.newOverlay();
+    overlay->setAddress(5);
+    overlay->setData({ 0x11 });
+    TEST_ASSERT(!provider.tryGetContiguousView({ .address = 4, .size = 2 }).has_value());     // covered by an overlay
+    TEST_ASSERT(provider.tryGetContiguousView({ .address = 0, .size = 4 }).has_value());
+    provider.deleteOverlay(overlay);
+
+    // Hashing in place has to give the same result as hashing a copy
+    hex::prv::Provider *viewProvider = &provider, *readProvider = &copyingProvider;
+    TEST_ASSERT(hex::crypt::crc32(viewProvider, 0, data.size(), 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true) == hex::crypt::crc32(readProvider, 0, data.size(), 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true, true));
+
+    // Views have to stay valid even if the data gets reallocated while they're still in use
+    provider.resizeRaw(0x10000);
+    TEST_ASSERT(std::equal(view->getData().begin(), view->getData().end(), data.begin() + 2));
+
+    u8 byte = 0x00;
+    provider.readRaw(3, &byte, 1);
+    TEST_ASSERT(byte == data[3]);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("ConcatenatedProvider_read") {
+    std::array<std::vector<u8>, 4> sources;
+    std::vector<std::unique_ptr<hex::test::TestProvider>> providers;
+    for (size_t i = 0; i < sources.size(); i += 1) {
+        sources[i].resize(0x40000);
+        for (size_t j = 0; j < sources[i].size(); j += 1)
+            sources[i][j] = u8(i * 0x40 + j * 7);
+
+        providers.push_back(std::make_unique<hex::test::TestProvider>(&sources[i]));
+    }
+
+    // Interleave lots of small segments from all providers
+    hex::prv::ConcatenatedProvider provider;
+    std::vector<u8> expected;
+    for (u64 address = 0; address < 0x40000; address += 0x1000) {
+        for (size_t i = 0; i < providers.size(); i += 1) {
+            const auto size = 0x100 + i * 0x80;
+            provider.add(providers[i].get(), { address, size });
+            expected.insert(expected.end(), sources[i].begin() + address, sources[i].begin() + address + size);
+        }
+    }
+
+    TEST_ASSERT(provider.getActualSize() == expected.size());
+
+    // Small reads within and across segment boundaries
+    for (u64 offset : std::array<u64, 5>{ 0x00, 0xFF, 0x100, 0x2345, expected.size() - 0x10 }) {
+        std::array<u8, 0x10> buffer = { };
+        provider.read(offset, buffer.data(), buffer.size());
+        TEST_ASSERT(std::equal(buffer.begin(), buffer.end(), expected.begin() + offset), "offset {:#x}", offset);
+    }
+
+    // Large read that gets split up between all providers
+    std::vector<u8> buffer(expected.size() - 0x123);
+    provider.read(0x123, buffer.data(), buffer.size());
+    TEST_ASSERT(std::equal(buffer.begin(), buffer.end(), expected.begin() + 0x123));
+
+    TEST_SUCCESS();
+};
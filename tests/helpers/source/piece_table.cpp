@@ -0,0 +1,111 @@
+#include <hex/test/tests.hpp>
+#include <hex/providers/piece_table.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+    std::vector<u8> readAll(const hex::prv::PieceTable &pieceTable, const std::vector<u8> &original) {
+        std::vector<u8> result(pieceTable.getSize(), 0xCC);
+        pieceTable.read(0, result.data(), result.size(), [&original](u64 offset, void *buffer, size_t size) {
+            std::memcpy(buffer, original.data() + offset, size);
+        });
+
+        return result;
+    }
+
+}
+
+TEST_SEQUENCE("PieceTable_Edits") {
+    std::vector<u8> original(0x100);
+    for (size_t i = 0; i < original.size(); i += 1)
+        original[i] = u8(i);
+
+    hex::prv::PieceTable pieceTable(original.size());
+    TEST_ASSERT(!pieceTable.isModified());
+    TEST_ASSERT(readAll(pieceTable, original) == original);
+
+    pieceTable.insert(0x10, 4);
+    TEST_ASSERT(pieceTable.isModified());
+    TEST_ASSERT(pieceTable.getSize() == 0x104);
+
+    const u8 bytes[] = { 0xAA, 0xBB, 0xCC, 0xDD };
+    pieceTable.write(0x10, bytes, sizeof(bytes));
+
+    auto data = readAll(pieceTable, original);
+    TEST_ASSERT(data[0x0F] == 0x0F && data[0x10] == 0xAA && data[0x13] == 0xDD && data[0x14] == 0x10);
+
+    // Removing the inserted bytes again results in the original layout
+    pieceTable.remove(0x10, 4);
+    TEST_ASSERT(readAll(pieceTable, original) == original);
+    TEST_ASSERT(!pieceTable.isModified());
+    TEST_ASSERT(pieceTable.getPieces().size() == 1, "{}", pieceTable.getPieces().size());
+
+    pieceTable.resize(0x80);
+    TEST_ASSERT(pieceTable.getSize() == 0x80);
+    pieceTable.resize(0x90);
+    data = readAll(pieceTable, original);
+    TEST_ASSERT(data[0x7F] == 0x7F && data[0x80] == 0x00 && data[0x8F] == 0x00);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("PieceTable_RandomEdits") {
+    std::vector<u8> original(0x400);
+    for (size_t i = 0; i < original.size(); i += 1)
+        original[i] = u8(i * 13);
+
+    std::mt19937 random(1234);
+    hex::prv::PieceTable pieceTable(original.size());
+    std::vector<u8> expected = original;
+
+    for (u32 i = 0; i < 2000; i += 1) {
+        const auto offset = expected.empty() ? 0 : random() % (expected.size() + 1);
+        const auto size   = random() % 0x40;
+
+        switch (random() % 3) {
+            case 0:
+                pieceTable.insert(offset, size);
+                expected.insert(expected.begin() + offset, size, 0x00);
+                break;
+            case 1: {
+                pieceTable.remove(offset, size);
+                const auto end = std::min<size_t>(offset + size, expected.size());
+                if (offset < expected.size())
+                    expected.erase(expected.begin() + offset, expected.begin() + end);
+                break;
+            }
+            case 2: {
+                if (offset + size > expected.size())
+                    break;
+
+                std::vector<u8> bytes(size);
+                for (auto &byte : bytes)
+                    byte = u8(random());
+
+                pieceTable.write(offset, bytes.data(), bytes.size());
+                std::ranges::copy(bytes, expected.begin() + offset);
+                break;
+            }
+        }
+
+        TEST_ASSERT(pieceTable.getSize() == expected.size(), "Iteration {}: {} != {}", i, pieceTable.getSize(), expected.size());
+        TEST_ASSERT(readAll(pieceTable, original) == expected, "Iteration {}", i);
+
+        // Pieces have to line up without gaps and neighbouring pieces that continue each other have to be combined
+        const auto pieces = pieceTable.getPieces();
+        for (size_t index = 1; index < pieces.size(); index += 1) {
+            const auto &previous = pieces[index - 1];
+            const auto &current  = pieces[index];
+            TEST_ASSERT(previous.address + previous.size == current.address, "Iteration {}: Gap before piece {}", i, index);
+
+            const bool continues = previous.source == current.source && (current.source == hex::prv::PieceTable::Source::Zero || previous.sourceOffset + previous.size == current.sourceOffset);
+            TEST_ASSERT(!continues, "Iteration {}: Pieces {} and {} weren't combined", i, index - 1, index);
+        }
+    }
+
+    TEST_SUCCESS();
+};
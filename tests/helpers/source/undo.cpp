@@ -0,0 +1,171 @@
+#include <hex/test/tests.hpp>
+#include <hex/test/test_provider.hpp>
+#include <hex/providers/undo_redo/compact_buffer.hpp>
+#include <hex/providers/undo_redo/stack.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+    class TestWriteOperation : public hex::prv::undo::Operation {
+    public:
+        TestWriteOperation(u64 offset, std::vector<u8> oldData, std::vector<u8> newData)
+            : m_offset(offset), m_oldData(oldData), m_newData(newData) { }
+
+        void undo(hex::prv::Provider *provider) override {
+            const auto data = m_oldData.get();
+            provider->writeRaw(m_offset, data.data(), data.size());
+        }
+
+        void redo(hex::prv::Provider *provider) override {
+            const auto data = m_newData.get();
+            provider->writeRaw(m_offset, data.data(), data.size());
+        }
+
+        bool merge(const Operation &other) override {
+            const auto write = dynamic_cast<const TestWriteOperation*>(&other);
+            if (write == nullptr || write->m_offset != m_offset + m_newData.size())
+                return false;
+
+            auto oldData = m_oldData.get();
+            auto newData = m_newData.get();
+            const auto otherOldData = write->m_oldData.get();
+            const auto otherNewData = write->m_newData.get();
+            oldData.insert(oldData.end(), otherOldData.begin(), otherOldData.end());
+            newData.insert(newData.end(), otherNewData.begin(), otherNewData.end());
+
+            m_oldData = hex::prv::undo::CompactBuffer(oldData);
+            m_newData = hex::prv::undo::CompactBuffer(newData);
+
+            return true;
+        }
+
+        size_t getMemoryUsage() const override {
+            return m_oldData.getMemoryUsage() + m_newData.getMemoryUsage();
+        }
+
+        void offload(const std::shared_ptr<hex::prv::undo::SpillFile> &spillFile) override {
+            m_oldData.offload(spillFile);
+            m_newData.offload(spillFile);
+        }
+
+        bool isOffloaded() const {
+            return m_oldData.isOffloaded() && m_newData.isOffloaded();
+        }
+
+        std::string format() const override { return ""; }
+        hex::Region getRegion() const override { return { m_offset, m_newData.size() }; }
+        std::unique_ptr<Operation> clone() const override { return std::make_unique<TestWriteOperation>(*this); }
+
+    private:
+        u64 m_offset;
+        hex::prv::undo::CompactBuffer m_oldData, m_newData;
+    };
+
+    void writeByte(hex::test::TestProvider &provider, std::vector<u8> &data, u64 offset, u8 value) {
+        provider.getUndoStack().add<TestWriteOperation>(offset, std::vector<u8>{ data[offset] }, std::vector<u8>{ value });
+    }
+
+}
+
+TEST_SEQUENCE("UndoStack_CompactBuffer") {
+    using hex::prv::undo::CompactBuffer;
+
+    std::vector<u8> runs(0x10000, 0x00);
+    std::fill_n(runs.begin() + 0x1000, 0x200, 0xAA);
+    runs[0x8000] = 0x55;
+
+    std::vector<u8> noise(0x1000);
+    std::iota(noise.begin(), noise.end(), 0);
+
+    CompactBuffer compressed(runs);
+    TEST_ASSERT(compressed.size() == runs.size());
+    TEST_ASSERT(compressed.getMemoryUsage() < 0x100, "{}", compressed.getMemoryUsage());
+    TEST_ASSERT(compressed.get() == runs);
+
+    CompactBuffer uncompressed(noise);
+    TEST_ASSERT(uncompressed.get() == noise);
+    TEST_ASSERT(CompactBuffer(std::vector<u8>{}).empty());
+
+    auto spillFile = hex::prv::undo::createSpillFile();
+    TEST_ASSERT(spillFile != nullptr);
+
+    compressed.offload(spillFile);
+    uncompressed.offload(spillFile);
+    TEST_ASSERT(compressed.isOffloaded() && uncompressed.isOffloaded());
+    TEST_ASSERT(compressed.getMemoryUsage() == 0 && uncompressed.getMemoryUsage() == 0);
+    TEST_ASSERT(compressed.get() == runs);
+    TEST_ASSERT(uncompressed.get() == noise);
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("UndoStack_Merge") {
+    std::vector<u8> data(0x100, 0x00);
+    hex::test::TestProvider provider(&data);
+    auto &stack = provider.getUndoStack();
+
+    // Consecutive writes end up in a single operation
+    for (u8 i = 0; i < 4; i += 1)
+        writeByte(provider, data, 0x10 + i, 0x11 * (i + 1));
+
+    TEST_ASSERT(stack.getAppliedOperations().size() == 1);
+    TEST_ASSERT(data[0x10] == 0x11 && data[0x13] == 0x44);
+
+    // Grouping operations that have already been merged leaves them alone
+    stack.groupOperations(4, "");
+    TEST_ASSERT(stack.getAppliedOperations().size() == 1);
+
+    // Writes after sealing the stack aren't merged into earlier ones anymore
+    stack.sealOperations();
+    writeByte(provider, data, 0x14, 0x55);
+    TEST_ASSERT(stack.getAppliedOperations().size() == 2);
+
+    stack.undo();
+    TEST_ASSERT(data[0x14] == 0x00 && data[0x13] == 0x44);
+
+    // Redone operations aren't merged into either
+    stack.redo();
+    writeByte(provider, data, 0x15, 0x66);
+    TEST_ASSERT(stack.getAppliedOperations().size() == 3);
+
+    stack.undo(3);
+    TEST_ASSERT(std::ranges::all_of(data, [](u8 byte) { return byte == 0x00; }));
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("UndoStack_MemoryLimit") {
+    using hex::prv::undo::Stack;
+
+    std::vector<u8> data(0x4000, 0x00);
+    hex::test::TestProvider provider(&data);
+    auto &stack = provider.getUndoStack();
+
+    const auto previousLimit = Stack::getMemoryLimit();
+    Stack::setMemoryLimit(0x2000);
+
+    // Each write touches 0x1000 bytes of noise and doesn't compress
+    for (u64 i = 0; i < 4; i += 1) {
+        std::vector<u8> newData(0x1000);
+        std::iota(newData.begin(), newData.end(), u8(i + 1));
+
+        std::vector<u8> oldData(data.begin() + i * 0x1000, data.begin() + (i + 1) * 0x1000);
+        stack.add<TestWriteOperation>(i * 0x1000, oldData, newData);
+        stack.sealOperations();
+    }
+
+    Stack::setMemoryLimit(previousLimit);
+
+    TEST_ASSERT(stack.getMemoryUsage() <= 0x2000, "{}", stack.getMemoryUsage());
+    const auto &operations = stack.getAppliedOperations();
+    TEST_ASSERT(dynamic_cast<const TestWriteOperation&>(*operations.front()).isOffloaded());
+    TEST_ASSERT(!dynamic_cast<const TestWriteOperation&>(*operations.back()).isOffloaded());
+
+    stack.undo(4);
+    TEST_ASSERT(std::ranges::all_of(data, [](u8 byte) { return byte == 0x00; }));
+
+    TEST_SUCCESS();
+};
@@ -1,8 +1,14 @@
 #include <hex/test/tests.hpp>
 
+#include <hex/test/test_provider.hpp>
+
 #include <hex/helpers/utils.hpp>
+#include <hex/helpers/search.hpp>
+
+#include <algorithm>
 
 using namespace std::literals::string_literals;
+using namespace hex::literals;
 
 TEST_SEQUENCE("ExtractBits") {
     TEST_ASSERT(hex::extract(11, 4, 0xAABBU) == 0xAB);
@@ -12,3 +18,100 @@ TEST_SEQUENCE("ExtractBits") {
 
     TEST_SUCCESS();
 };
+
+TEST_SEQUENCE("SearchByteSequence") {
+    std::vector<u8> data(9_MiB);
+    for (size_t i = 0; i < data.size(); i += 1)
+        data[i] = u8(i * 7 + (i >> 8));
+
+    const std::vector<u8> sequence = { 'I', 'm', 'H', 'e', 'x', 0x00, 0xFF, 0x13, 0x37 };
+    const std::vector<u64> positions = { 0x00, 0x1234, 4_MiB - 4, 8_MiB - 1, data.size() - sequence.size() };
+    for (auto position : positions)
+        std::ranges::copy(sequence, data.begin() + position);
+
+    hex::test::TestProvider provider(&data);
+    hex::Task task;
+    const hex::Region region = { .address=0x00, .size=data.size() };
+
+    hex::ByteSequenceSearcher searcher(sequence);
+
+    std::vector<u64> found;
+    searcher.findAll(task, &provider, region, [&](u64 address) { found.push_back(address); });
+    TEST_ASSERT(found == positions);
+
+    for (u64 i = 0; i < positions.size(); i += 1) {
+        const auto address = i == 0 ? 0x00 : positions[i - 1] + 1;
+        TEST_ASSERT(searcher.findNext(task, &provider, region, address) == positions[i], "at index {}", i);
+    }
+
+    for (u64 i = 0; i < positions.size(); i += 1) {
+        const auto endAddress = positions[positions.size() - 1 - i] + sequence.size() - 1;
+        TEST_ASSERT(searcher.findPrevious(task, &provider, region, endAddress) == positions[positions.size() - 1 - i], "at index {}", i);
+    }
+
+    TEST_ASSERT(!searcher.findNext(task, &provider, region, positions.back() + 1).has_value());
+    TEST_ASSERT(!searcher.findPrevious(task, &provider, region, positions.front() + sequence.size() - 2).has_value());
+
+    // Letters match regardless of their case, everything else has to match exactly
+    const std::vector<u8> text = { 'a', 'B', '@', 'i', 'M', 'h', 'E', 'x', '`', 'I', 'm', 'H', 'e', 'X' };
+    const hex::ByteSequenceSearcher caseInsensitive(std::vector<u8>{ 'I', 'M', 'H', 'E', 'X' }, true);
+    const hex::ByteSequenceSearcher caseSensitive(std::vector<u8>{ 'I', 'M', 'H', 'E', 'X' }, false);
+    const hex::ByteSequenceSearcher symbols(std::vector<u8>{ 'b', '`' }, true);
+
+    TEST_ASSERT(caseInsensitive.findFirst(text) == 3);
+    TEST_ASSERT(caseInsensitive.findLast(text) == 9);
+    TEST_ASSERT(!caseSensitive.findFirst(text).has_value());
+    TEST_ASSERT(!symbols.findFirst(text).has_value());
+
+    // An empty sequence matches everywhere but is never reported when searching a region
+    const hex::ByteSequenceSearcher empty(std::vector<u8>{});
+    TEST_ASSERT(empty.findFirst(text) == 0);
+    TEST_ASSERT(empty.findLast(text) == text.size());
+
+    found.clear();
+    empty.findAll(task, &provider, region, [&](u64 address) { found.push_back(address); });
+    TEST_ASSERT(found.empty());
+
+    TEST_SUCCESS();
+};
+
+TEST_SEQUENCE("SearchBinaryPattern") {
+    std::vector<u8> data(9_MiB);
+    for (size_t i = 0; i < data.size(); i += 1)
+        data[i] = u8(i * 7 + (i >> 8));
+
+    const std::vector<u64> positions = { 0x00, 0x1234, 4_MiB - 3, 8_MiB - 1, data.size() - 7 };
+    for (auto position : positions) {
+        data[position + 0] = 0xE8;
+        data[position + 5] = 0x48;
+        data[position + 6] = 0x8B;
+    }
+
+    hex::test::TestProvider provider(&data);
+    hex::Task task;
+    const hex::Region region = { .address=0x00, .size=data.size() };
+
+    const hex::BinaryPatternSearcher searcher(hex::BinaryPattern("E8 ?? ?? ?? ?? 48 8B"));
+
+    std::vector<u64> expected;
+    for (u64 address = 0; address + 7 <= data.size(); address += 1) {
+        if (data[address] == 0xE8 && data[address + 5] == 0x48 && data[address + 6] == 0x8B)
+            expected.push_back(address);
+    }
+
+    std::vector<u64> found;
+    searcher.findAll(task, &provider, region, [&](u64 address) { found.push_back(address); });
+    TEST_ASSERT(found == expected);
+    TEST_ASSERT(std::ranges::includes(found, positions));
+
+    // Nibble wildcards only ignore half of their byte
+    const std::vector<u8> bytes = { 0x12, 0x34, 0x56, 0x1F, 0x3F, 0x66 };
+    const hex::BinaryPatternSearcher nibbles(hex::BinaryPattern("1? 3? 6?"));
+    const hex::BinaryPatternSearcher mixed(hex::BinaryPattern("?2 ?? 5?"));
+
+    TEST_ASSERT(nibbles.findFirst(bytes) == 3);
+    TEST_ASSERT(mixed.findFirst(bytes) == 0);
+    TEST_ASSERT(!mixed.findFirst(std::span(bytes).subspan(1)).has_value());
+
+    TEST_SUCCESS();
+};